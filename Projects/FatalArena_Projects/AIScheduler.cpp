@@ -0,0 +1,114 @@
+﻿#include "AIScheduler.h"
+#include "EnemyBase.h"
+#include "EntityRegistry.h"
+#include "Components.h"
+#include <algorithm>
+#include <cassert>
+
+#include <DxLib.h>
+
+namespace {
+	// この間隔(フレーム)以上思考していない敵は予算に関係なく思考させる
+	constexpr int kMaxThinkInterval = 10;
+
+	// プレイヤーの近くにいる敵の優先度の倍率
+	constexpr float kNearDist = 1500.0f;
+	constexpr float kNearDistSq = kNearDist * kNearDist;
+	constexpr float kNearPriorityMul = 4.0f;
+
+	// 思考間隔の平均を求める際の直近の値の重み
+	constexpr float kLatencySmoothing = 0.05f;
+}
+
+AIScheduler::AIScheduler(long long budgetUs) :
+	_budgetUs(budgetUs),
+	_fixedThinkCount(0),
+	_candidates(),
+	_metrics()
+{
+	assert(budgetUs > 0 && "予算が正しくない");
+}
+
+AIScheduler::~AIScheduler()
+{
+}
+
+void AIScheduler::Update(const Position3& playerPos)
+{
+	const LONGLONG startTime = GetNowHiPerformanceCount();
+
+	_metrics.thinkCount = 0;
+	_metrics.forcedThinkCount = 0;
+	_metrics.skippedCount = 0;
+	_candidates.clear();
+
+	// 思考の状態の列を先頭から順に処理する
+	// (列の途中で敵が追加・削除されることはないため、添字を候補として保持できる)
+	auto& aiStates = EntityRegistry::GetInstance().GetPool<AIStateComponent>().Components();
+	for (int i = 0; i < static_cast<int>(aiStates.size()); ++i) {
+		AIStateComponent& aiState = aiStates[i];
+		// 死亡後は待ち時間を進めず、思考もしない
+		if (!aiState.isThinking) continue;
+		++aiState.thinkWaitFrame;
+
+		const EnemyBase& enemy = *aiState.owner;
+		// アニメーションの終了など、すぐに判断が必要なものは必ず思考させる
+		// 長く待たせすぎているものも同様
+		if (enemy.IsThinkRequired() || aiState.thinkWaitFrame >= kMaxThinkInterval) {
+			Think(aiState);
+			++_metrics.forcedThinkCount;
+			continue;
+		}
+
+		// 出現中は出現が終わるまで判断することがない
+		if (enemy.GetState() != EnemyBase::State::Active) continue;
+
+		// 待たせている時間が長いほど、プレイヤーに近いほど優先する
+		float priority = static_cast<float>(aiState.thinkWaitFrame);
+		if ((enemy.GetPos() - playerPos).SqrMagnitude() <= kNearDistSq) {
+			priority *= kNearPriorityMul;
+		}
+		_candidates.emplace_back(priority, i);
+	}
+
+	// 優先度の高い順に、予算が残っている間だけ思考させる
+	// (同じ優先度であれば列の順にし、結果が並べ替えの実装に左右されないようにする)
+	std::sort(_candidates.begin(), _candidates.end(),
+		[](const std::pair<float, int>& a, const std::pair<float, int>& b) {
+			if (a.first != b.first) return a.first > b.first;
+			return a.second < b.second;
+		});
+	int budgetThinkCount = 0;
+	for (const auto& candidate : _candidates) {
+		const bool isOverBudget = (_fixedThinkCount > 0) ?
+			(budgetThinkCount >= _fixedThinkCount) :
+			(GetNowHiPerformanceCount() - startTime >= _budgetUs);
+		if (isOverBudget) {
+			++_metrics.skippedCount;
+			continue;
+		}
+		Think(aiStates[candidate.second]);
+		++budgetThinkCount;
+	}
+
+	_metrics.lastFrameUs = GetNowHiPerformanceCount() - startTime;
+	if (_metrics.lastFrameUs > _budgetUs) {
+		++_metrics.overrunFrameCount;
+	}
+}
+
+void AIScheduler::ResetMetrics()
+{
+	_metrics = Metrics();
+}
+
+void AIScheduler::Think(AIStateComponent& aiState)
+{
+	const int latency = aiState.thinkWaitFrame;
+	aiState.owner->Think();
+	aiState.thinkWaitFrame = 0;
+
+	++_metrics.thinkCount;
+	_metrics.maxLatency = std::max<int>(_metrics.maxLatency, latency);
+	_metrics.averageLatency += (static_cast<float>(latency) - _metrics.averageLatency) * kLatencySmoothing;
+}
@@ -0,0 +1,75 @@
+﻿#pragma once
+#include "Vector3.h"
+#include <vector>
+#include <utility>
+
+struct AIStateComponent;
+
+/// <summary>
+/// 敵の思考(状態遷移の判断)を1フレームあたりの時間予算内で
+/// 複数フレームに分散して行う
+/// 移動やアニメーションの更新は毎フレーム各敵が行う
+/// </summary>
+class AIScheduler final
+{
+public:
+	// 計測結果
+	struct Metrics
+	{
+		int thinkCount = 0;				// 直近フレームで思考した数
+		int forcedThinkCount = 0;		// 直近フレームで予算に関係なく思考した数
+		int skippedCount = 0;			// 直近フレームで予算切れにより見送った数
+		long long lastFrameUs = 0;		// 直近フレームの思考にかかった時間(マイクロ秒)
+		int overrunFrameCount = 0;		// 予算を超えたフレームの累計
+		float averageLatency = 0.0f;	// 思考間隔の平均(フレーム)
+		int maxLatency = 0;				// 思考間隔の最大(フレーム)
+	};
+
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="budgetUs">1フレームに思考へ使える時間(マイクロ秒)</param>
+	AIScheduler(long long budgetUs);
+	~AIScheduler();
+
+	/// <summary>
+	/// 予算内で思考させる敵を選び、思考させる
+	/// 対象はEntityRegistryのAIStateComponentを持つ全ての敵
+	/// 各敵のUpdateより前に呼ぶ
+	/// </summary>
+	/// <param name="playerPos">優先度の判定に使用するプレイヤー位置</param>
+	void Update(const Position3& playerPos);
+
+	/// <summary>
+	/// 計測結果を返す
+	/// </summary>
+	const Metrics& GetMetrics() const { return _metrics; }
+
+	/// <summary>
+	/// 累計の計測結果をリセットする
+	/// </summary>
+	void ResetMetrics();
+
+	/// <summary>
+	/// 時間ではなく人数で1フレームに思考させる数を制限する
+	/// 計測時間によって結果が変わらないよう、リプレイの記録・再生時に使う
+	/// </summary>
+	/// <param name="count">1フレームに思考させる数(0以下なら時間で制限する)</param>
+	void SetFixedThinkCount(int count) { _fixedThinkCount = count; }
+
+private:
+	/// <summary>
+	/// 思考させて計測結果に反映する
+	/// </summary>
+	void Think(AIStateComponent& aiState);
+
+	long long _budgetUs;
+	// 0より大きければ時間の代わりにこの数で制限する
+	int _fixedThinkCount;
+
+	// 思考の候補(優先度, AIStateComponentの列の添字)
+	// (毎フレームの確保を避けるため保持する)
+	std::vector<std::pair<float, int>> _candidates;
+
+	Metrics _metrics;
+};
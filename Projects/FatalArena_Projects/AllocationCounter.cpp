@@ -0,0 +1,128 @@
+﻿#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+namespace {
+	std::atomic<uint64_t> sAllocationCount = 0;
+
+	// 定常状態のフレームの記録(メインスレッドからのみ触る)
+	uint64_t sSteadyFrameCount = 0;
+	uint64_t sAllocatingFrameCount = 0;
+	uint64_t sSteadyAllocationCount = 0;
+
+	void* CountedAllocate(size_t size)
+	{
+		sAllocationCount.fetch_add(1, std::memory_order_relaxed);
+		// 0バイトでも有効なポインタを返す必要がある
+		void* ptr = std::malloc(size > 0 ? size : 1);
+		if (ptr == nullptr) {
+			throw std::bad_alloc();
+		}
+		return ptr;
+	}
+
+	/// <summary>
+	/// alignasで通常より大きな境界を指定された型の確保
+	/// (_aligned_mallocで確保したものは_aligned_freeで解放する必要がある)
+	/// </summary>
+	void* CountedAlignedAllocate(size_t size, std::align_val_t alignment)
+	{
+		sAllocationCount.fetch_add(1, std::memory_order_relaxed);
+		void* ptr = _aligned_malloc(size > 0 ? size : 1, static_cast<size_t>(alignment));
+		if (ptr == nullptr) {
+			throw std::bad_alloc();
+		}
+		return ptr;
+	}
+}
+
+uint64_t AllocationCounter::GetCount()
+{
+	return sAllocationCount.load(std::memory_order_relaxed);
+}
+
+void AllocationCounter::RecordSteadyFrame(uint64_t allocationCount)
+{
+	++sSteadyFrameCount;
+	if (allocationCount > 0) {
+		++sAllocatingFrameCount;
+		sSteadyAllocationCount += allocationCount;
+	}
+}
+
+uint64_t AllocationCounter::GetSteadyFrameCount()
+{
+	return sSteadyFrameCount;
+}
+
+uint64_t AllocationCounter::GetAllocatingFrameCount()
+{
+	return sAllocatingFrameCount;
+}
+
+uint64_t AllocationCounter::GetSteadyAllocationCount()
+{
+	return sSteadyAllocationCount;
+}
+
+// 全体のoperator newを置き換えて確保の回数を数える
+// 置き換えなかった版は標準ライブラリの実装のまま確保され、数えられない上に
+// 置き換えたdeleteと組み合わさると解放の方法が食い違うため、全ての版をそろえて置き換える
+void* operator new(size_t size) { return CountedAllocate(size); }
+void* operator new[](size_t size) { return CountedAllocate(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+// 失敗時に例外を投げずnullptrを返す版
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	try {
+		return CountedAllocate(size);
+	}
+	catch (const std::bad_alloc&) {
+		return nullptr;
+	}
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	try {
+		return CountedAllocate(size);
+	}
+	catch (const std::bad_alloc&) {
+		return nullptr;
+	}
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+// 境界を指定する版(alignasで16バイトより大きな境界を指定した型で使われる)
+void* operator new(size_t size, std::align_val_t alignment) { return CountedAlignedAllocate(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return CountedAlignedAllocate(size, alignment); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	try {
+		return CountedAlignedAllocate(size, alignment);
+	}
+	catch (const std::bad_alloc&) {
+		return nullptr;
+	}
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	try {
+		return CountedAlignedAllocate(size, alignment);
+	}
+	catch (const std::bad_alloc&) {
+		return nullptr;
+	}
+}
+void operator delete(void* ptr, std::align_val_t) noexcept { _aligned_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { _aligned_free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { _aligned_free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { _aligned_free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { _aligned_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { _aligned_free(ptr); }
@@ -0,0 +1,35 @@
+﻿#pragma once
+#include <cstdint>
+
+/// <summary>
+/// ヒープ確保(operator new)の回数を数える
+/// 定常状態のフレームで確保が発生していないかを確認するために使用する
+/// </summary>
+namespace AllocationCounter
+{
+	/// <summary>
+	/// 起動してからのヒープ確保の回数を返す
+	/// 区間の前後で差を取って使う
+	/// </summary>
+	uint64_t GetCount();
+
+	/// <summary>
+	/// 定常状態の1フレームで発生した確保の回数を記録する
+	/// </summary>
+	void RecordSteadyFrame(uint64_t allocationCount);
+
+	/// <summary>
+	/// 記録した定常状態のフレーム数を返す
+	/// </summary>
+	uint64_t GetSteadyFrameCount();
+
+	/// <summary>
+	/// 記録した定常状態のフレームのうち、確保が発生したフレーム数を返す
+	/// </summary>
+	uint64_t GetAllocatingFrameCount();
+
+	/// <summary>
+	/// 記録した定常状態のフレームでの確保の合計回数を返す
+	/// </summary>
+	uint64_t GetSteadyAllocationCount();
+}
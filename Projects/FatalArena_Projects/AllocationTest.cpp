@@ -0,0 +1,170 @@
+﻿#include "SelfTest.h"
+#include "AllocationCounter.h"
+#include "JobSystem.h"
+#include "RenderQueue.h"
+#include "RenderSnapshot.h"
+#include "RecordingRenderBackend.h"
+#include "EnemyCommandBuffer.h"
+#include "SpatialGrid.h"
+#include "ViewFrustum.h"
+#include "SoundManager.h"
+#include <cstdio>
+#include <new>
+#include <vector>
+
+namespace {
+	// ウェーブ中を想定した、1フレームに扱う数
+	constexpr int kModelNum = 200;
+	constexpr int kEnemyNum = 100;
+	// 並列更新で1つの作業としてまとめる数(EnemyManagerと同じ)
+	constexpr int kChunkSize = 8;
+	constexpr int kChunkNum = (kEnemyNum + kChunkSize - 1) / kChunkSize;
+
+	// 敵の位置が一巡するフレーム数
+	constexpr int kMovePatternNum = 10;
+	// 確保済みの領域が行き渡るまで回すフレーム数と、確保を数えるフレーム数
+	// (全ての位置を一巡させ、3つを順に使うスナップショットも全て使っておく)
+	constexpr int kWarmUpFrameNum = kMovePatternNum;
+	constexpr int kMeasureFrameNum = 60;
+
+	// 確認に使うグリッドと視錐台
+	constexpr float kHalfExtent = 3000.0f;
+	constexpr float kCellSize = 400.0f;
+	constexpr float kQueryRadius = 500.0f;
+	constexpr float kFovY = 3.14159265f / 3.0f;
+	constexpr float kAspect = 16.0f / 9.0f;
+	constexpr float kNear = 1.0f;
+	constexpr float kFar = 5000.0f;
+
+	// 確認に使う複製元のモデルと画像
+	constexpr int kSourceNum = 4;
+	constexpr int kImpostorGraph = 1000;
+
+	// 確認に使う確保の大きさと、16バイトより大きな境界
+	constexpr size_t kTestAllocationSize = 64;
+	constexpr std::align_val_t kTestAlignment = std::align_val_t(64);
+
+	/// <summary>
+	/// 定常状態の1フレームで使う、確保済みの領域を持ち回るもの
+	/// </summary>
+	struct SteadyFrame
+	{
+		RenderSnapshotBuffer snapshots;
+		RenderQueue queue;
+		RecordingRenderBackend backend;
+		ViewFrustum frustum;
+		SpatialGrid grid{ kHalfExtent, kCellSize };
+		std::vector<EnemyCommandBuffer> commandBuffers = std::vector<EnemyCommandBuffer>(kChunkNum);
+		std::vector<Position3> positions = std::vector<Position3>(kEnemyNum);
+		std::vector<int> neighbors;
+		int customCount = 0;
+	};
+
+	/// <summary>
+	/// Applicationの1フレームと同じ順に、各機能を1回ずつ使う
+	/// </summary>
+	void RunFrame(SteadyFrame& frame, int frameIndex)
+	{
+		// 敵の位置を動かし、空間インデックスを更新して近傍を探す
+		const float offset = static_cast<float>(frameIndex % kMovePatternNum) * 30.0f;
+		for (int i = 0; i < kEnemyNum; ++i) {
+			frame.positions[i] = Position3(static_cast<float>(i % 10) * 200.0f - 1000.0f + offset, 0.0f,
+				static_cast<float>(i / 10) * 200.0f - 1000.0f);
+			frame.grid.Update(i, frame.positions[i]);
+		}
+		frame.grid.QueryRadius(frame.positions[0], kQueryRadius, frame.neighbors);
+
+		// 塊ごとに並列に更新し、副作用を記録する
+		// (Executeは効果音などDxLibに触れるため、ここでは記録と消去のみ確かめる)
+		JobSystem::GetInstance().ParallelFor(kEnemyNum, kChunkSize,
+			[&frame](int begin, int end) {
+				EnemyCommandBuffer& commands = frame.commandBuffers[begin / kChunkSize];
+				for (int i = begin; i < end; ++i) {
+					commands.PlaySound(SEType::SpawnEnemy);
+				}
+			});
+		for (auto& commands : frame.commandBuffers) {
+			commands.Clear();
+		}
+
+		// スナップショットを書き込んで公開し、描画側で受け取って視界外を除く
+		RenderSnapshot& snapshot = frame.snapshots.BeginWrite();
+		snapshot.Clear();
+		for (int i = 0; i < kModelNum; ++i) {
+			const Position3 pos(static_cast<float>(i % 20) * 100.0f - 1000.0f + offset, 0.0f,
+				static_cast<float>(i / 20) * 100.0f + 100.0f);
+			if (i % 5 == 0) {
+				snapshot.AddImpostor(kImpostorGraph, pos, 100.0f, 200.0f, { pos, 100.0f });
+			}
+			else {
+				snapshot.AddModel(i, pos, { pos, 100.0f }, i % kSourceNum);
+			}
+		}
+		frame.snapshots.Publish();
+		frame.snapshots.AcquireRead();
+		frame.frustum.Setup(Position3(0.0f, 0.0f, 0.0f), Position3(0.0f, 0.0f, 1.0f),
+			kFovY, kAspect, kNear, kFar);
+		frame.snapshots.CullRead(frame.frustum);
+
+		// 描画キューを組んで並べ替え、実行する
+		frame.queue.Clear();
+		frame.queue.SubmitCustom(RenderLayer::Background, false, [&frame]() { ++frame.customCount; });
+		frame.queue.SubmitModels(frame.snapshots.GetRead(), Position3(0.0f, 0.0f, 0.0f));
+		frame.queue.SubmitCustom(RenderLayer::UI, false, [&frame]() { ++frame.customCount; });
+		frame.queue.Sort();
+		frame.queue.Execute(frame.backend);
+	}
+}
+
+void SelfTest::RunAllocationTests()
+{
+	PrintHeader("AllocationCounter");
+
+	// 置き換えた全ての版のoperator newが数えられる
+	// (new式は最適化で確保ごと省かれうるため、関数を直接呼ぶ)
+	{
+		const uint64_t before = AllocationCounter::GetCount();
+		::operator delete(::operator new(kTestAllocationSize));
+		::operator delete[](::operator new[](kTestAllocationSize));
+		::operator delete(::operator new(kTestAllocationSize, std::nothrow), std::nothrow);
+		::operator delete[](::operator new[](kTestAllocationSize, std::nothrow), std::nothrow);
+		Check(AllocationCounter::GetCount() - before == 4, "plain and nothrow operator new are counted");
+	}
+	{
+		const uint64_t before = AllocationCounter::GetCount();
+		void* block = ::operator new(kTestAllocationSize, kTestAlignment);
+		const bool isAligned = (reinterpret_cast<uintptr_t>(block) % static_cast<size_t>(kTestAlignment) == 0);
+		::operator delete(block, kTestAlignment);
+		::operator delete[](::operator new[](kTestAllocationSize, kTestAlignment), kTestAlignment);
+		::operator delete(::operator new(kTestAllocationSize, kTestAlignment, std::nothrow),
+			kTestAlignment, std::nothrow);
+		::operator delete[](::operator new[](kTestAllocationSize, kTestAlignment, std::nothrow),
+			kTestAlignment, std::nothrow);
+		Check(AllocationCounter::GetCount() - before == 4, "aligned operator new is counted");
+		Check(isAligned, "aligned operator new honours the requested alignment");
+	}
+
+	// 準備のフレームで領域が行き渡った後は、フレームを繰り返しても確保が起きない
+	JobSystem& jobSystem = JobSystem::GetInstance();
+	jobSystem.Init();
+	{
+		SteadyFrame frame;
+		frame.backend.SetExecuteCustom(true);
+		for (int i = 0; i < kWarmUpFrameNum; ++i) {
+			RunFrame(frame, i);
+		}
+
+		const uint64_t before = AllocationCounter::GetCount();
+		for (int i = 0; i < kMeasureFrameNum; ++i) {
+			RunFrame(frame, kWarmUpFrameNum + i);
+		}
+		const uint64_t allocationNum = AllocationCounter::GetCount() - before;
+
+		printf("  %d steady frames : %llu allocations\n", kMeasureFrameNum,
+			static_cast<unsigned long long>(allocationNum));
+		Check(allocationNum == 0, "steady-state frames do not allocate after warm-up");
+		Check(frame.customCount == (kWarmUpFrameNum + kMeasureFrameNum) * 2,
+			"every frame ran its custom draws");
+	}
+	jobSystem.Terminate();
+}
@@ -2,12 +2,15 @@
 
 #include <DxLib.h>
 #include <cassert>
+#include <algorithm>
 
 namespace {
 	// アニメーションのブレンド時間(frame)
 	constexpr float kAnimBlendFrame = 15.0f;
 	// 全てにかかるアニメーションの再生速度(60fなら1.0、30fなら0.5が等速)
 	constexpr float kAnimSpeed = 1.3f;
+	// 最初から再生する際のイベント判定開始位置(0フレームのイベントを含めるため)
+	constexpr float kRestartEventFrame = -1.0f;
 }
 
 Animator::Animator() :
@@ -15,7 +18,13 @@ Animator::Animator() :
 	_animDataList(),
 	_currentAnimName(L""),
 	_prevAnimName(L""),
-	_blendRate(1.0f) // 最初はブレンドしていないので1.0
+	_blendRate(1.0f), // 最初はブレンドしていないので1.0
+	_applyInterval(1),
+	_applyPhase(0),
+	_updateCount(0),
+	_isApplyFrame(true),
+	_pendingDetachNos(),
+	_eventHandler()
 {
 }
 
@@ -32,12 +41,55 @@ void Animator::Init(int model)
 
 void Animator::Update()
 {
+	Advance();
+	ApplyToModel();
+}
+
+void Animator::Advance()
+{
+	// 今回の更新でモデルへ反映するかを決める
+	// 間引いたフレームの分も再生時間は進めているので、反映時に正しい時間になる
+	++_updateCount;
+	_isApplyFrame = ((_updateCount + _applyPhase) % _applyInterval == 0);
+
 	// ブレンド処理が進行中か、
 	// そうでなければ現在のアニメーションを更新
 	UpdateAnimBlendRate();
 }
 
-void Animator::SetStartAnim(const std::wstring animName)
+void Animator::ApplyToModel()
+{
+	// ブレンドが完了したアニメーションを外す
+	for (int attachNo : _pendingDetachNos) {
+		MV1DetachAnim(_model, attachNo);
+	}
+	_pendingDetachNos.clear();
+
+	// LODで間引かれている場合はモデルへ反映しない
+	// (次に反映するフレームでまとめて適用される)
+	if (!_isApplyFrame) return;
+
+	// 再生時間とブレンド率を適用
+	if (!_currentAnimName.empty()) {
+		const AnimData& currentAnim = FindAnimData(_currentAnimName);
+		if (currentAnim.attachNo != -1) {
+			MV1SetAttachAnimTime(_model, currentAnim.attachNo, currentAnim.frame);
+			MV1SetAttachAnimBlendRate(_model, currentAnim.attachNo, _blendRate);
+		}
+	}
+	if (!_prevAnimName.empty()) {
+		MV1SetAttachAnimBlendRate(_model, FindAnimData(_prevAnimName).attachNo, 1.0f - _blendRate);
+	}
+}
+
+void Animator::SetApplyInterval(int interval, int phase)
+{
+	assert(interval > 0 && "反映間隔が正しくない");
+	_applyInterval = interval;
+	_applyPhase = phase;
+}
+
+void Animator::SetStartAnim(const std::wstring& animName)
 {
 	// 最初のアニメーションを現在のものとして設定
 	_currentAnimName = animName;
@@ -52,7 +104,7 @@ void Animator::SetStartAnim(const std::wstring animName)
 		_blendRate);
 }
 
-void Animator::SetAnimData(const std::wstring animName, const float animSpeed, const bool isLoop, float inputAcceptanceStartRatio, float inputAcceptanceEndRatio)
+void Animator::SetAnimData(const std::wstring& animName, const float animSpeed, const bool isLoop)
 {
 	// すでに同じアニメーションが登録されていないか確認
 	for (const auto& anim : _animDataList) {
@@ -71,13 +123,28 @@ void Animator::SetAnimData(const std::wstring animName, const float animSpeed, c
 	animData.totalFrame = MV1GetAnimTotalTime(_model, animData.animIndex);
 	animData.isLoop = isLoop;
 	animData.isEnd = false;
-	// 比率をフレーム値に変換
-	animData.inputAcceptanceStartFrame = animData.totalFrame * inputAcceptanceStartRatio;
-	animData.inputAcceptanceEndFrame = animData.totalFrame * inputAcceptanceEndRatio;
 	_animDataList.emplace_front(animData);
 }
 
-void Animator::AttachAnim(const std::wstring animName, const bool isLoop)
+void Animator::AddAnimEvent(const std::wstring& animName, float ratio, EventType type, int param)
+{
+	assert(ratio >= 0.0f && ratio <= 1.0f && "イベントのタイミングが範囲外");
+	AnimData& animData = FindAnimData(animName);
+
+	// 比率をフレーム値に変換
+	AnimEvent animEvent;
+	animEvent.frame = animData.totalFrame * ratio;
+	animEvent.type = type;
+	animEvent.param = param;
+
+	// frameの昇順を保つ位置に挿入する
+	// (同じframeのものは登録順に発行する)
+	auto it = std::upper_bound(animData.events.begin(), animData.events.end(), animEvent.frame,
+		[](float frame, const AnimEvent& e) { return frame < e.frame; });
+	animData.events.insert(it, animEvent);
+}
+
+void Animator::AttachAnim(const std::wstring& animName, const bool isLoop)
 {
 	// アニメーション名が空なら何もしない
 	if (animName.empty()) return;
@@ -93,26 +160,42 @@ void Animator::AttachAnim(const std::wstring animName, const bool isLoop)
 	animData.frame = 0.0f;
 	animData.isLoop = isLoop;
 	animData.isEnd = false;
+	animData.isRestart = true;
 	// 再生時間をリセット
 	MV1SetAttachAnimTime(_model, animData.attachNo, 0.0f);
 }
 
+void Animator::RestartAnim(const std::wstring& animName)
+{
+	AnimData& animData = FindAnimData(animName);
+	animData.frame = 0.0f;
+	animData.isEnd = false;
+	animData.isRestart = true;
+}
+
 void Animator::UpdateAnim(AnimData& data)
 {
 	// アニメーションがアタッチされていない場合return
 	if (data.attachNo == -1) return;
+	// イベント判定用に進める前の再生位置を保持
+	// (最初から再生し直した場合は0フレームのイベントも含める)
+	const float prevFrame = data.isRestart ? kRestartEventFrame : data.frame;
+	data.isRestart = false;
 	// アニメーションを進める
 	data.frame += data.animSpeed;
 	// 現在再生中のアニメーションの総時間を取得する
 	const float totalTime = data.totalFrame;
+	// ループした回数
+	int loopCount = 0;
 	
 	// アニメーションの設定によってループさせるか最後のフレームで止めるかを判定
 	if (data.isLoop)
 	{
 		// アニメーションをループさせる
-		while (data.frame > totalTime)
+		while (data.frame > totalTime && totalTime > 0.0f)
 		{
 			data.frame -= totalTime;
+			++loopCount;
 		}
 	}
 	else
@@ -125,8 +208,27 @@ void Animator::UpdateAnim(AnimData& data)
 		}
 	}
 
-	// 進行させたアニメーションをモデルに適用する
-	MV1SetAttachAnimTime(_model, data.attachNo, data.frame);
+	// 通過したイベントを発行する
+	FireEvents(data, prevFrame, data.frame, loopCount);
+}
+
+void Animator::FireEvents(const AnimData& data, float from, float to, int loopCount)
+{
+	if (!_eventHandler || data.events.empty()) return;
+
+	// ループ分を展開した再生位置で考え、
+	// from < (イベント位置 + ループ数 * 総時間) <= to となるものを順に発行する
+	// (大きく進めた場合や複数回ループした場合も取りこぼさない)
+	const float totalTime = data.totalFrame;
+	for (int loop = 0; loop <= loopCount; ++loop) {
+		const float lower = from - totalTime * loop;
+		const float upper = to + totalTime * (loopCount - loop);
+		for (const auto& animEvent : data.events) {
+			if (animEvent.frame <= lower) continue;
+			if (animEvent.frame > upper) break;
+			_eventHandler(animEvent);
+		}
+	}
 }
 
 void Animator::UpdateAnimBlendRate()
@@ -148,11 +250,15 @@ void Animator::UpdateAnimBlendRate()
 		if (_blendRate >= 1.0f) {
 			_blendRate = 1.0f;
 
-			// 古いアニメーションは完全に不要になったのでデタッチ
+			// 古いアニメーションを外すので、ブレンド率は必ず反映する
+			_isApplyFrame = true;
+
+			// 古いアニメーションは完全に不要になったのでデタッチする
+			// (モデルからのデタッチはApplyToModelで行う)
 			if (!_prevAnimName.empty()) {
 				AnimData& prevAnim = FindAnimData(_prevAnimName);
 				if (prevAnim.attachNo != -1) {
-					MV1DetachAnim(_model, prevAnim.attachNo);
+					_pendingDetachNos.emplace_back(prevAnim.attachNo);
 					prevAnim.attachNo = -1;
 				}
 				// 前のアニメーション名をクリアしてブレンド処理を終了
@@ -160,17 +266,9 @@ void Animator::UpdateAnimBlendRate()
 			}
 		}
 	}
-
-	// モデルにブレンド率を適用
-	if (!_currentAnimName.empty()) {
-		MV1SetAttachAnimBlendRate(_model, FindAnimData(_currentAnimName).attachNo, _blendRate);
-	}
-	if (!_prevAnimName.empty()) {
-		MV1SetAttachAnimBlendRate(_model, FindAnimData(_prevAnimName).attachNo, 1.0f - _blendRate);
-	}
 }
 
-void Animator::ChangeAnim(const std::wstring animName, bool isLoop)
+void Animator::ChangeAnim(const std::wstring& animName, bool isLoop)
 {
 	// 既に再生中、または遷移しようとしているアニメーションならreturn
 	if (animName == _currentAnimName) return;
@@ -193,11 +291,50 @@ void Animator::ChangeAnim(const std::wstring animName, bool isLoop)
 	AttachAnim(_currentAnimName, isLoop);
 	_blendRate = 0.0f;
 
+	// アニメーションが切り替わったフレームはLODに関係なく反映する
+	_isApplyFrame = true;
+
 	// アタッチしたばかりのアニメーションに少しだけ影響力を持たせる
 	UpdateAnimBlendRate();
+	ApplyToModel();
+}
+
+void Animator::RestoreAnim(const std::wstring& animName, float frame)
+{
+	// ブレンド中のアニメーションは不要になるのでデタッチ
+	if (!_prevAnimName.empty()) {
+		AnimData& prevAnim = FindAnimData(_prevAnimName);
+		if (prevAnim.attachNo != -1) {
+			MV1DetachAnim(_model, prevAnim.attachNo);
+			prevAnim.attachNo = -1;
+		}
+		_prevAnimName.clear();
+	}
+	// 別のアニメーションを再生中であれば付け替える
+	if (animName != _currentAnimName) {
+		if (!_currentAnimName.empty()) {
+			AnimData& currentAnim = FindAnimData(_currentAnimName);
+			if (currentAnim.attachNo != -1) {
+				MV1DetachAnim(_model, currentAnim.attachNo);
+				currentAnim.attachNo = -1;
+			}
+		}
+		_currentAnimName = animName;
+		AttachAnim(_currentAnimName, FindAnimData(_currentAnimName).isLoop);
+	}
+
+	AnimData& data = FindAnimData(_currentAnimName);
+	data.frame = frame;
+	data.isEnd = (!data.isLoop && frame >= data.totalFrame);
+	// 復元した位置より前のイベントは発行しない
+	data.isRestart = false;
+
+	_blendRate = 1.0f;
+	_isApplyFrame = true;
+	ApplyToModel();
 }
 
-Animator::AnimData& Animator::FindAnimData(const std::wstring animName)
+Animator::AnimData& Animator::FindAnimData(const std::wstring& animName)
 {
 	// アニメーション名が空の場合はリストの先頭をダミーとして返す
 	if (animName.empty()) {
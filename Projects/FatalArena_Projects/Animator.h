@@ -1,11 +1,39 @@
 ﻿#pragma once
 
 #include <string>
+#include <vector>
 #include <forward_list>
+#include <functional>
 
 class Animator
 {
 public:
+	/// <summary>
+	/// アニメーションイベントの種類
+	/// </summary>
+	enum class EventType
+	{
+		HitboxOn,			// 攻撃判定を有効にする
+		HitboxOff,			// 攻撃判定を無効にする
+		SoundCue,			// 効果音を鳴らす(paramにSETypeを入れる)
+		InputWindowOpen,	// 入力受付を開始する
+		InputWindowClose,	// 入力受付を終了する
+	};
+
+	/// <summary>
+	/// アニメーションイベント
+	/// 再生位置がframeを通過したときに発行される
+	/// </summary>
+	struct AnimEvent
+	{
+		float frame = 0.0f;						// 発行するフレーム
+		EventType type = EventType::HitboxOn;	// 種類
+		int param = 0;							// 種類ごとの追加情報
+	};
+
+	// イベントを受け取る関数
+	using EventHandler_t = std::function<void(const AnimEvent&)>;
+
 	/// <summary>
 	/// アニメーションデータ構造体
 	/// </summary>
@@ -19,9 +47,9 @@ public:
 		float totalFrame = 0.0f;	// アニメーションの総再生時間
 		bool  isLoop = false;		// ループするか
 		bool  isEnd = false;		// ループしない場合終了しているか
+		bool  isRestart = false;	// 最初から再生し直したか(0フレームのイベントも発行する)
 
-		float inputAcceptanceStartFrame = 0.0f; // 入力受付開始フレーム
-		float inputAcceptanceEndFrame = 0.0f;   // 入力受付終了フレーム
+		std::vector<AnimEvent> events;	// イベント(frameの昇順)
 	};
 
 	Animator();
@@ -30,33 +58,71 @@ public:
 	void Init(int model);
 	void Update();
 
+	/// <summary>
+	/// 再生時間とブレンド率を進め、イベントを発行する
+	/// モデルには反映しないため、別スレッドから呼んでもよい
+	/// (ただし同じAnimatorを複数のスレッドから同時に扱ってはいけない)
+	/// </summary>
+	void Advance();
+	/// <summary>
+	/// Advanceで進めた内容をモデルへ反映する
+	/// DxLibを使用するためメインスレッドから呼ぶ
+	/// </summary>
+	void ApplyToModel();
+
+	/// <summary>
+	/// モデルへアニメーションを反映する間隔を設定する(アニメーションLOD用)
+	/// 再生時間は毎フレーム進めるため、反映を間引いても終了判定などはずれない
+	/// </summary>
+	/// <param name="interval">反映間隔(1なら毎フレーム反映)</param>
+	/// <param name="phase">反映するフレームをずらす量(同時に反映が集中しないようにする)</param>
+	void SetApplyInterval(int interval, int phase = 0);
+
 	/// <summary>
 	/// 最初に使用するアニメーションを設定
 	/// </summary>
 	/// <param name="animName"></param>
-	void SetStartAnim(const std::wstring animName);
+	void SetStartAnim(const std::wstring& animName);
 	/// <summary>
 	/// ゲーム中で使用するアニメーションデータ
 	/// </summary>
-	void SetAnimData(const std::wstring animName, const float animSpeed, const bool isLoop, 
-		float inputAcceptanceStartRatio = 0.0f, 
-		float inputAcceptanceEndRatio = 1.0f);
+	void SetAnimData(const std::wstring& animName, const float animSpeed, const bool isLoop);
+	/// <summary>
+	/// 登録済みのアニメーションにイベントを追加する
+	/// </summary>
+	/// <param name="animName">アニメーション名</param>
+	/// <param name="ratio">発行するタイミング(総再生時間に対する比率 0.0-1.0)</param>
+	/// <param name="type">イベントの種類</param>
+	/// <param name="param">種類ごとの追加情報</param>
+	void AddAnimEvent(const std::wstring& animName, float ratio, EventType type, int param = 0);
+	/// <summary>
+	/// イベントを受け取る関数を設定する
+	/// </summary>
+	void SetEventHandler(EventHandler_t handler) { _eventHandler = handler; }
 	/// <summary>
 	/// アニメーション名を指定しアタッチ
 	/// (ブレンドの進行状況が止まるため初期化する目的で使用)
 	/// </summary>
 	/// <param name="animName"></param>
 	/// <param name="isLoop"></param>
-	void AttachAnim(const std::wstring animName, const bool isLoop);
+	void AttachAnim(const std::wstring& animName, const bool isLoop);
+
+	/// <summary>
+	/// 指定のアニメーションを最初から再生し直す
+	/// </summary>
+	/// <param name="animName"></param>
+	void RestartAnim(const std::wstring& animName);
 
 	/// <summary>
 	/// 指定されたアニメーションの更新
+	/// (モデルへの反映はApplyToModelで行う)
 	/// </summary>
 	/// <param name="data"></param>
 	void UpdateAnim(AnimData& data);
 
 	/// <summary>
 	/// ブレンド比率の更新
+	/// (モデルへの反映はApplyToModelで行う)
 	/// </summary>
 	void UpdateAnimBlendRate();
 
@@ -65,7 +131,13 @@ public:
 	/// </summary>
 	/// <param name="animName"></param>
 	/// <param name="isLoop"></param>
-	void ChangeAnim(const std::wstring animName, bool isLoop);
+	void ChangeAnim(const std::wstring& animName, bool isLoop);
+
+	/// <summary>
+	/// 指定のアニメーションを指定の再生時間から再生している状態にする
+	/// ブレンドは行わず、イベントも発行しない(状態の復元用)
+	/// </summary>
+	void RestoreAnim(const std::wstring& animName, float frame);
 
 	/// <summary>
 	/// アニメーションデータを名前で検索し参照を返す
@@ -74,11 +146,11 @@ public:
 	/// </summary>
 	/// <param name="animName"></param>
 	/// <returns></returns>
-	AnimData& FindAnimData(const std::wstring animName);
+	AnimData& FindAnimData(const std::wstring& animName);
 
 	int GetModelHandle() const{ return _model; }
 
-	std::wstring GetCurrentAnimName() const{ return _currentAnimName; }
+	const std::wstring& GetCurrentAnimName() const{ return _currentAnimName; }
 	
 	float GetCurrentAnimFrame();
 
@@ -87,15 +159,24 @@ public:
 	/// </summary>
 	/// <param name="animName"></param>
 	/// <returns></returns>
-	bool IsEnd(const std::wstring animName) { return FindAnimData(animName).isEnd; }
+	bool IsEnd(const std::wstring& animName) { return FindAnimData(animName).isEnd; }
 	/// <summary>
 	/// 指定のアニメーションがループするか
 	/// </summary>
 	/// <param name="animName"></param>
 	/// <returns></returns>
-	bool IsLoop(const std::wstring animName) { return FindAnimData(animName).isLoop; }
+	bool IsLoop(const std::wstring& animName) { return FindAnimData(animName).isLoop; }
 
 private:
+	/// <summary>
+	/// 再生位置がfromからtoへ進んだ間にあるイベントを発行する
+	/// </summary>
+	/// <param name="data">アニメーションデータ</param>
+	/// <param name="from">進める前の再生位置(この位置のイベントは含まない)</param>
+	/// <param name="to">進めた後の再生位置</param>
+	/// <param name="loopCount">進める間にループした回数</param>
+	void FireEvents(const AnimData& data, float from, float to, int loopCount);
+
 	// モデルハンドル
 	int _model;
 	
@@ -113,5 +194,18 @@ private:
 	// _currentAnimName のウェイトとして使用する
 	// 0.0->1.0
 	float _blendRate;
+
+	// モデルへアニメーションを反映する間隔と、反映タイミングのずらし量
+	int _applyInterval;
+	int _applyPhase;
+	// Updateが呼ばれた回数
+	int _updateCount;
+	// 今回の更新でモデルへ反映するか
+	bool _isApplyFrame;
+	// ブレンドが完了し、次の反映時にデタッチするアタッチ番号
+	std::vector<int> _pendingDetachNos;
+
+	// イベントを受け取る関数
+	EventHandler_t _eventHandler;
 };
 
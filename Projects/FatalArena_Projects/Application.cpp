@@ -4,8 +4,17 @@
 #include "Statistics.h"
 #include "DebugDraw.h"
 #include "SoundManager.h"
+#include "FontManager.h"
+#include "JobSystem.h"
+#include "EntityRegistry.h"
+#include "EnemyManager.h"
+#include "FrameAllocator.h"
+#include "AllocationCounter.h"
+#include "Random.h"
+#include "SelfTest.h"
 
 #include <DxLib.h>
+#include <shellapi.h>
 #include <cassert>
 #include <string>
 
@@ -46,20 +55,96 @@ bool Application::Init()
 	Input::GetInstance().SetInputType(Input::PeripheralType::pad1);
 
 	SoundManager::GetInstance().LoadResources();
+	// シーン切り替え時に作成待ちにならないよう、共通のフォントを作成しておく
+	FontManager::GetInstance().LoadResources();
 
-	// GetRandシード設定
-	auto t = static_cast<unsigned int>(time(nullptr));
-	SRand(t);
+	// ジョブを実行するワーカースレッドを起動
+	JobSystem::GetInstance().Init();
+
+	// シーンより先に生成しておく
+	// (シーンが持つ敵やアイテムより後に破棄されるようにするため)
+	EntityRegistry::GetInstance();
+
+	// 乱数のシード設定
+	// (試合ごとの乱数はこのシード値から作られる)
+	auto t = static_cast<uint64_t>(time(nullptr));
+	RandomService::GetInstance().SetSeed(t);
+
+	// リプレイの記録・再生
+	// (再生時は記録時のシード値を使う)
+	ParseReplayOption();
 
 	return true;
 }
 
+bool Application::IsSelfTestMode() const
+{
+	int argc = 0;
+	LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+	if (argv == nullptr) return false;
+
+	bool isSelfTest = false;
+	for (int i = 1; i < argc; ++i) {
+		if (std::wstring(argv[i]) == L"-selftest") {
+			isSelfTest = true;
+		}
+	}
+	LocalFree(argv);
+	return isSelfTest;
+}
+
+int Application::RunSelfTest()
+{
+	// 起動元のコンソールがあればそこへ出力する
+	if (!AttachConsole(ATTACH_PARENT_PROCESS)) {
+		AllocConsole();
+	}
+	_out = 0;
+	freopen_s(&_out, "CON", "w", stdout);
+
+	const int failureCount = SelfTest::RunAll();
+
+	fclose(_out);
+	FreeConsole();
+	return (failureCount == 0) ? 0 : 1;
+}
+
+void Application::ParseReplayOption()
+{
+	int argc = 0;
+	LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+	if (argv == nullptr) return;
+
+	Input& input = Input::GetInstance();
+	for (int i = 1; i < argc; ++i) {
+		const std::wstring arg = argv[i];
+		if (arg == L"-uncapped") {
+			_isUncappedReplay = true;
+		}
+		else if (arg == L"-record" && i + 1 < argc) {
+			_recordPath = argv[++i];
+			input.StartRecording(RandomService::GetInstance().GetSeed());
+		}
+		else if (arg == L"-replay" && i + 1 < argc) {
+			if (input.StartPlayback(argv[++i])) {
+				RandomService::GetInstance().SetSeed(input.GetReplaySeed());
+			}
+		}
+	}
+	LocalFree(argv);
+}
+
 void Application::Run()
 {
 	// シングルトンオブジェクトを取得
 	SceneController& sceneController = SceneController::GetInstance();
 	Input& input = Input::GetInstance();
 	DebugDraw& debugDraw = DebugDraw::GetInstance();
+	FrameAllocator& frameAllocator = FrameAllocator::GetInstance();
+
+	// リプレイ再生の計測用
+	const LONGLONG runStartTime = GetNowHiPerformanceCount();
+	int frameCount = 0;
 
 	while (ProcessMessage() != -1) {
 		// 今回のループが始まった時間を覚えておく
@@ -67,6 +152,9 @@ void Application::Run()
 
 		ClearDrawScreen();
 
+		// 前のフレームの一時データを破棄する
+		frameAllocator.Reset();
+
 #ifdef _DEBUG
 		// デバッグ描画情報を初期化
 		debugDraw.Clear();
@@ -79,6 +167,10 @@ void Application::Run()
 		sceneController.Update();
 		sceneController.Draw();
 
+		// このフレームに要求された効果音をまとめて鳴らし、BGMのフェードを進める
+		SoundManager::GetInstance().FlushSERequests();
+		SoundManager::GetInstance().UpdateBGM();
+
 #ifdef _DEBUG
 		// デバッグ描画
 		debugDraw.Draw();
@@ -86,11 +178,43 @@ void Application::Run()
 
 		ScreenFlip();
 
+		++frameCount;
+
 		// 終了キーが押されたら
 		if (input.IsPress("Debug::Exit1") && input.IsPress("Debug::Exit2")) {
 			break;	// 処理を抜ける
 		}
 
+		// リプレイを最後まで再生したら結果を出力して終了する
+		if (input.IsReplayFinished()) {
+			const LONGLONG elapsed = GetNowHiPerformanceCount() - runStartTime;
+			printf("Replay finished : %d frames, %.3f ms/frame\n",
+				frameCount, elapsed / 1000.0 / frameCount);
+
+			// 敵の更新(思考・並列更新・モデルへの反映を含む)にかかった時間
+			const EnemyManager::UpdateStats& enemyStats = EnemyManager::GetUpdateStats();
+			printf("Enemy update : %lld enemy-frames, %.1f ns per enemy per frame\n",
+				enemyStats.enemyFrames, (enemyStats.enemyFrames > 0) ?
+				enemyStats.totalUs * 1000.0 / enemyStats.enemyFrames : 0.0);
+
+			// ウェーブ進行中のフレームでヒープ確保が発生していないか
+			const uint64_t allocatingFrameCount = AllocationCounter::GetAllocatingFrameCount();
+			printf("Steady frames : %llu, with allocation : %llu (%llu allocations)\n",
+				AllocationCounter::GetSteadyFrameCount(), allocatingFrameCount,
+				AllocationCounter::GetSteadyAllocationCount());
+#ifndef _DEBUG
+			// Debugではデバッグ描画の記録で確保が起こりうるため、Releaseでのみ失敗として終了する
+			if (allocatingFrameCount > 0) {
+				printf("Zero allocation check : NG\n");
+				_exitCode = 1;
+			}
+#endif // !_DEBUG
+			break;
+		}
+
+		// リプレイを速度制限なしで再生している間はFPSを固定しない
+		if (_isUncappedReplay && input.IsPlayingReplay()) continue;
+
 		// FPS60に固定する
 		while (GetNowHiPerformanceCount() - time < 16667) {
 		}
@@ -99,7 +223,14 @@ void Application::Run()
 
 void Application::Terminate()
 {
+	// 記録した入力を書き出す
+	if (!_recordPath.empty()) {
+		Input::GetInstance().StopRecording(_recordPath);
+	}
+
+	JobSystem::GetInstance().Terminate();
 	SoundManager::GetInstance().ReleaseResources();
+	FontManager::GetInstance().ReleaseResources();
 	DxLib_End();
 	fclose(_out); fclose(_in); FreeConsole();//コンソール解放
 }
\ No newline at end of file
@@ -1,11 +1,12 @@
 ﻿#pragma once
 #include <DxLib.h>
+#include <string>
 
 class Application final {
 	// シングルトン化
 private:
 	Application()
-		: _in(), _out()
+		: _in(), _out(), _recordPath(), _isUncappedReplay(false), _exitCode(0)
 		{}
 	Application(const Application&) = delete;
 	void operator=(const Application&) = delete;
@@ -13,6 +14,21 @@ private:
 	FILE* _out;
 	FILE* _in;
 
+	// 入力を記録する場合の書き出し先(空なら記録しない)
+	std::wstring _recordPath;
+	// リプレイの再生中はフレームレートを固定せずに回すか
+	bool _isUncappedReplay;
+	// 終了コード(リプレイでの確認に失敗した場合は0以外)
+	int _exitCode;
+
+	/// <summary>
+	/// コマンドライン引数からリプレイの記録・再生の指定を読み取る
+	/// -record [ファイル] : 入力を記録し、終了時に書き出す
+	/// -replay [ファイル] : 記録した入力を再生する
+	/// -uncapped : 再生中はフレームレートを固定しない
+	/// </summary>
+	void ParseReplayOption();
+
 public:
 	/// <summary>
 	/// シングルトンオブジェクトを返す
@@ -20,6 +36,17 @@ public:
 	/// <returns>Applicationシングルトンオブジェクト</returns>
 	static Application& GetInstance();
 
+	/// <summary>
+	/// コマンドライン引数に -selftest が指定されているか
+	/// </summary>
+	bool IsSelfTestMode() const;
+
+	/// <summary>
+	/// ウィンドウとDxLibを使わずに確認と計測を行い、結果をコンソールに出力する
+	/// </summary>
+	/// <returns>終了コード(全て成功なら0)</returns>
+	int RunSelfTest();
+
 	/// <summary>
 	/// アプリケーションの初期化
 	/// </summary>
@@ -35,5 +62,10 @@ public:
 	/// アプリケーションの後処理
 	/// </summary>
 	void Terminate();
+
+	/// <summary>
+	/// プロセスの終了コードを返す
+	/// </summary>
+	int GetExitCode() const { return _exitCode; }
 };
 
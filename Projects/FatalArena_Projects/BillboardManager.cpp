@@ -1,9 +1,13 @@
 ﻿#include "BillboardManager.h"
-#include "BillboardAudience.h"
 #include "Calculation.h"
+#include "Random.h"
+#include "ViewFrustum.h"
 
-#include <DxLib.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <string>
+#include <emmintrin.h>
 
 namespace {
 	// 画像ファイルのパスをここで管理
@@ -28,25 +32,63 @@ namespace {
 
 	constexpr float kSpawnRadius = 2800.0f;		// 最も内側の円の半径
 	constexpr float kAddSpawnRadius = 400.0f;	// 円の半径補正量
+
 	constexpr float kSpawnHeight = 700.0f;		// 生成高度
 	constexpr float kAddSpawnHeight = 250.0f;	// 生成高度補正量
+
+	// 観客の描画サイズ(幅)
+	constexpr float kAudienceWidth = 500.0f;
+
+	// 上下動
+	constexpr float kAnimationLoopFrame = 10.0f;
+	constexpr float kAnimationMoveMul = 3.0f;
+	// 1フレームで進める位相
+	constexpr float kBobStep = 1.0f / kAnimationLoopFrame;
+
+	// アトラス内の画像の間隔(隣の画像がにじまないようにする)
+	constexpr int kAtlasPadding = 4;
+
+	// 観客1人分の頂点数とポリゴン数
+	constexpr int kQuadVertexNum = 4;
+	constexpr int kQuadIndexNum = 6;
+	constexpr int kQuadPolygonNum = 2;
+
+	// 同時に更新する数(SSEのレーン数)
+	constexpr int kLaneNum = 4;
 }
 
 BillboardManager::BillboardManager() :
-	_items()
+	_posX(),
+	_posY(),
+	_posZ(),
+	_bobSin(),
+	_bobCos(),
+	_boundsRadius(),
+	_cellIndex(),
+	_atlasHandle(-1),
+	_atlasCells(),
+	_isVisible(),
+	_culledCount(0),
+	_vertices(),
+	_indices()
 {
 	// 処理なし
 }
 
 BillboardManager::~BillboardManager()
 {
-	// 処理なし
+	if (_atlasHandle != -1) {
+		DeleteGraph(_atlasHandle);
+	}
 }
 
 void BillboardManager::Init()
 {
+	CreateAtlas();
+
 	float radius = kSpawnRadius;		// 生成する円周の半径
 	float spawnHeight = kSpawnHeight;	// 生成高度
+	RandomStream& random = RandomService::GetInstance().GetStream(RandomStreamType::Billboard);
 	for (const int num : kDrawAmount) {
 		float audDistAngle = static_cast<float>(Calc::ToRadian(360) / num);
 		for (int i = 0; i < num; ++i) {
@@ -56,36 +98,209 @@ void BillboardManager::Init()
 			// 原点を中心に生成
 			Position3 spawnPos = Vector3(cos(angle) * radius, spawnHeight, sin(angle) * radius);
 			Position3 spawnPosOffset = 
-				Vector3(GetRand(kPosOffsetAmount - 1), GetRand(kPosOffsetAmount - 1), GetRand(kPosOffsetAmount - 1));
-			int audienceNum = GetRand((int)kGraphPaths.size() - 1);
+				Vector3(random.GetInt(kPosOffsetAmount - 1), random.GetInt(kPosOffsetAmount - 1), random.GetInt(kPosOffsetAmount - 1));
+			int audienceNum = random.GetInt((int)kGraphPaths.size() - 1);
 			// 観客を生成
-			SpawnAudience(spawnPos, LoadGraph(kGraphPaths[audienceNum].c_str()));
+			SpawnAudience(spawnPos, audienceNum);
 		}
 		radius += kAddSpawnRadius;
 		spawnHeight += kAddSpawnHeight;
 	}
+
+	// 描画用の領域は最初にまとめて確保する
+	// (インデックスは詰めて並べた頂点に対して共通で使える)
+	const int audienceNum = static_cast<int>(_posX.size());
+	assert(audienceNum * kQuadVertexNum <= 0xffff && "観客が多すぎる");
+	_isVisible.resize(audienceNum);
+	_vertices.resize(audienceNum * kQuadVertexNum);
+	_indices.resize(audienceNum * kQuadIndexNum);
+	for (int i = 0; i < audienceNum; ++i) {
+		const unsigned short base = static_cast<unsigned short>(i * kQuadVertexNum);
+		unsigned short* index = &_indices[i * kQuadIndexNum];
+		// 左上、右上、左下 / 左下、右上、右下
+		index[0] = base + 0;
+		index[1] = base + 1;
+		index[2] = base + 2;
+		index[3] = base + 2;
+		index[4] = base + 1;
+		index[5] = base + 3;
+	}
 }
 
 void BillboardManager::Update()
 {
-	for (auto& item : _items) {
-		item->Update();
+	// 上下動の位相を一定量回転させ、その高さ分動かす
+	// (sinを毎回計算せず、回転行列の乗算で進める)
+	const float stepSin = std::sin(kBobStep);
+	const float stepCos = std::cos(kBobStep);
+	const int audienceNum = static_cast<int>(_posY.size());
+
+	int i = 0;
+	const __m128 vStepSin = _mm_set1_ps(stepSin);
+	const __m128 vStepCos = _mm_set1_ps(stepCos);
+	const __m128 vMoveMul = _mm_set1_ps(kAnimationMoveMul);
+	const __m128 vHalf = _mm_set1_ps(0.5f);
+	const __m128 vThreeHalf = _mm_set1_ps(1.5f);
+	for (; i + kLaneNum <= audienceNum; i += kLaneNum) {
+		const __m128 s = _mm_loadu_ps(&_bobSin[i]);
+		const __m128 c = _mm_loadu_ps(&_bobCos[i]);
+		__m128 nextSin = _mm_add_ps(_mm_mul_ps(s, vStepCos), _mm_mul_ps(c, vStepSin));
+		__m128 nextCos = _mm_sub_ps(_mm_mul_ps(c, vStepCos), _mm_mul_ps(s, vStepSin));
+		// 誤差で長さがずれていかないよう1に近づける
+		const __m128 lenSq = _mm_add_ps(_mm_mul_ps(nextSin, nextSin), _mm_mul_ps(nextCos, nextCos));
+		const __m128 scale = _mm_sub_ps(vThreeHalf, _mm_mul_ps(vHalf, lenSq));
+		nextSin = _mm_mul_ps(nextSin, scale);
+		nextCos = _mm_mul_ps(nextCos, scale);
+		_mm_storeu_ps(&_bobSin[i], nextSin);
+		_mm_storeu_ps(&_bobCos[i], nextCos);
+
+		const __m128 y = _mm_loadu_ps(&_posY[i]);
+		_mm_storeu_ps(&_posY[i], _mm_add_ps(y, _mm_mul_ps(nextSin, vMoveMul)));
+	}
+
+	// 端数は1つずつ更新する
+	for (; i < audienceNum; ++i) {
+		float nextSin = _bobSin[i] * stepCos + _bobCos[i] * stepSin;
+		float nextCos = _bobCos[i] * stepCos - _bobSin[i] * stepSin;
+		const float scale = 1.5f - 0.5f * (nextSin * nextSin + nextCos * nextCos);
+		_bobSin[i] = nextSin * scale;
+		_bobCos[i] = nextCos * scale;
+		_posY[i] += _bobSin[i] * kAnimationMoveMul;
 	}
 }
 
-void BillboardManager::Draw()
+void BillboardManager::Draw(const ViewFrustum& frustum)
 {
-	for (auto& item : _items) {
-		item->Draw();
+	const int audienceNum = static_cast<int>(_posX.size());
+	if (audienceNum <= 0) return;
+
+	// 視界内の観客を絞り込む
+	const int visibleNum = frustum.CullSpheres(
+		_posX.data(), _posY.data(), _posZ.data(), _boundsRadius.data(),
+		audienceNum, _isVisible.data());
+	_culledCount = audienceNum - visibleNum;
+	if (visibleNum <= 0) return;
+
+	// カメラに正対させる向き
+	const MATRIX billboard = GetCameraBillboardMatrix();
+	const Vector3 right = Vector3(billboard.m[0][0], billboard.m[0][1], billboard.m[0][2]);
+	const Vector3 up = Vector3(billboard.m[1][0], billboard.m[1][1], billboard.m[1][2]);
+
+	const int quadNum = BuildVertices(right, up);
+
+	// 全員分をまとめて描画する
+	DrawPolygonIndexed3D(
+		_vertices.data(), quadNum * kQuadVertexNum,
+		_indices.data(), quadNum * kQuadPolygonNum,
+		_atlasHandle, true);
+}
+
+void BillboardManager::CreateAtlas()
+{
+	// 画像を読み込み、最も大きいものに合わせてセルの大きさを決める
+	const int graphNum = static_cast<int>(kGraphPaths.size());
+	std::vector<int> graphHandles(graphNum);
+	std::vector<int> graphWidths(graphNum);
+	std::vector<int> graphHeights(graphNum);
+	int cellWidth = 0;
+	int cellHeight = 0;
+	for (int i = 0; i < graphNum; ++i) {
+		graphHandles[i] = LoadGraph(kGraphPaths[i].c_str());
+		assert(graphHandles[i] >= 0 && "観客の画像の読み込みに失敗");
+		GetGraphSize(graphHandles[i], &graphWidths[i], &graphHeights[i]);
+		cellWidth = std::max(cellWidth, graphWidths[i]);
+		cellHeight = std::max(cellHeight, graphHeights[i]);
+	}
+
+	// 横一列に並べる
+	const int atlasWidth = (cellWidth + kAtlasPadding) * graphNum;
+	const int atlasHeight = cellHeight;
+	_atlasHandle = MakeScreen(atlasWidth, atlasHeight, true);
+	assert(_atlasHandle >= 0 && "アトラスの作成に失敗");
+	FillGraph(_atlasHandle, 0, 0, 0, 0);
+
+	const int prevScreen = GetDrawScreen();
+	SetDrawScreen(_atlasHandle);
+	SetDrawBlendMode(DX_BLENDMODE_NOBLEND, 0);
+
+	_atlasCells.resize(graphNum);
+	for (int i = 0; i < graphNum; ++i) {
+		const int x = (cellWidth + kAtlasPadding) * i;
+		DrawGraph(x, 0, graphHandles[i], true);
+
+		AtlasCell& cell = _atlasCells[i];
+		cell.u0 = static_cast<float>(x) / atlasWidth;
+		cell.v0 = 0.0f;
+		cell.u1 = static_cast<float>(x + graphWidths[i]) / atlasWidth;
+		cell.v1 = static_cast<float>(graphHeights[i]) / atlasHeight;
+		cell.aspect = static_cast<float>(graphHeights[i]) / graphWidths[i];
+
+		// アトラスに書き込んだので元の画像は不要
+		DeleteGraph(graphHandles[i]);
 	}
+
+	// (描画先を切り替えるとカメラの設定が初期化されるが、カメラ側で毎フレーム設定している)
+	SetDrawScreen(prevScreen);
 }
 
-void BillboardManager::SpawnAudience(Position3 pos, int modelHandle)
+void BillboardManager::SpawnAudience(const Position3& pos, int cellIndex)
 {
-	float prog = GetRand(10000) / 10000.0f;
-	std::shared_ptr<BillboardAudience> newAud =
-		std::make_shared<BillboardAudience>(modelHandle, prog);
-	newAud->SetPos(pos);
-	_items.emplace_back(newAud);
+	float prog = RandomService::GetInstance().GetStream(RandomStreamType::Billboard).GetInt(10000) / 10000.0f;
+	// 上下動の開始位置
+	const int startFrame = static_cast<int>((kAnimationLoopFrame * kAnimationLoopFrame) * prog);
+	const float phase = startFrame * kBobStep;
+
+	// 足元から上に広がる画像全体を含む大きさ
+	const float width = kAudienceWidth;
+	const float height = kAudienceWidth * _atlasCells[cellIndex].aspect;
+	const float boundsRadius = std::sqrt(width * width * 0.25f + height * height);
+
+	_posX.emplace_back(pos.x);
+	_posY.emplace_back(pos.y);
+	_posZ.emplace_back(pos.z);
+	_bobSin.emplace_back(std::sin(phase));
+	_bobCos.emplace_back(std::cos(phase));
+	_boundsRadius.emplace_back(boundsRadius);
+	_cellIndex.emplace_back(static_cast<uint8_t>(cellIndex));
 }
 
+int BillboardManager::BuildVertices(const Vector3& right, const Vector3& up)
+{
+	const COLOR_U8 diffuse = GetColorU8(255, 255, 255, 255);
+	const COLOR_U8 specular = GetColorU8(0, 0, 0, 0);
+	const Vector3 normal = Cross(right, up);
+
+	int quadNum = 0;
+	const int audienceNum = static_cast<int>(_posX.size());
+	for (int i = 0; i < audienceNum; ++i) {
+		if (!_isVisible[i]) continue;
+
+		const AtlasCell& cell = _atlasCells[_cellIndex[i]];
+		const Vector3 halfWidth = right * (kAudienceWidth * 0.5f);
+		const Vector3 height = up * (kAudienceWidth * cell.aspect);
+
+		// 足元の中心を基準にする
+		const Position3 foot = Vector3(_posX[i], _posY[i], _posZ[i]);
+		const Position3 bottomLeft = foot - halfWidth;
+		const Position3 bottomRight = foot + halfWidth;
+
+		VERTEX3D* vertex = &_vertices[quadNum * kQuadVertexNum];
+		vertex[0].pos = bottomLeft + height;	// 左上
+		vertex[1].pos = bottomRight + height;	// 右上
+		vertex[2].pos = bottomLeft;				// 左下
+		vertex[3].pos = bottomRight;			// 右下
+		vertex[0].u = cell.u0; vertex[0].v = cell.v0;
+		vertex[1].u = cell.u1; vertex[1].v = cell.v0;
+		vertex[2].u = cell.u0; vertex[2].v = cell.v1;
+		vertex[3].u = cell.u1; vertex[3].v = cell.v1;
+		for (int v = 0; v < kQuadVertexNum; ++v) {
+			vertex[v].norm = normal;
+			vertex[v].dif = diffuse;
+			vertex[v].spc = specular;
+			vertex[v].su = 0.0f;
+			vertex[v].sv = 0.0f;
+		}
+		++quadNum;
+	}
+	return quadNum;
+}
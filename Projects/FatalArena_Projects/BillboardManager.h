@@ -1,11 +1,16 @@
 ﻿#pragma once
 #include "Vector3.h"
 
-#include <memory>
+#include <DxLib.h>
 #include <vector>
+#include <cstdint>
 
-class BillboardAudience;
+class ViewFrustum;
 
+/// <summary>
+/// 観客ビルボードをまとめて管理する
+/// 観客の画像は1枚のアトラスにまとめ、視界内の全員を1回のポリゴン描画で描画する
+/// </summary>
 class BillboardManager
 {
 public:
@@ -23,18 +28,65 @@ public:
 	void Update();
 
 	/// <summary>
-	/// 描画
+	/// 視界内の観客を描画する
 	/// </summary>
-	void Draw();
+	void Draw(const ViewFrustum& frustum);
 
 	/// <summary>
-	/// 指定された観客を生成する
+	/// 直近の描画で視界外とされた数
 	/// </summary>
-	/// <param name="type"></param>
-	void SpawnAudience(Position3 pos, int modelHandle);
+	int GetCulledCount() const { return _culledCount; }
 
 private:
-	// 生成したアイテム
-	std::vector<std::shared_ptr<BillboardAudience>> _items;
-};
+	// アトラス内の画像1枚分の情報
+	struct AtlasCell
+	{
+		float u0 = 0.0f;
+		float v0 = 0.0f;
+		float u1 = 0.0f;
+		float v1 = 0.0f;
+		float aspect = 1.0f;	// 幅に対する高さの比率
+	};
+
+	/// <summary>
+	/// 観客の画像を読み込み、1枚のアトラスにまとめる
+	/// </summary>
+	void CreateAtlas();
+
+	/// <summary>
+	/// 観客を追加する
+	/// </summary>
+	/// <param name="pos">足元の位置</param>
+	/// <param name="cellIndex">使用する画像(アトラス内の番号)</param>
+	void SpawnAudience(const Position3& pos, int cellIndex);
 
+	/// <summary>
+	/// 視界内の観客の頂点を詰めて作る
+	/// </summary>
+	/// <param name="right">画面の右方向</param>
+	/// <param name="up">画面の上方向</param>
+	/// <returns>頂点を作った観客の数</returns>
+	int BuildVertices(const Vector3& right, const Vector3& up);
+
+	// 観客ごとの情報
+	// (まとめて処理できるよう要素ごとに分けて持つ)
+	std::vector<float> _posX;
+	std::vector<float> _posY;
+	std::vector<float> _posZ;
+	std::vector<float> _bobSin;		// 上下動の位相(sin)
+	std::vector<float> _bobCos;		// 上下動の位相(cos)
+	std::vector<float> _boundsRadius;	// 視界内判定に使用する境界球の半径
+	std::vector<uint8_t> _cellIndex;	// 使用する画像
+
+	// 観客の画像をまとめたアトラス
+	int _atlasHandle;
+	std::vector<AtlasCell> _atlasCells;
+
+	// 視界内かどうか(観客と同じ並び)
+	std::vector<uint8_t> _isVisible;
+	int _culledCount;
+
+	// 描画に使用する頂点とインデックス(毎フレームの確保を避けるため保持する)
+	std::vector<VERTEX3D> _vertices;
+	std::vector<unsigned short> _indices;
+};
@@ -4,6 +4,7 @@
 #include "Calculation.h"
 #include "Statistics.h"
 #include "Arena.h"
+#include "ViewFrustum.h"
 
 #include <DxLib.h>
 
@@ -110,6 +111,12 @@ void Camera::Update()
 	(this->*_nowUpdateState)();
 }
 
+void Camera::BuildViewFrustum(ViewFrustum& frustum) const
+{
+	constexpr float kAspect = static_cast<float>(Statistics::kScreenWidth) / Statistics::kScreenHeight;
+	frustum.Setup(_pos, _targetPos, _viewAngle, kAspect, _near, _far);
+}
+
 void Camera::Draw() const
 {
 	// ライトの位置と方向を更新
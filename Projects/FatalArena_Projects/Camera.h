@@ -3,6 +3,7 @@
 #include <memory>
 
 class Player;
+class ViewFrustum;
 
 /// <summary>
 /// ゲームシーンにおけるカメラを管理するクラス
@@ -17,6 +18,10 @@ public:
 	void Draw() const;
 
 	Position3 GetPos() const { return _pos; }
+	/// <summary>
+	/// 縦の画角(ラジアン)
+	/// </summary>
+	float GetViewAngle() const { return _viewAngle; }
 
 	/// <summary>
 	/// Y軸の回転情報
@@ -24,6 +29,11 @@ public:
 	/// <returns></returns>
 	float GetRotAngleY() const { return _rotAngle.y; }
 
+	/// <summary>
+	/// 現在の位置、注視点、画角、描画距離から視錐台を作る
+	/// </summary>
+	void BuildViewFrustum(ViewFrustum& frustum) const;
+
 	/// <summary>
 	/// 呼ばれたらステートを一つ進める
 	/// </summary>
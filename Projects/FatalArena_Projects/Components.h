@@ -0,0 +1,17 @@
+﻿#pragma once
+
+class EnemyBase;
+
+// EntityRegistryで管理するコンポーネント
+// 処理をまとめて行えるよう、データのみを持たせる
+// (個々のオブジェクトから1つずつ引く値は、引く手間の方が大きいためオブジェクト自身に持たせる)
+
+/// <summary>
+/// 思考の状態
+/// </summary>
+struct AIStateComponent
+{
+	int thinkWaitFrame = 0;		// 最後に思考してからのフレーム数
+	bool isThinking = true;		// 思考の対象か(死亡後は待ち時間を進めない)
+	EnemyBase* owner = nullptr;	// 思考させる敵(列を順に処理する際に呼び出す)
+};
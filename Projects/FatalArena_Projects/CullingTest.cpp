@@ -0,0 +1,127 @@
+﻿#include "SelfTest.h"
+#include "ViewFrustum.h"
+#include "RenderSnapshot.h"
+#include "RenderQueue.h"
+#include "RecordingRenderBackend.h"
+#include <random>
+#include <vector>
+
+namespace {
+	// 確認に使うカメラ(原点からZ+方向を見る)
+	constexpr float kFovY = 3.14159265f / 3.0f;
+	constexpr float kAspect = 16.0f / 9.0f;
+	constexpr float kNear = 1.0f;
+	constexpr float kFar = 1000.0f;
+
+	// まとめて判定する数(4つずつの端数が出るようにする)
+	constexpr int kRandomSphereNum = 1003;
+	constexpr float kRandomRange = 1500.0f;
+	constexpr float kMaxRandomRadius = 50.0f;
+	constexpr unsigned int kRandomSeed = 12345;
+
+	// 確認に使うモデルのハンドルの先頭
+	constexpr int kFirstModelHandle = 100;
+
+	/// <summary>
+	/// 判定の内容と、期待する結果
+	/// </summary>
+	struct SphereCase
+	{
+		BoundingSphere sphere;
+		bool isVisible;
+		const char* name;
+	};
+
+	ViewFrustum MakeFrustum()
+	{
+		ViewFrustum frustum;
+		frustum.Setup(Position3(0.0f, 0.0f, 0.0f), Position3(0.0f, 0.0f, 1.0f),
+			kFovY, kAspect, kNear, kFar);
+		return frustum;
+	}
+
+	const std::vector<SphereCase>& GetSphereCases()
+	{
+		static const std::vector<SphereCase> cases = {
+			{ { Position3(0.0f, 0.0f, 100.0f), 1.0f }, true, "a sphere in front of the camera is visible" },
+			{ { Position3(0.0f, 0.0f, -100.0f), 1.0f }, false, "a sphere behind the camera is culled" },
+			{ { Position3(0.0f, 0.0f, 2000.0f), 1.0f }, false, "a sphere beyond the far plane is culled" },
+			{ { Position3(500.0f, 0.0f, 100.0f), 1.0f }, false, "a sphere far to the side is culled" },
+			{ { Position3(105.0f, 0.0f, 100.0f), 10.0f }, true, "a sphere crossing the side plane is visible" },
+			{ { Position3(0.0f, 0.0f, 0.5f), 0.1f }, false, "a sphere in front of the near plane is culled" },
+		};
+		return cases;
+	}
+}
+
+void SelfTest::RunCullingTests()
+{
+	PrintHeader("Culling");
+	const ViewFrustum frustum = MakeFrustum();
+	const auto& cases = GetSphereCases();
+
+	// 1つずつの判定
+	for (const auto& sphereCase : cases) {
+		Check(frustum.IsVisible(sphereCase.sphere) == sphereCase.isVisible, sphereCase.name);
+	}
+
+	// まとめて判定した結果は、1つずつ判定した結果と一致する
+	{
+		std::mt19937 random(kRandomSeed);
+		std::uniform_real_distribution<float> posDist(-kRandomRange, kRandomRange);
+		std::uniform_real_distribution<float> radiusDist(0.0f, kMaxRandomRadius);
+		std::vector<float> x(kRandomSphereNum);
+		std::vector<float> y(kRandomSphereNum);
+		std::vector<float> z(kRandomSphereNum);
+		std::vector<float> radius(kRandomSphereNum);
+		for (int i = 0; i < kRandomSphereNum; ++i) {
+			x[i] = posDist(random);
+			y[i] = posDist(random);
+			z[i] = posDist(random);
+			radius[i] = radiusDist(random);
+		}
+		std::vector<uint8_t> isVisible(kRandomSphereNum);
+		const int visibleNum = frustum.CullSpheres(x.data(), y.data(), z.data(), radius.data(),
+			kRandomSphereNum, isVisible.data());
+
+		int mismatchCount = 0;
+		int expectedVisibleNum = 0;
+		for (int i = 0; i < kRandomSphereNum; ++i) {
+			const bool isExpected = frustum.IsVisible({ Position3(x[i], y[i], z[i]), radius[i] });
+			if (isExpected) ++expectedVisibleNum;
+			if ((isVisible[i] != 0) != isExpected) ++mismatchCount;
+		}
+		Check(mismatchCount == 0, "CullSpheres matches IsVisible for every sphere");
+		Check(visibleNum == expectedVisibleNum, "CullSpheres returns the number of visible spheres");
+	}
+
+	// 視界外とされたモデルは描画キューに積まれない
+	{
+		RenderSnapshot snapshot;
+		int expectedCulledNum = 0;
+		std::vector<int> expectedHandles;
+		for (int i = 0; i < static_cast<int>(cases.size()); ++i) {
+			snapshot.AddModel(kFirstModelHandle + i, cases[i].sphere);
+			if (cases[i].isVisible) {
+				expectedHandles.emplace_back(kFirstModelHandle + i);
+			}
+			else {
+				++expectedCulledNum;
+			}
+		}
+		snapshot.Cull(frustum);
+		Check(snapshot.culledCount == expectedCulledNum, "RenderSnapshot::Cull counts the culled models");
+
+		RenderQueue queue;
+		RecordingRenderBackend backend;
+		queue.SubmitModels(snapshot, Position3(0.0f, 0.0f, 0.0f));
+		queue.Sort();
+		queue.Execute(backend);
+
+		std::vector<int> drawnHandles;
+		for (const auto& record : backend.GetRecords()) {
+			drawnHandles.emplace_back(record.modelHandle);
+		}
+		Check(drawnHandles == expectedHandles, "only visible models reach the render backend");
+	}
+}
@@ -1,6 +1,14 @@
 ﻿#include "DebugDraw.h"
 #include <DxLib.h>
 
+namespace {
+	// 事前に確保しておく描画情報の数
+	// (毎フレーム消去しても確保済みの領域は残るため、途中で確保し直さないようにする)
+	constexpr int kReserveLineNum = 256;
+	constexpr int kReserveSphereNum = 512;
+	constexpr int kReserveCapsuleNum = 256;
+}
+
 DebugDraw& DebugDraw::GetInstance()
 {
 	static DebugDraw ret;
@@ -78,5 +86,8 @@ void DebugDraw::DrawCapsule(const Vector3& start, const Vector3& end, float rad,
 }
 
 DebugDraw::DebugDraw() {
+	_lineInfo.reserve(kReserveLineNum);
+	_sphereInfo.reserve(kReserveSphereNum);
+	_capsuleInfo.reserve(kReserveCapsuleNum);
 	Clear();
 }
@@ -6,6 +6,9 @@
 #include "Collider.h"
 #include "ColliderData.h"
 #include "Rigidbody.h"
+#include "EnemyCommandBuffer.h"
+#include "Components.h"
+#include "SnapshotArchive.h"
 #include <cassert>
 
 #include <DxLib.h>
@@ -21,7 +24,15 @@ EnemyBase::EnemyBase(CapsuleColliderDesc desc, float hitPoint, float transferAtt
 	_quaternion(),
 	_hitPoint(hitPoint),
 	_transferAttackRad(transferAttackRad),
-	_state(State::Spawning)
+	_state(State::Spawning),
+	_animLodInterval(1),
+	_animLodPhase(0),
+	_modelLod(ModelLod::Full),
+	_steeringDir(),
+	_entity(kNullEntity),
+	_bodySourceHandle(-1),
+	_weaponSourceHandle(-1),
+	_commandBuffer()
 {
 	colliderData = CreateColliderData(
 		desc,	// 詳細情報
@@ -31,13 +42,87 @@ EnemyBase::EnemyBase(CapsuleColliderDesc desc, float hitPoint, float transferAtt
 
 	// 自身の武器やほかの敵の武器とは当たり判定を行わない
 	colliderData->AddThroughTag(PhysicsData::GameObjectTag::EnemyAttack);
+
+	// 思考の状態はコンポーネントとしてまとめて管理する
+	EntityRegistry& registry = EntityRegistry::GetInstance();
+	_entity = registry.Create();
+	AIStateComponent aiState;
+	aiState.owner = this;
+	registry.Add(_entity, aiState);
 }
 
 EnemyBase::~EnemyBase()
 {
+	EntityRegistry::GetInstance().Destroy(_entity);
+}
+
+void EnemyBase::Update()
+{
+	UpdateCompute(_commandBuffer);
+	_commandBuffer.Execute();
+	ApplyModel();
 }
 
 void EnemyBase::SetPos(const Vector3& pos)
 {
 	rigidbody->SetPos(pos);
 }
+
+void EnemyBase::SetSourceModels(int bodySourceHandle, int weaponSourceHandle)
+{
+	_bodySourceHandle = bodySourceHandle;
+	_weaponSourceHandle = weaponSourceHandle;
+}
+
+void EnemyBase::Think()
+{
+	CheckStateTransition();
+}
+
+void EnemyBase::BeginDying()
+{
+	_state = State::Dying;
+	EntityRegistry::GetInstance().Get<AIStateComponent>(_entity).isThinking = false;
+}
+
+void EnemyBase::SaveSnapshot(SnapshotWriter& writer) const
+{
+	const AIStateComponent& aiState = EntityRegistry::GetInstance().Get<AIStateComponent>(_entity);
+	writer.Write(GetPos());
+	writer.Write(GetVel());
+	writer.Write(_rotAngle);
+	writer.Write(_rotMtx);
+	writer.Write(_quaternion);
+	writer.Write(_state);
+	writer.Write(_steeringDir);
+	writer.Write(_hitPoint);
+	// 所有者のポインタは書き込まない
+	writer.Write(aiState.thinkWaitFrame);
+	writer.Write(aiState.isThinking);
+}
+
+void EnemyBase::LoadSnapshot(SnapshotReader& reader)
+{
+	AIStateComponent& aiState = EntityRegistry::GetInstance().Get<AIStateComponent>(_entity);
+	Vector3 pos;
+	Vector3 vel;
+	reader.Read(pos);
+	reader.Read(vel);
+	reader.Read(_rotAngle);
+	reader.Read(_rotMtx);
+	reader.Read(_quaternion);
+	reader.Read(_state);
+	reader.Read(_steeringDir);
+	reader.Read(_hitPoint);
+	reader.Read(aiState.thinkWaitFrame);
+	reader.Read(aiState.isThinking);
+
+	rigidbody->SetPos(pos);
+	rigidbody->SetVel(vel);
+}
+
+void EnemyBase::SetAnimLod(int interval, int phase)
+{
+	_animLodInterval = interval;
+	_animLodPhase = phase;
+}
@@ -1,12 +1,19 @@
 ﻿#pragma once
 #include "Geometry.h"
 #include "Collider.h"
+#include "EntityRegistry.h"
+#include "Handle.h"
+#include "EnemyLod.h"
+#include "EnemyCommandBuffer.h"
 #include <memory>
 
 class Player;
 class Animator;
 class Physics;
 class WeaponEnemy;
+struct RenderSnapshot;
+class SnapshotWriter;
+class SnapshotReader;
 enum class EnemyType;
 
 class EnemyBase abstract : public Collider
@@ -29,9 +36,27 @@ public:
 	EnemyBase(CapsuleColliderDesc desc, float hitPoint, float transferAttackRad);
 	virtual ~EnemyBase();
 
-	virtual void Init(std::weak_ptr<Player> player, std::weak_ptr<Physics> physics) abstract;
-	virtual void Update() abstract;
-	virtual void Draw() abstract;
+	virtual void Init(Handle<Player> player, std::weak_ptr<Physics> physics) abstract;
+	/// <summary>
+	/// 更新(UpdateComputeとApplyModelを続けて行う)
+	/// </summary>
+	virtual void Update();
+	/// <summary>
+	/// 自身の状態(アニメーションの進行、移動量、向きなど)を更新する
+	/// DxLibや共有されているものは触らず、副作用はcommandsに記録する
+	/// 別の敵のUpdateComputeとは並列に呼ばれる
+	/// </summary>
+	/// <param name="commands">副作用の記録先</param>
+	virtual void UpdateCompute(EnemyCommandBuffer& commands) abstract;
+	/// <summary>
+	/// UpdateComputeの結果をモデルと武器に反映する
+	/// メインスレッドから呼ぶ
+	/// </summary>
+	virtual void ApplyModel() abstract;
+	/// <summary>
+	/// 描画に必要な情報をスナップショットに書き込む
+	/// </summary>
+	virtual void WriteSnapshot(RenderSnapshot& snapshot) const abstract;
 
 	bool IsAlive() { return (_hitPoint > 0.0f); }
 
@@ -55,6 +80,50 @@ public:
 
 	void SetPos(const Vector3& pos);
 
+	/// <summary>
+	/// 本体と武器の複製元のモデルを設定する
+	/// (同じ複製元のものは続けて描画する)
+	/// </summary>
+	void SetSourceModels(int bodySourceHandle, int weaponSourceHandle);
+
+	/// <summary>
+	/// アニメーションLODによる反映間隔を設定する
+	/// </summary>
+	/// <param name="interval">モデルへアニメーションを反映する間隔(1なら毎フレーム)</param>
+	/// <param name="phase">反映するフレームをずらす量</param>
+	void SetAnimLod(int interval, int phase);
+
+	/// <summary>
+	/// モデルの詳細度を設定する
+	/// </summary>
+	void SetModelLod(ModelLod lod) { _modelLod = lod; }
+	ModelLod GetModelLod() const { return _modelLod; }
+
+	/// <summary>
+	/// 追跡時に向かう方向を設定する
+	/// (フローフィールドと周囲の敵との分離から求めたもの)
+	/// </summary>
+	/// <param name="dir">向かう方向(長さ0ならプレイヤーへ直接向かう)</param>
+	void SetSteeringDir(const Vector3& dir) { _steeringDir = dir; }
+
+	/// <summary>
+	/// 思考する(状態遷移の判断を行う)
+	/// AISchedulerから呼ばれ、思考してからのフレーム数はAISchedulerが戻す
+	/// </summary>
+	void Think();
+
+	/// <summary>
+	/// 被弾時や思考時に記録した副作用を実行する
+	/// メインスレッドから敵の並び順に呼ぶ
+	/// </summary>
+	void ExecuteCommands() { _commandBuffer.Execute(); }
+
+	/// <summary>
+	/// 予算に関係なくすぐに思考する必要があるか
+	/// (アニメーションが終了して次の状態を決める必要がある場合など)
+	/// </summary>
+	virtual bool IsThinkRequired() const { return false; }
+
 	/// <summary>
 	/// ダメージを受ける処理
 	/// </summary>
@@ -62,15 +131,39 @@ public:
 	/// <param name="attacker">攻撃してきた相手</param>
 	virtual void TakeDamage(float damage, std::shared_ptr<Collider> attacker) abstract;
 
+	/// <summary>
+	/// 位置や向き、体力、状態を書き込む・読み込む
+	/// 派生先では自身の状態を続けて書き込む
+	/// </summary>
+	virtual void SaveSnapshot(SnapshotWriter& writer) const;
+	virtual void LoadSnapshot(SnapshotReader& reader);
+
+	/// <summary>
+	/// 状態の復元で不要になった際に呼ばれる
+	/// physicsに登録されていれば登録を解除する
+	/// </summary>
+	virtual void Discard() abstract;
+
 protected:
+	/// <summary>
+	/// physicsに登録されている状態であるか
+	/// (死亡した時点で登録を解除している)
+	/// </summary>
+	bool IsPhysicsEntered() const { return (_state == State::Spawning || _state == State::Active); }
+
 	/// <summary>
 	/// ステートの遷移条件を確認し、変更可能なステートがあればそれに遷移する
 	/// </summary>
 	virtual void CheckStateTransition() abstract;
 
+	/// <summary>
+	/// 死亡中の状態にし、思考の対象から外す
+	/// </summary>
+	void BeginDying();
+
 	std::unique_ptr<Animator> _animator;
 	
-	std::weak_ptr<Player> _player;
+	Handle<Player> _player;
 
 	float _rotAngle;
 	Matrix4x4 _rotMtx;
@@ -84,4 +177,25 @@ protected:
 
 	// 自身の状態を保持
 	State _state;
+
+	// アニメーションLODによる反映間隔とずらし量
+	int _animLodInterval;
+	int _animLodPhase;
+	// モデルの詳細度
+	ModelLod _modelLod;
+
+	// 追跡時に向かう方向
+	Vector3 _steeringDir;
+
+	// 思考の状態(AIStateComponent)を持つ
+	// (AISchedulerが列を先頭から順に処理するため、自身には持たせない)
+	Entity_t _entity;
+
+	// 本体と武器の複製元のモデル
+	int _bodySourceHandle;
+	int _weaponSourceHandle;
+
+	// 並列更新の外(被弾時、思考時、単独での更新時)に発生した副作用の記録先
+	// 使い回すため、毎回作り直さない
+	EnemyCommandBuffer _commandBuffer;
 };
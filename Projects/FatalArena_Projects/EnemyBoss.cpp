@@ -6,6 +6,7 @@
 #include "Collider.h"
 #include "Rigidbody.h"
 #include "Calculation.h"
+#include "RenderSnapshot.h"
 #include <cassert>
 
 #include <DxLib.h>
@@ -48,13 +49,20 @@ namespace {
 		Calc::ToRadian(60.0f),
 		Calc::ToRadian(90.0f),
 		Calc::ToRadian(50.0f));
+
+	// 視界内判定に使用する境界球
+	// (振り回す武器を含めるため、武器の長さ分大きくする)
+	const Vector3 kCullBoundsOffset = Vector3Up() * (kColHeight * 0.5f);
+	const float kCullBoundsRadius = kColHeight * 0.5f + kWeaponDist;
 }
 
 EnemyBoss::EnemyBoss(int modelHandle) :
 	EnemyBase(CapsuleColliderDesc(kColRadius, kColOffset), 
 		kHitPoint, kAttackRange),
 	_nowUpdateState(&EnemyBoss::UpdateSpawning),
-	_weapon(std::make_unique<WeaponEnemy>())
+	_weapon(std::make_unique<WeaponEnemy>()),
+	_reactCooltime(0),
+	_spawnProgress(0.0f)
 
 {
 	rigidbody->Init(true);
@@ -102,14 +110,14 @@ EnemyBoss::~EnemyBoss()
 	// modelはanimator側で消している
 }
 
-void EnemyBoss::Init(std::weak_ptr<Player> player, std::weak_ptr<Physics> physics)
+void EnemyBoss::Init(Handle<Player> player, std::weak_ptr<Physics> physics)
 {
 	_player = player;
 
 	// 生成時にプレイヤーの方向を向く
-	if (!_player.expired()) {
+	if (_player.IsValid()) {
 		// プレイヤーへの方向ベクトル
-		Vector3 dirToPlayer = (_player.lock()->GetPos() - GetPos());
+		Vector3 dirToPlayer = (_player->GetPos() - GetPos());
 		if (dirToPlayer.SqrMagnitude() > 0.0f) {
 			// Y軸回転角度を計算
 			_rotAngle = atan2f(dirToPlayer.x, dirToPlayer.z);
@@ -119,27 +127,41 @@ void EnemyBoss::Init(std::weak_ptr<Player> player, std::weak_ptr<Physics> physic
 	MV1SetRotationXYZ(_animator->GetModelHandle(), Vector3(0, _rotAngle, 0));
 }
 
-void EnemyBoss::Update()
+void EnemyBoss::UpdateCompute(EnemyCommandBuffer& commands)
 {
-	_animator->Update();
+	_animator->Advance();
 
-	// 状態遷移確認
-	CheckStateTransition();
+	// 状態遷移の確認はAISchedulerから呼ばれるThinkで行う
 
 	// 現在のステートに応じたUpdateが行われる
 	(this->*_nowUpdateState)();
 
 	if (_reactCooltime > 0) _reactCooltime--;
+}
+
+void EnemyBoss::ApplyModel()
+{
+	_animator->ApplyToModel();
+
+	// 向きを適用
+	MV1SetRotationXYZ(_animator->GetModelHandle(), Vector3(0, _rotAngle + Calc::ToRadian(180.0f), 0));
+
+	// 出現中はスケールを適用
+	if (_nowUpdateState == &EnemyBoss::UpdateSpawning) {
+		MV1SetScale(_animator->GetModelHandle(), Vector3(1, 1, 1) * (kScaleMul * _spawnProgress));
+	}
 
 	WeaponUpdate();
 }
 
-void EnemyBoss::Draw()
+void EnemyBoss::WriteSnapshot(RenderSnapshot& snapshot) const
 {
-	// 当たり判定を行ってからモデルの位置を設定する
-	MV1SetPosition(_animator->GetModelHandle(), GetPos());
-	// モデルの描画
-	MV1DrawModel(_animator->GetModelHandle());
+	// 当たり判定を行った後の位置で描画する
+	BoundingSphere bounds;
+	bounds.center = GetPos() + kCullBoundsOffset;
+	bounds.radius = kCullBoundsRadius;
+
+	snapshot.AddModel(_animator->GetModelHandle(), GetPos(), bounds);
 }
 
 float EnemyBoss::GetMaxHitPoint() const
@@ -172,9 +194,11 @@ void EnemyBoss::TakeDamage(float damage, std::shared_ptr<Collider> attacker)
 		// 死亡判定
 		if (_hitPoint <= 0.0f &&
 			_state == State::Active) {
-			_state = State::Dying;
+			BeginDying();
 			_nowUpdateState = &EnemyBoss::UpdateDeath;
 			_animator->ChangeAnim(kAnimNameDeath, false);
+			// 物理判定から除外する
+			_commandBuffer.ReleasePhysics(this);
 			return;
 		}
 		// 既に被弾状態ならアニメーションを最初から再生
@@ -191,6 +215,12 @@ void EnemyBoss::TakeDamage(float damage, std::shared_ptr<Collider> attacker)
 	}
 }
 
+void EnemyBoss::Discard()
+{
+	if (!IsPhysicsEntered()) return;
+	ReleasePhysics();
+}
+
 void EnemyBoss::CheckStateTransition()
 {
 	// 出現状態か判定(優先)
@@ -207,9 +237,11 @@ void EnemyBoss::CheckStateTransition()
 	// 死亡したか判定(優先)
 	if (_hitPoint <= 0.0f &&
 		_state == State::Active) {
-		_state = State::Dying;
+		BeginDying();
 		_nowUpdateState = &EnemyBoss::UpdateDeath;
 		_animator->ChangeAnim(kAnimNameDeath, false);
+		// 物理判定から除外する
+		_commandBuffer.ReleasePhysics(this);
 		return;	// 死亡した場合は他の状態に遷移しない
 	}
 
@@ -231,7 +263,7 @@ void EnemyBoss::CheckStateTransition()
 	}
 
 	// プレイヤー情報の確認
-	if (_player.expired()) {
+	if (!_player.IsValid()) {
 		// もしプレイヤーがいない場合、追跡状態に戻る
 		if (_nowUpdateState != &EnemyBoss::UpdateChase) {
 			_nowUpdateState = &EnemyBoss::UpdateChase;
@@ -241,7 +273,7 @@ void EnemyBoss::CheckStateTransition()
 	}
 
 	// プレイヤーとの距離
-	float distance = (_player.lock()->GetPos() - GetPos()).Magnitude();
+	float distance = (_player->GetPos() - GetPos()).Magnitude();
 
 	// 攻撃状態
 	// プレイヤーとの距離が攻撃移行範囲よりも近かったら
@@ -286,9 +318,9 @@ void EnemyBoss::UpdateSpawning()
 		if (std::min<float>(animData.frame, animData.totalFrame)) {
 			progress = std::min<float>(animData.frame / animData.totalFrame, 1.0f);
 		}
-		// スケールを線形補間
-		float scale = progress * kScaleMul;
-		MV1SetScale(_animator->GetModelHandle(), Vector3(1, 1, 1) * scale);
+		// スケールを線形補間する
+		// (モデルへの適用はApplyModelで行う)
+		_spawnProgress = progress;
 	}
 }
 
@@ -318,8 +350,6 @@ void EnemyBoss::UpdateDeath()
 {
 	// 死亡アニメーションが終了したら、更新を止める
 	if (_animator->IsEnd(kAnimNameDeath) && _state != State::Dead) {
-		// 物理判定から除外する
-		ReleasePhysics();
 		_state = State::Dead; // 状態を死亡完了にする
 	}
 }
@@ -327,10 +357,10 @@ void EnemyBoss::UpdateDeath()
 void EnemyBoss::RotateToPlayer()
 {
 	// プレイヤーが見つからない場合行わない
-	if (_player.expired()) return;
+	if (!_player.IsValid()) return;
 
 	// プレイヤーへの方向ベクトル
-	Vector3 dirToPlayer = (_player.lock()->GetPos() - GetPos());
+	Vector3 dirToPlayer = (_player->GetPos() - GetPos());
 	if (dirToPlayer.SqrMagnitude() == 0.0f) return; // 距離がゼロなら何もしない
 	dirToPlayer.Normalized();
 
@@ -351,8 +381,7 @@ void EnemyBoss::RotateToPlayer()
 	float turnAmount = std::clamp<float>(diff, -kTurnSpeed, kTurnSpeed);
 	_rotAngle += turnAmount;
 
-	// モデルに回転を適用
-	MV1SetRotationXYZ(_animator->GetModelHandle(), Vector3(0, _rotAngle + Calc::ToRadian(180.0f), 0));
+	// モデルへの回転の適用はApplyModelで行う
 
 	// Rigidbodyの向きも更新
 	Vector3 newDir = Vector3(sinf(_rotAngle), 0.0f, cosf(_rotAngle)).Normalize();
@@ -7,9 +7,10 @@ class EnemyBoss final : public EnemyBase
 	EnemyBoss(int modelHandle);
 	~EnemyBoss();
 
-	void Init(std::weak_ptr<Player> player, std::weak_ptr<Physics> physics) override;
-	void Update() override;
-	void Draw() override;
+	void Init(Handle<Player> player, std::weak_ptr<Physics> physics) override;
+	void UpdateCompute(EnemyCommandBuffer& commands) override;
+	void ApplyModel() override;
+	void WriteSnapshot(RenderSnapshot& snapshot) const override;
 
 	/// <summary>
 	/// 敵タイプを返す
@@ -33,6 +34,7 @@ class EnemyBoss final : public EnemyBase
 	/// <param name="attacker">攻撃してきた相手</param>
 	void TakeDamage(float damage, std::shared_ptr<Collider> attacker) override;
 
+	void Discard() override;
 
 private:
 	/// <summary>
@@ -82,5 +84,8 @@ private:
 
 	// 無敵時間
 	int _reactCooltime;
+
+	// 出現アニメーションの進行度(0.0 ~ 1.0)
+	float _spawnProgress;
 };
 
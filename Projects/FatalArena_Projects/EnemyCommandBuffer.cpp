@@ -0,0 +1,75 @@
+﻿#include "EnemyCommandBuffer.h"
+#include "Collider.h"
+#include "Player.h"
+#include "SoundManager.h"
+#include <cassert>
+
+namespace {
+	// 最初に確保しておく命令の数
+	// (倒された際の命令がすべて収まるようにし、ウェーブ中に確保が起きないようにする)
+	constexpr int kReserveCommandNum = 8;
+}
+
+EnemyCommandBuffer::EnemyCommandBuffer() :
+	_commands()
+{
+	_commands.reserve(kReserveCommandNum);
+}
+
+EnemyCommandBuffer::~EnemyCommandBuffer()
+{
+}
+
+void EnemyCommandBuffer::PlaySound(SEType type)
+{
+	Command command;
+	command.type = CommandType::PlaySound;
+	command.param = static_cast<int>(type);
+	_commands.emplace_back(command);
+}
+
+void EnemyCommandBuffer::AddScore(Handle<Player> player, int score)
+{
+	Command command;
+	command.type = CommandType::AddScore;
+	command.param = score;
+	command.player = player;
+	_commands.emplace_back(command);
+}
+
+void EnemyCommandBuffer::ReleasePhysics(Collider* collider)
+{
+	assert(collider != nullptr && "対象が存在しない");
+	Command command;
+	command.type = CommandType::ReleasePhysics;
+	command.collider = collider;
+	_commands.emplace_back(command);
+}
+
+void EnemyCommandBuffer::Execute()
+{
+	for (const auto& command : _commands) {
+		switch (command.type) {
+		case CommandType::PlaySound:
+			SoundManager::GetInstance().PlaySoundType(static_cast<SEType>(command.param));
+			break;
+		case CommandType::AddScore:
+			if (Player* player = command.player.Get()) {
+				player->AddScore(command.param);
+			}
+			break;
+		case CommandType::ReleasePhysics:
+			command.collider->ReleasePhysics();
+			break;
+		default:
+			assert(false && "不明な命令");
+			break;
+		}
+	}
+	Clear();
+}
+
+void EnemyCommandBuffer::Clear()
+{
+	_commands.clear();
+}
@@ -0,0 +1,67 @@
+﻿#pragma once
+#include <vector>
+#include "Handle.h"
+
+class Collider;
+class Player;
+enum class SEType;
+
+/// <summary>
+/// 敵の更新中や被弾時に発生した副作用(効果音、スコア加算、物理からの除外)を記録し、
+/// 後でメインスレッドからまとめて実行する
+/// 敵の更新を並列に行う際、共有されているものを直接触らないようにするために使用する
+/// </summary>
+class EnemyCommandBuffer final
+{
+public:
+	EnemyCommandBuffer();
+	~EnemyCommandBuffer();
+
+	/// <summary>
+	/// 効果音を鳴らす
+	/// </summary>
+	void PlaySound(SEType type);
+
+	/// <summary>
+	/// プレイヤーにスコアを加算する
+	/// </summary>
+	void AddScore(Handle<Player> player, int score);
+
+	/// <summary>
+	/// 物理判定から除外する
+	/// (対象は実行されるまで生存している必要がある)
+	/// </summary>
+	void ReleasePhysics(Collider* collider);
+
+	/// <summary>
+	/// 記録した順に実行し、記録を消去する
+	/// メインスレッドから呼ぶ
+	/// </summary>
+	void Execute();
+
+	/// <summary>
+	/// 記録を消去する
+	/// </summary>
+	void Clear();
+
+	bool IsEmpty() const { return _commands.empty(); }
+
+private:
+	// 命令の種類
+	enum class CommandType
+	{
+		PlaySound,
+		AddScore,
+		ReleasePhysics,
+	};
+
+	struct Command
+	{
+		CommandType type = CommandType::PlaySound;
+		int param = 0;						// 効果音の種類、加算するスコア
+		Collider* collider = nullptr;		// 物理判定から除外する対象
+		Handle<Player> player;				// スコアを加算する対象
+	};
+
+	std::vector<Command> _commands;
+};
@@ -6,16 +6,48 @@
 #include <DxLib.h>
 #include <cassert>
 #include <string>
+#include <algorithm>
 
 namespace {
 	// モデルファイルのパスをここで一元管理
 	const std::unordered_map<EnemyType, std::wstring> kModelPaths = {
 		{ EnemyType::Normal, L"data/model/character/EnemyNormal.mv1" },
 	};
+	// 武器モデルのパス
+	const std::unordered_map<EnemyType, std::wstring> kWeaponModelPaths = {
+		{ EnemyType::Normal, L"data/model/weapon/EnemyWeapon.mv1" },
+	};
+
+	// 詳細度の設定
+	const std::unordered_map<EnemyType, EnemyLodSettings> kLodSettings = {
+		{ EnemyType::Normal, [] {
+			EnemyLodSettings settings;
+			settings.reducedScreenHeight = 160.0f;
+			settings.impostorScreenHeight = 48.0f;
+			settings.hysteresis = 0.15f;
+			settings.animInterval = { 1, 2, 8 };
+			settings.isDrawWeapon = { true, true, false };
+			return settings;
+		}() },
+	};
+	// 設定がない敵タイプは常に最も細かく描画する
+	const EnemyLodSettings kDefaultLodSettings = [] {
+		EnemyLodSettings settings;
+		settings.reducedScreenHeight = 0.0f;
+		settings.impostorScreenHeight = 0.0f;
+		return settings;
+	}();
+
+	// ビルボード用の画像の設定
+	constexpr int kImpostorGraphSize = 256;			// 画像の一辺
+	constexpr float kImpostorMargin = 1.05f;		// モデルの大きさに対する余白
+	constexpr float kImpostorCameraDist = 1000.0f;	// 焼き込み時のカメラの距離
 }
 
 // staticメンバー変数の実体を定義
 std::unordered_map<EnemyType, int> EnemyFactory::_modelHandles;
+std::unordered_map<EnemyType, int> EnemyFactory::_weaponModelHandles;
+std::unordered_map<EnemyType, ImpostorData> EnemyFactory::_impostors;
 
 void EnemyFactory::LoadResources()
 {
@@ -27,6 +59,18 @@ void EnemyFactory::LoadResources()
 		assert(handle != -1 && "モデルの読み込みに失敗");
 		_modelHandles[type] = handle;
 	}
+	// 武器も一度だけ読み込み、敵ごとに複製して使う
+	for (const auto& pair : kWeaponModelPaths) {
+		int handle = MV1LoadModel(pair.second.c_str());
+		assert(handle != -1 && "武器モデルの読み込みに失敗");
+		_weaponModelHandles[pair.first] = handle;
+	}
+	// 詳細度の設定で使用する敵はビルボード用の画像を焼き込む
+	for (const auto& pair : kLodSettings) {
+		auto it = _modelHandles.find(pair.first);
+		if (it == _modelHandles.end()) continue;
+		_impostors[pair.first] = BakeImpostor(it->second);
+	}
 }
 
 void EnemyFactory::ReleaseResources()
@@ -36,12 +80,97 @@ void EnemyFactory::ReleaseResources()
 		MV1DeleteModel(pair.second);
 	}
 	_modelHandles.clear();
+	for (const auto& pair : _weaponModelHandles) {
+		MV1DeleteModel(pair.second);
+	}
+	_weaponModelHandles.clear();
+	for (const auto& pair : _impostors) {
+		DeleteGraph(pair.second.graphHandle);
+	}
+	_impostors.clear();
+}
+
+int EnemyFactory::DuplicateWeaponModel(EnemyType type)
+{
+	auto it = _weaponModelHandles.find(type);
+	assert(it != _weaponModelHandles.end() && "要求された敵タイプの武器モデルが読み込まれていない");
+	int duplicatedHandle = MV1DuplicateModel(it->second);
+	assert(duplicatedHandle != -1 && "武器モデルの複製に失敗");
+	return duplicatedHandle;
+}
+
+int EnemyFactory::GetWeaponSourceModel(EnemyType type)
+{
+	auto it = _weaponModelHandles.find(type);
+	if (it == _weaponModelHandles.end()) return -1;
+	return it->second;
+}
+
+const EnemyLodSettings& EnemyFactory::GetLodSettings(EnemyType type)
+{
+	auto it = kLodSettings.find(type);
+	if (it == kLodSettings.end()) return kDefaultLodSettings;
+	return it->second;
+}
+
+const ImpostorData* EnemyFactory::GetImpostor(EnemyType type)
+{
+	auto it = _impostors.find(type);
+	if (it == _impostors.end()) return nullptr;
+	return &it->second;
+}
+
+ImpostorData EnemyFactory::BakeImpostor(int modelHandle)
+{
+	ImpostorData impostor;
+
+	// 待機中の姿で焼き込むため最初のアニメーションの先頭を適用する
+	int attachNo = -1;
+	if (MV1GetAnimNum(modelHandle) > 0) {
+		attachNo = MV1AttachAnim(modelHandle, 0);
+		MV1SetAttachAnimTime(modelHandle, attachNo, 0.0f);
+	}
+	MV1SetPosition(modelHandle, VGet(0.0f, 0.0f, 0.0f));
+
+	// モデルの大きさを求める
+	MV1SetupReferenceMesh(modelHandle, -1, TRUE);
+	MV1RefreshReferenceMesh(modelHandle, -1, TRUE);
+	const MV1_REF_POLYGONLIST ref = MV1GetReferenceMesh(modelHandle, -1, TRUE);
+	const VECTOR minPos = ref.MinPosition;
+	const VECTOR maxPos = ref.MaxPosition;
+	MV1TerminateReferenceMesh(modelHandle, -1, TRUE);
+
+	const float width = std::max<float>(maxPos.x - minPos.x, maxPos.z - minPos.z);
+	const float height = maxPos.y - minPos.y;
+	impostor.size = std::max<float>(width, height) * kImpostorMargin;
+	const VECTOR center = VGet(
+		(minPos.x + maxPos.x) * 0.5f, (minPos.y + maxPos.y) * 0.5f, (minPos.z + maxPos.z) * 0.5f);
+	impostor.bottom = center.y - impostor.size * 0.5f;
+
+	impostor.graphHandle = MakeScreen(kImpostorGraphSize, kImpostorGraphSize, true);
+	assert(impostor.graphHandle >= 0 && "ビルボード用の画像の作成に失敗");
+	FillGraph(impostor.graphHandle, 0, 0, 0, 0);
+
+	// モデルは-Z方向が正面のため、-Z側から正射影で描画する
+	const int prevScreen = GetDrawScreen();
+	SetDrawScreen(impostor.graphHandle);
+	SetCameraNearFar(1.0f, kImpostorCameraDist * 2.0f);
+	SetupCamera_Ortho(impostor.size);
+	SetCameraPositionAndTarget_UpVecY(
+		VGet(center.x, center.y, center.z - kImpostorCameraDist), center);
+	MV1DrawModel(modelHandle);
+	// 描画先を戻す(カメラの設定は描画先の変更で初期化される)
+	SetDrawScreen(prevScreen);
+
+	if (attachNo != -1) MV1DetachAnim(modelHandle, attachNo);
+
+	return impostor;
 }
 
 std::shared_ptr<EnemyBase> EnemyFactory::CreateAndRegister(
 	EnemyType type,
 	const Vector3& position,
-	std::weak_ptr<Player> player,
+	Handle<Player> player,
 	std::weak_ptr<Physics> physics)
 {
 	std::shared_ptr<EnemyBase> newEnemy = nullptr;
@@ -80,6 +209,8 @@ std::shared_ptr<EnemyBase> EnemyFactory::CreateAndRegister(
 
 	// 生成した敵の初期化
 	if (newEnemy) {
+		// 描画をまとめる単位として複製元を設定
+		newEnemy->SetSourceModels(it->second, GetWeaponSourceModel(type));
 		// 位置設定
 		newEnemy->SetPos(position);
 		// 派生先のInitを呼び出す
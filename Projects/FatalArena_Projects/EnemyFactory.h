@@ -3,6 +3,8 @@
 #include <memory>
 #include <unordered_map>
 #include "Vector3.h"
+#include "Handle.h"
+#include "EnemyLod.h"
 
 class EnemyBase;
 class Player;
@@ -34,12 +36,44 @@ public:
 	static std::shared_ptr<EnemyBase> CreateAndRegister(
 		EnemyType type,
 		const Vector3& position,
-		std::weak_ptr<Player> player,
+		Handle<Player> player,
 		std::weak_ptr<Physics> physics
 	);
 
+	/// <summary>
+	/// 指定の敵タイプの武器モデルを複製して返す
+	/// </summary>
+	static int DuplicateWeaponModel(EnemyType type);
+
+	/// <summary>
+	/// 指定の敵タイプの武器モデルの複製元を返す
+	/// (武器を持たない場合は-1)
+	/// </summary>
+	static int GetWeaponSourceModel(EnemyType type);
+
+	/// <summary>
+	/// 指定の敵タイプの詳細度の設定を返す
+	/// </summary>
+	static const EnemyLodSettings& GetLodSettings(EnemyType type);
+
+	/// <summary>
+	/// 指定の敵タイプの焼き込んだビルボード用の画像を返す
+	/// (焼き込んでいない場合はnullptr)
+	/// </summary>
+	static const ImpostorData* GetImpostor(EnemyType type);
+
 private:
+	/// <summary>
+	/// モデルを正面から描画した画像を作成する
+	/// </summary>
+	static ImpostorData BakeImpostor(int modelHandle);
+
 	// モデルハンドルを管理するためのコンテナ
 	// キー:敵の種類, 値:モデルハンドル
 	static std::unordered_map<EnemyType, int> _modelHandles;
+	// 武器モデルの複製元
+	// キー:敵の種類, 値:モデルハンドル
+	static std::unordered_map<EnemyType, int> _weaponModelHandles;
+	// 遠くで使用するビルボード用の画像
+	static std::unordered_map<EnemyType, ImpostorData> _impostors;
 };
\ No newline at end of file
@@ -0,0 +1,37 @@
+﻿#include "EnemyLod.h"
+#include "Statistics.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+	// 画面上の高さを求める際の最小の距離
+	constexpr float kMinDistance = 1.0f;
+}
+
+float EnemyLod::CalcScreenHeight(float worldHeight, float distance, float fovY)
+{
+	const float dist = std::max<float>(distance, kMinDistance);
+	return worldHeight * Statistics::kScreenHeight / (2.0f * dist * std::tan(fovY * 0.5f));
+}
+
+ModelLod EnemyLod::Select(ModelLod current, float screenHeight, const EnemyLodSettings& settings)
+{
+	// 各詳細度とその次の詳細度との境界
+	const float thresholds[kModelLodNum - 1] = {
+		settings.reducedScreenHeight,
+		settings.impostorScreenHeight,
+	};
+	const float up = 1.0f + settings.hysteresis;
+	const float down = 1.0f - settings.hysteresis;
+
+	int level = static_cast<int>(current);
+	// 十分に大きく映っていれば細かくする
+	while (level > 0 && screenHeight >= thresholds[level - 1] * up) {
+		--level;
+	}
+	// 十分に小さく映っていれば粗くする
+	while (level < kModelLodNum - 1 && screenHeight < thresholds[level] * down) {
+		++level;
+	}
+	return static_cast<ModelLod>(level);
+}
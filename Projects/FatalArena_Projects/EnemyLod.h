@@ -0,0 +1,60 @@
+﻿#pragma once
+#include <array>
+
+/// <summary>
+/// 敵のモデルの詳細度
+/// </summary>
+enum class ModelLod {
+	Full,		// モデルを毎フレーム更新して描画する
+	Reduced,	// アニメーションと武器の追従を間引く
+	Impostor,	// 焼き込んだ画像のビルボードで描画する
+	Num,
+};
+
+constexpr int kModelLodNum = static_cast<int>(ModelLod::Num);
+
+/// <summary>
+/// 敵の種類ごとの詳細度の設定
+/// </summary>
+struct EnemyLodSettings
+{
+	// 画面上の高さ(ピクセル)がこれを下回るとReducedにする
+	float reducedScreenHeight = 0.0f;
+	// 画面上の高さ(ピクセル)がこれを下回るとImpostorにする
+	float impostorScreenHeight = 0.0f;
+	// 切り替えの境界に持たせる幅(比率)
+	// 境界付近で毎フレーム切り替わらないようにする
+	float hysteresis = 0.0f;
+
+	// 詳細度ごとのアニメーションの反映間隔
+	std::array<int, kModelLodNum> animInterval = { 1, 1, 1 };
+	// 詳細度ごとに武器を描画するか
+	std::array<bool, kModelLodNum> isDrawWeapon = { true, true, true };
+};
+
+/// <summary>
+/// 焼き込んだビルボード用の画像
+/// 大きさはモデルの座標系での値
+/// </summary>
+struct ImpostorData
+{
+	int graphHandle = -1;
+	float size = 0.0f;		// 正方形の一辺
+	float bottom = 0.0f;	// 原点から見た画像の下端の高さ
+};
+
+namespace EnemyLod {
+	/// <summary>
+	/// カメラからの距離と画角から、画面上の高さ(ピクセル)を求める
+	/// </summary>
+	/// <param name="worldHeight">ワールド上の高さ</param>
+	/// <param name="distance">カメラからの距離</param>
+	/// <param name="fovY">縦の画角(ラジアン)</param>
+	float CalcScreenHeight(float worldHeight, float distance, float fovY);
+
+	/// <summary>
+	/// 画面上の高さから詳細度を選ぶ
+	/// 現在の詳細度から切り替えるには、境界を設定の幅以上超える必要がある
+	/// </summary>
+	ModelLod Select(ModelLod current, float screenHeight, const EnemyLodSettings& settings);
+}
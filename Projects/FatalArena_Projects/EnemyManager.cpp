@@ -5,41 +5,162 @@
 #include "Calculation.h"
 #include "Player.h"
 #include "Physics.h"
+#include "Camera.h"
+#include "Arena.h"
+#include "JobSystem.h"
+#include "RenderSnapshot.h"
+#include "Random.h"
+#include "Input.h"
+#include "SnapshotArchive.h"
 #include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <DxLib.h>
 
+namespace {
+    // アニメーションLODの設定
+    // (視界内の場合は詳細度ごとの設定に従う)
+    constexpr int kAnimLodIntervalHidden = 4;       // 視界外
+
+    // 視界判定と画面上の大きさの計算に使用する敵の大まかな大きさ
+    constexpr float kAnimLodBoundsRadius = 250.0f;
+    constexpr float kAnimLodBoundsHeight = 600.0f;
+    // 上の大きさの箱を囲む境界球
+    const float kAnimLodSphereRadius = std::sqrt(
+        kAnimLodBoundsRadius * kAnimLodBoundsRadius * 2.0f +
+        kAnimLodBoundsHeight * kAnimLodBoundsHeight * 0.25f);
+
+    // 空間インデックスの設定
+    constexpr float kGridMargin = 500.0f;           // アリーナの外側に持たせる余裕
+    constexpr float kGridCellSize = 400.0f;         // セル一辺の長さ
+
+    // フローフィールドの設定
+    constexpr float kFlowFieldCellSize = 150.0f;    // セル一辺の長さ
+
+    // 分離の設定
+    constexpr float kSeparationRadius = 500.0f;     // この距離以内の敵から離れようとする
+    constexpr float kSeparationWeight = 0.6f;       // 進行方向に対する分離の強さ
+    constexpr float kMaxSeparation = 0.5f;          // 分離の強さの上限(進行方向の長さ1を下回るようにする)
+
+    // 1フレームに敵の思考へ使える時間(マイクロ秒)
+    constexpr long long kThinkBudgetUs = 500;
+    // リプレイの記録・再生中に1フレームで思考させる数
+    // (時間で制限すると実行速度によって結果が変わるため)
+    constexpr int kReplayThinkCount = 16;
+
+    // 並列更新で1つの作業としてまとめる敵の数
+    constexpr int kUpdateChunkSize = 8;
+}
+
+EnemyManager::UpdateStats EnemyManager::_updateStats;
+
 EnemyManager::EnemyManager() :
     _enemies(),
+    _grid(Arena::GetArenaRadius() + kGridMargin, kGridCellSize),
+    _flowField(Arena::GetArenaRadius(), kFlowFieldCellSize),
+    _neighborBuffer(),
+    _spawnAngles(),
+    _spawnRadii(),
+    _aiScheduler(kThinkBudgetUs),
+    _commandBuffers(),
     _player(),
-    _physics()
+    _physics(),
+    _camera(nullptr),
+    _lodFrustum(),
+    _lodBoundsX(),
+    _lodBoundsY(),
+    _lodBoundsZ(),
+    _lodBoundsRadius(),
+    _lodVisible(),
+    _handle()
 {
-    // 処理なし
+    // 他のオブジェクトから参照できるよう登録する
+    _handle = SlotMap<EnemyManager>::GetInstance().Insert(this);
 }
 
 EnemyManager::~EnemyManager()
 {
-    // 処理なし
+    SlotMap<EnemyManager>::GetInstance().Remove(_handle);
 }
 
-void EnemyManager::Init(std::weak_ptr<Player> player, std::weak_ptr<Physics> physics)
+void EnemyManager::Init(std::weak_ptr<Player> player, std::weak_ptr<Physics> physics, std::weak_ptr<Camera> camera)
 {
-    _player = player;
+    assert(!player.expired() && "プレイヤーが存在しない");
+    _player = player.lock()->GetHandle();
     _physics = physics;
+    _camera = camera.lock().get();
+
+    if (Input::GetInstance().IsReplayActive()) {
+        _aiScheduler.SetFixedThinkCount(kReplayThinkCount);
+    }
 }
 
 void EnemyManager::Update()
+{
+    const LONGLONG startTime = GetNowHiPerformanceCount();
+
+    // 詳細度とアニメーションの反映間隔を決めてから更新する
+    UpdateLod();
+    // 追跡時に向かう方向を決めてから更新する
+    UpdateSteering();
+
+    // 予算内で各敵に思考(状態遷移の判断)させる
+    if (_player.IsValid())
+    {
+        _aiScheduler.Update(_player->GetPos());
+    }
+    // 思考で記録された副作用を実行する
+    FlushCommands();
+
+    // 各敵の状態の更新を塊ごとに並列に行う
+    // (副作用は塊ごとのバッファに記録され、DxLibや共有物には触れない)
+    const int enemyNum = static_cast<int>(_enemies.size());
+    const int chunkNum = (enemyNum + kUpdateChunkSize - 1) / kUpdateChunkSize;
+    if (static_cast<int>(_commandBuffers.size()) < chunkNum)
+    {
+        _commandBuffers.resize(chunkNum);
+    }
+    JobSystem::GetInstance().ParallelFor(enemyNum, kUpdateChunkSize,
+        [this](int begin, int end) {
+            EnemyCommandBuffer& commands = _commandBuffers[begin / kUpdateChunkSize];
+            for (int i = begin; i < end; ++i)
+            {
+                _enemies[i]->UpdateCompute(commands);
+            }
+        });
+
+    // 記録された副作用を塊の順に実行する
+    // (スレッドの割り当てに関係なく、常に敵の並び順で実行される)
+    for (int chunk = 0; chunk < chunkNum; ++chunk)
+    {
+        _commandBuffers[chunk].Execute();
+    }
+
+    // モデルへの反映はDxLibを使用するためメインスレッドで行う
+    for (int i = 0; i < enemyNum; ++i)
+    {
+        _enemies[i]->ApplyModel();
+        // 空間インデックスの位置を更新
+        _grid.Update(i, _enemies[i]->GetPos());
+    }
+
+    _updateStats.totalUs += GetNowHiPerformanceCount() - startTime;
+    _updateStats.enemyFrames += enemyNum;
+}
+
+void EnemyManager::FlushCommands()
 {
     for (auto& enemy : _enemies)
     {
-        enemy->Update();
+        enemy->ExecuteCommands();
     }
 }
 
-void EnemyManager::Draw()
+void EnemyManager::WriteSnapshot(RenderSnapshot& snapshot) const
 {
     for (const auto& enemy : _enemies)
     {
-        enemy->Draw();
+        enemy->WriteSnapshot(snapshot);
     }
 }
 
@@ -48,13 +169,16 @@ void EnemyManager::SpawnEnemies(const std::vector<SpawnInfo>& spawnInfoList)
     // 死亡済みの敵をリストから削除
     CleanupDefeatedEnemies();
 
+    RandomStream& random = RandomService::GetInstance().GetStream(RandomStreamType::EnemySpawn);
     for (const auto& info : spawnInfoList)
     {
+        // spawnRadius内のランダムな位置を、グループの分だけまとめて計算
+        random.FillFloat(_spawnAngles, info.count, 0.0f, Calc::ToRadian(360.0f));
+        random.FillFloat(_spawnRadii, info.count, 0.0f, info.spawnRadius);
         for (int i = 0; i < info.count; ++i)
         {
-            // spawnRadius内にランダムな位置を計算
-            float angle = Calc::ToRadian(static_cast<float>(GetRand(360)));
-            float radius = static_cast<float>(GetRand(static_cast<int>(info.spawnRadius)));
+            float angle = _spawnAngles[i];
+            float radius = _spawnRadii[i];
             Position3 spawnPos = info.basePosition + Vector3(cos(angle) * radius, 0.0f, sin
             (angle) *radius);
 
@@ -62,6 +186,7 @@ void EnemyManager::SpawnEnemies(const std::vector<SpawnInfo>& spawnInfoList)
             auto newEnemy = EnemyFactory::CreateAndRegister(info.type, spawnPos, _player,
                 _physics);
             _enemies.emplace_back(newEnemy);
+            _grid.Update(static_cast<int>(_enemies.size()) - 1, newEnemy->GetPos());
         }
     }
 }
@@ -83,33 +208,96 @@ const std::vector<std::shared_ptr<EnemyBase>>& EnemyManager::GetEnemies() const
     return _enemies;
 }
 
-std::weak_ptr<EnemyBase> EnemyManager::GetNearestEnemy(Position3 pos, EnemyType type, bool isDead)
+std::weak_ptr<EnemyBase> EnemyManager::GetNearestEnemy(const Position3& pos, EnemyType type, bool isDead,
+    float maxDist) const
 {
     // 返す敵のタイプ
     EnemyType retType = type;
-    std::weak_ptr<EnemyBase> ret;
     if (retType == EnemyType::TypeNum) retType = EnemyType::None;
-    float nearestDist = FLT_MAX;
-
-    for (const std::shared_ptr<EnemyBase> enemy : _enemies) {
-        // 死んでいる敵を除外するかつ
-        // 敵が死んでいるなら
-        if (!isDead && !enemy->IsAlive()) continue;
-        // タイプがNoneもしくは
-        // タイプが一致しているなら
-        if (retType == EnemyType::None ||
-            enemy->GetType() == retType) {
-            // 距離を測り既存値以内なら
-            float dist = (enemy->GetPos() - pos).Magnitude();
-            if (dist < nearestDist) {
-                // 情報を更新する
-                nearestDist = dist;
-                ret = enemy;
+
+    const int index = _grid.QueryNearest(pos, maxDist,
+        [this, retType, isDead](int id) {
+            const auto& enemy = _enemies[id];
+            // 死んでいる敵を除外するかつ
+            // 敵が死んでいるなら
+            if (!isDead && !enemy->IsAlive()) return false;
+            // タイプがNoneもしくは
+            // タイプが一致しているなら
+            return (retType == EnemyType::None || enemy->GetType() == retType);
+        });
+
+    if (index < 0) return std::weak_ptr<EnemyBase>();
+    return _enemies[index];
+}
+
+void EnemyManager::GetEnemiesInRadius(const Position3& pos, float radius, std::vector<int>& outIndices) const
+{
+    _grid.QueryRadius(pos, radius, outIndices,
+        [this](int id) { return _enemies[id]->IsAlive(); });
+}
+
+const AIScheduler::Metrics& EnemyManager::GetAIMetrics() const
+{
+    return _aiScheduler.GetMetrics();
+}
+
+void EnemyManager::SaveSnapshot(SnapshotWriter& writer) const
+{
+    writer.Write(static_cast<int>(_enemies.size()));
+    for (const auto& enemy : _enemies)
+    {
+        writer.Write(enemy->GetType());
+        enemy->SaveSnapshot(writer);
+    }
+}
+
+void EnemyManager::LoadSnapshot(SnapshotReader& reader)
+{
+    // 物理からの除外が残っていると登録状態の判断がずれるため、先に実行しておく
+    FlushCommands();
+
+    int enemyNum = 0;
+    reader.Read(enemyNum);
+    if (!reader.IsValid()) return;
+
+    for (int i = 0; i < enemyNum; ++i)
+    {
+        EnemyType type = EnemyType::None;
+        reader.Read(type);
+        if (!reader.IsValid()) break;
+
+        // 同じ位置に同じ種類の敵がいれば使い回す
+        // (モデルの複製や武器の読み込みを避ける)
+        const bool isReusable = (i < static_cast<int>(_enemies.size()) &&
+            _enemies[i]->GetType() == type);
+        if (!isReusable)
+        {
+            auto newEnemy = EnemyFactory::CreateAndRegister(type, Vector3(), _player, _physics);
+            if (i < static_cast<int>(_enemies.size()))
+            {
+                _enemies[i]->Discard();
+                _enemies[i] = newEnemy;
+            }
+            else
+            {
+                _enemies.emplace_back(newEnemy);
             }
         }
+        _enemies[i]->LoadSnapshot(reader);
+    }
+
+    // 保存時より多い分は破棄する
+    for (int i = enemyNum; i < static_cast<int>(_enemies.size()); ++i)
+    {
+        _enemies[i]->Discard();
+    }
+    if (static_cast<int>(_enemies.size()) > enemyNum)
+    {
+        _enemies.erase(_enemies.begin() + enemyNum, _enemies.end());
     }
 
-    return ret;
+    // 添字と位置が変わったので作り直す
+    RebuildSpatialGrid();
 }
 
 void EnemyManager::CleanupDefeatedEnemies()
@@ -122,4 +310,130 @@ void EnemyManager::CleanupDefeatedEnemies()
             }),
         _enemies.end()
     );
+
+    // 添字が変わったので作り直す
+    RebuildSpatialGrid();
+}
+
+void EnemyManager::RebuildSpatialGrid()
+{
+    _grid.Clear();
+    for (int i = 0; i < static_cast<int>(_enemies.size()); ++i)
+    {
+        _grid.Update(i, _enemies[i]->GetPos());
+    }
+}
+
+void EnemyManager::UpdateSteering()
+{
+    const Player* player = _player.Get();
+    if (player == nullptr) return;
+    const Position3 playerPos = player->GetPos();
+
+    // プレイヤーのセルが変わっていれば数フレームかけて計算し直す
+    _flowField.Update(playerPos);
+
+    for (int i = 0; i < static_cast<int>(_enemies.size()); ++i)
+    {
+        const auto& enemy = _enemies[i];
+        if (enemy->GetState() != EnemyBase::State::Active) continue;
+        const Position3 pos = enemy->GetPos();
+
+        // フローフィールドの方向
+        // (プレイヤーと同じセルにいる場合などは直接向かう)
+        Vector3 steering = _flowField.GetDirection(pos);
+        if (steering.SqrMagnitude() == 0.0f)
+        {
+            steering = playerPos - pos;
+            steering.y = 0.0f;
+            if (steering.SqrMagnitude() == 0.0f)
+            {
+                enemy->SetSteeringDir(Vector3());
+                continue;
+            }
+            steering.Normalized();
+        }
+
+        // 近くの敵から離れる方向を加える
+        // (近いほど強く押し出すため、距離の2乗で割る)
+        GetEnemiesInRadius(pos, kSeparationRadius, _neighborBuffer);
+        Vector3 separation;
+        for (int id : _neighborBuffer)
+        {
+            if (id == i) continue;
+            Vector3 away = pos - _enemies[id]->GetPos();
+            away.y = 0.0f;
+            const float distSq = away.SqrMagnitude();
+            if (distSq == 0.0f) continue;
+            separation += away / distSq;
+        }
+        separation *= kSeparationRadius * kSeparationWeight;
+
+        // 進行方向と逆向きの成分は取り除き、押し戻されて進めなくならないようにする
+        const float backward = Dot(separation, steering);
+        if (backward < 0.0f)
+        {
+            separation -= steering * backward;
+        }
+        // 密集していても進行方向が分離に負けないよう、強さを制限する
+        const float separationSq = separation.SqrMagnitude();
+        if (separationSq > kMaxSeparation * kMaxSeparation)
+        {
+            separation *= kMaxSeparation / std::sqrt(separationSq);
+        }
+        steering += separation;
+        steering.Normalized();
+
+        enemy->SetSteeringDir(steering);
+    }
+}
+
+void EnemyManager::UpdateLod()
+{
+    if (_camera == nullptr) return;
+    const Position3 cameraPos = _camera->GetPos();
+    const float viewAngle = _camera->GetViewAngle();
+
+    // 全ての敵の視界判定をまとめて行う
+    // (カメラの更新後に呼ばれるため、現在のカメラ設定で判定できる)
+    const int enemyNum = static_cast<int>(_enemies.size());
+    _lodBoundsX.resize(enemyNum);
+    _lodBoundsY.resize(enemyNum);
+    _lodBoundsZ.resize(enemyNum);
+    _lodBoundsRadius.resize(enemyNum);
+    _lodVisible.resize(enemyNum);
+    for (int i = 0; i < enemyNum; ++i)
+    {
+        const Position3 pos = _enemies[i]->GetPos();
+        _lodBoundsX[i] = pos.x;
+        _lodBoundsY[i] = pos.y + kAnimLodBoundsHeight * 0.5f;
+        _lodBoundsZ[i] = pos.z;
+        _lodBoundsRadius[i] = kAnimLodSphereRadius;
+    }
+    _camera->BuildViewFrustum(_lodFrustum);
+    _lodFrustum.CullSpheres(_lodBoundsX.data(), _lodBoundsY.data(), _lodBoundsZ.data(),
+        _lodBoundsRadius.data(), enemyNum, _lodVisible.data());
+
+    for (int i = 0; i < enemyNum; ++i)
+    {
+        const auto& enemy = _enemies[i];
+        const Position3 pos = enemy->GetPos();
+        const bool isHidden = (_lodVisible[i] == 0);
+
+        // 画面上の高さから詳細度を選ぶ
+        const EnemyLodSettings& settings = EnemyFactory::GetLodSettings(enemy->GetType());
+        const float screenHeight = EnemyLod::CalcScreenHeight(
+            kAnimLodBoundsHeight, (pos - cameraPos).Magnitude(), viewAngle);
+        const ModelLod lod = EnemyLod::Select(enemy->GetModelLod(), screenHeight, settings);
+        enemy->SetModelLod(lod);
+
+        int interval = settings.animInterval[static_cast<int>(lod)];
+        if (isHidden)
+        {
+            interval = std::max(interval, kAnimLodIntervalHidden);
+        }
+
+        // 反映するフレームが同じにならないよう、敵ごとにずらす
+        enemy->SetAnimLod(interval, i);
+    }
 }
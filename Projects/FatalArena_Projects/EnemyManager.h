@@ -1,12 +1,23 @@
 ﻿#pragma once
 #include "Vector3.h"
+#include "SpatialGrid.h"
+#include "FlowField.h"
+#include "AIScheduler.h"
+#include "EnemyCommandBuffer.h"
+#include "ViewFrustum.h"
+#include "Handle.h"
 #include <vector>
 #include <memory>
+#include <cfloat>
 
 // 前方宣言
 class EnemyBase;
 class Player;
 class Physics;
+class Camera;
+struct RenderSnapshot;
+class SnapshotWriter;
+class SnapshotReader;
 struct SpawnInfo;
 struct WaveData;
 enum class EnemyType;
@@ -14,13 +25,23 @@ enum class EnemyType;
 class EnemyManager
 {
 public:
+	/// <summary>
+	/// 全てのEnemyManagerの更新にかかった時間の合計
+	/// (リプレイの終了時に、敵1体1フレームあたりの時間を出力するために使う)
+	/// </summary>
+	struct UpdateStats
+	{
+		long long totalUs = 0;		// Update()にかかった時間(マイクロ秒)
+		long long enemyFrames = 0;	// 更新した敵の数をフレームごとに足したもの
+	};
+
 	EnemyManager();
 	~EnemyManager();
 
 	/// <summary>
 	/// 初期化
 	/// </summary>
-	void Init(std::weak_ptr<Player> player, std::weak_ptr<Physics> physics);
+	void Init(std::weak_ptr<Player> player, std::weak_ptr<Physics> physics, std::weak_ptr<Camera> camera);
 
 	/// <summary>
 	/// 更新
@@ -28,9 +49,17 @@ public:
 	void Update();
 
 	/// <summary>
-	/// 描画
+	/// 各敵が被弾時や思考時に記録した副作用(効果音、スコア加算、物理からの除外)を
+	/// 敵の並び順に実行する
+	/// 被弾は物理演算の中で起きるため、物理演算の後にも呼ぶ
+	/// </summary>
+	void FlushCommands();
+
+	/// <summary>
+	/// 描画に必要な情報をスナップショットに書き込む
+	/// (描画はスナップショットから行う)
 	/// </summary>
-	void Draw();
+	void WriteSnapshot(RenderSnapshot& snapshot) const;
 
 	/// <summary>
 	/// 指定された情報に基づいて敵を生成する
@@ -57,8 +86,39 @@ public:
 	/// <param name="pos">比較位置</param>
 	/// <param name="type">候補</param>
 	/// <param name="isDead">死亡している敵も判定に含めるか</param>
+	/// <param name="maxDist">探索する最大距離</param>
 	/// <returns></returns>
-	std::weak_ptr<EnemyBase> GetNearestEnemy(Position3 pos, EnemyType type, bool isDead);
+	std::weak_ptr<EnemyBase> GetNearestEnemy(const Position3& pos, EnemyType type, bool isDead,
+		float maxDist = FLT_MAX) const;
+
+	/// <summary>
+	/// 指定された位置から半径内にいる敵を返す(生存している敵のみ)
+	/// </summary>
+	/// <param name="outIndices">結果(GetEnemies()の添字)</param>
+	void GetEnemiesInRadius(const Position3& pos, float radius, std::vector<int>& outIndices) const;
+
+	/// <summary>
+	/// 敵の思考の計測結果を返す
+	/// </summary>
+	const AIScheduler::Metrics& GetAIMetrics() const;
+
+	/// <summary>
+	/// 更新にかかった時間の合計を返す
+	/// </summary>
+	static const UpdateStats& GetUpdateStats() { return _updateStats; }
+
+	/// <summary>
+	/// 全ての敵の種類と状態を書き込む・読み込む
+	/// 読み込み時は同じ位置に同じ種類の敵がいれば使い回し、
+	/// 足りない場合のみ新たに生成する
+	/// </summary>
+	void SaveSnapshot(SnapshotWriter& writer) const;
+	void LoadSnapshot(SnapshotReader& reader);
+
+	/// <summary>
+	/// 自身を参照するためのHandleを返す
+	/// </summary>
+	Handle<EnemyManager> GetHandle() const { return _handle; }
 
 private:
 	/// <summary>
@@ -66,10 +126,62 @@ private:
 	/// </summary>
 	void CleanupDefeatedEnemies();
 
+	/// <summary>
+	/// カメラから見た画面上の大きさと視界内かどうかで
+	/// 各敵のモデルの詳細度とアニメーションLOD(モデルへの反映間隔)を決める
+	/// </summary>
+	void UpdateLod();
+
+	/// <summary>
+	/// 空間インデックスを作り直す
+	/// (敵リストの添字が変わった際に呼ぶ)
+	/// </summary>
+	void RebuildSpatialGrid();
+
+	/// <summary>
+	/// フローフィールドと周囲の敵との分離から
+	/// 各敵の追跡時に向かう方向を決める
+	/// </summary>
+	void UpdateSteering();
+
 private:
 	std::vector<std::shared_ptr<EnemyBase>> _enemies;
 
+	// 敵の位置の空間インデックス(idは_enemiesの添字)
+	SpatialGrid _grid;
+
+	// プレイヤーへ向かう進行方向の場(全ての敵で共有する)
+	FlowField _flowField;
+	// 分離の計算で使用する近傍の敵(毎フレームの確保を避けるため保持する)
+	std::vector<int> _neighborBuffer;
+	// 生成位置の計算に使う乱数(まとめて生成して使い回す)
+	std::vector<float> _spawnAngles;
+	std::vector<float> _spawnRadii;
+
+	// 敵の思考を複数フレームに分散する
+	AIScheduler _aiScheduler;
+
+	// 並列更新する敵の塊ごとの副作用の記録先
+	std::vector<EnemyCommandBuffer> _commandBuffers;
+
 	// 敵を生成する際に必要な情報
-	std::weak_ptr<Player> _player;
+	Handle<Player> _player;
 	std::weak_ptr<Physics> _physics;
+
+	// 詳細度の判定に使用する
+	// (シーンが所有し敵の管理より長く生存するため、毎フレームlockしないよう生のポインタで持つ)
+	const Camera* _camera;
+	// 視界判定に使用する視錐台と、各敵の境界球・結果(毎フレームの確保を避けるため保持する)
+	ViewFrustum _lodFrustum;
+	std::vector<float> _lodBoundsX;
+	std::vector<float> _lodBoundsY;
+	std::vector<float> _lodBoundsZ;
+	std::vector<float> _lodBoundsRadius;
+	std::vector<uint8_t> _lodVisible;
+
+	// 自身を参照するためのHandle
+	Handle<EnemyManager> _handle;
+
+	// 更新にかかった時間の合計(シーンをまたいで数える)
+	static UpdateStats _updateStats;
 };
@@ -7,6 +7,9 @@
 #include "Rigidbody.h"
 #include "Calculation.h"
 #include "SoundManager.h"
+#include "EnemyCommandBuffer.h"
+#include "RenderSnapshot.h"
+#include "SnapshotArchive.h"
 #include <cassert>
 
 #include <DxLib.h>
@@ -26,6 +29,7 @@ namespace {
 	constexpr int kAddScore = 1000;								// 加算スコア
 	
 	constexpr float kChaseDist = 1200.0f;						// 追い始める距離
+	constexpr float kChaseDistSq = kChaseDist * kChaseDist;		// (距離の比較は2乗で行う)
 
 	// 当たり判定のパラメータ
 	const float kColRadius = 60.0f * kModelScale.x;		// 半径
@@ -46,7 +50,6 @@ namespace {
 	
 	// 武器データ
 	const std::wstring kHandFrameName = L"mixamorig:RightHandIndex1";
-	const std::wstring kWeaponModelPath = L"data/model/weapon/EnemyWeapon.mv1";
 
 	const Vector3 kWeaponOffsetPos = Vector3Up();					// 位置補正
 	const Vector3 kWeaponOffsetScale = Vector3(1.0f, 1.3f, 2.0f) * 1.2f;	// 拡縮補正
@@ -64,13 +67,29 @@ namespace {
 	// 武器の当たり判定を切り替えるタイミング
 	constexpr float kAttackColStart = 0.1f;	// 当たり判定を付け始める
 	constexpr float kAttackColEnd = 0.6f;	// 当たり判定を切る
+
+	// 視界内判定に使用する境界球
+	// (振り回す武器を含めるため、武器の長さ分大きくする)
+	const Vector3 kCullBoundsOffset = Vector3Up() * (kColHeight * 0.5f);
+	const float kCullBoundsRadius = kColHeight * 0.5f + kWeaponDist;
 }
 
+const EnemyNormal::UpdateFunc_t EnemyNormal::kUpdateStateTable[kUpdateStateNum] = {
+	&EnemyNormal::UpdateSpawning,
+	&EnemyNormal::UpdateIdle,
+	&EnemyNormal::UpdateChase,
+	&EnemyNormal::UpdateAttack,
+	&EnemyNormal::UpdateDamage,
+	&EnemyNormal::UpdateDeath,
+};
+
 EnemyNormal::EnemyNormal(int modelHandle) :
 	EnemyBase(CapsuleColliderDesc(kColRadius, kColOffset),
 		kHitPoint, kAttackRange),
 	_nowUpdateState(&EnemyNormal::UpdateSpawning),
-	_weapon(std::make_unique<WeaponEnemy>())
+	_weapon(std::make_unique<WeaponEnemy>()),
+	_commands(nullptr),
+	_spawnProgress(0.0f)
 
 {
 	rigidbody->Init(true);
@@ -89,6 +108,14 @@ EnemyNormal::EnemyNormal(int modelHandle) :
 	// 最初のアニメーションを設定する
 	_animator->SetStartAnim(kAnimNameSpawn);
 
+	// 攻撃アニメーションのイベントを設定する
+	_animator->AddAnimEvent(kAnimNameAttack, 0.0f, Animator::EventType::SoundCue, static_cast<int>(SEType::EnemyAttack));
+	_animator->AddAnimEvent(kAnimNameAttack, kAttackColStart, Animator::EventType::HitboxOn);
+	_animator->AddAnimEvent(kAnimNameAttack, kAttackColEnd, Animator::EventType::HitboxOff);
+	// イベントを受け取る
+	_animator->SetEventHandler(
+		[this](const Animator::AnimEvent& animEvent) { OnAnimEvent(animEvent); });
+
 	//MV1SetScale(_animator->GetModelHandle(), kModelScale);
 
 	
@@ -99,14 +126,14 @@ EnemyNormal::~EnemyNormal()
 	// modelはanimator側で消している
 }
 
-void EnemyNormal::Init(std::weak_ptr<Player> player, std::weak_ptr<Physics> physics)
+void EnemyNormal::Init(Handle<Player> player, std::weak_ptr<Physics> physics)
 {
 	_player = player;
 
 	// 生成時にプレイヤーの方向を向く
-	if (!_player.expired()) {
+	if (_player.IsValid()) {
 		// プレイヤーへの方向ベクトル
-		Vector3 dirToPlayer = (_player.lock()->GetPos() - GetPos());
+		Vector3 dirToPlayer = (_player->GetPos() - GetPos());
 		if (dirToPlayer.SqrMagnitude() > 0.0f) {
 			// Y軸回転角度を計算
 			_rotAngle = atan2f(dirToPlayer.x, dirToPlayer.z);
@@ -118,9 +145,8 @@ void EnemyNormal::Init(std::weak_ptr<Player> player, std::weak_ptr<Physics> phys
 
 
 	// 武器の初期化
-	// モデル読み込み
-	int weaponModelHandle = MV1LoadModel(kWeaponModelPath.c_str());
-	assert(weaponModelHandle != -1 && "武器モデルの読み込みに失敗");
+	// (読み込み済みのモデルを複製する)
+	int weaponModelHandle = EnemyFactory::DuplicateWeaponModel(GetType());
 	// 武器を初期化
 	_weapon->Init(
 		weaponModelHandle,
@@ -144,27 +170,85 @@ void EnemyNormal::Init(std::weak_ptr<Player> player, std::weak_ptr<Physics> phys
 	WeaponUpdate();
 }
 
-void EnemyNormal::Update()
+void EnemyNormal::UpdateCompute(EnemyCommandBuffer& commands)
 {
-	_animator->Update();
+	// アニメーションイベントの副作用を記録できるようにする
+	_commands = &commands;
 
-	// 状態遷移確認
-	CheckStateTransition();
+	// 攻撃中は武器の位置と当たり判定のタイミングを正確に保つため
+	// LODに関係なく毎フレームアニメーションを反映する
+	if (_nowUpdateState == &EnemyNormal::UpdateAttack) {
+		_animator->SetApplyInterval(1);
+	}
+	else {
+		_animator->SetApplyInterval(_animLodInterval, _animLodPhase);
+	}
+	_animator->Advance();
+
+	// 状態遷移の確認はAISchedulerから呼ばれるThinkで行う
 
 	// 現在のステートに応じたUpdateが行われる
 	(this->*_nowUpdateState)();
 
-	WeaponUpdate();
+	_commands = nullptr;
+}
+
+void EnemyNormal::ApplyModel()
+{
+	_animator->ApplyToModel();
+
+	// 向きを適用
+	MV1SetRotationXYZ(_animator->GetModelHandle(), Vector3(0, _rotAngle + Calc::ToRadian(180.0f), 0));
+
+	// 出現中はスケールを適用
+	if (_nowUpdateState == &EnemyNormal::UpdateSpawning) {
+		MV1SetScale(_animator->GetModelHandle(), kModelScale * _spawnProgress);
+	}
+
+	// 武器を描画しない詳細度では、当たり判定を行う攻撃中以外は武器の追従を省く
+	const EnemyLodSettings& settings = EnemyFactory::GetLodSettings(GetType());
+	if (_nowUpdateState == &EnemyNormal::UpdateAttack ||
+		settings.isDrawWeapon[static_cast<int>(GetDrawLod())]) {
+		WeaponUpdate();
+	}
+}
+
+void EnemyNormal::WriteSnapshot(RenderSnapshot& snapshot) const
+{
+	// 当たり判定を行った後の位置で描画する
+	BoundingSphere bounds;
+	bounds.center = GetPos() + kCullBoundsOffset;
+	bounds.radius = kCullBoundsRadius;
+
+	const ModelLod lod = GetDrawLod();
+	if (lod == ModelLod::Impostor) {
+		// 焼き込んだ画像をモデルと同じ大きさで描画する
+		const ImpostorData* impostor = EnemyFactory::GetImpostor(GetType());
+		const Position3 bottom = GetPos() + Vector3Up() * (impostor->bottom * kModelScale.y);
+		snapshot.AddImpostor(impostor->graphHandle, bottom,
+			impostor->size * kModelScale.x, impostor->size * kModelScale.y, bounds);
+		return;
+	}
+
+	snapshot.AddModel(_animator->GetModelHandle(), GetPos(), bounds, _bodySourceHandle);
+	// 武器の位置はWeaponUpdateで設定済み
+	const EnemyLodSettings& settings = EnemyFactory::GetLodSettings(GetType());
+	if (settings.isDrawWeapon[static_cast<int>(lod)]) {
+		snapshot.AddModel(_weapon->GetModelHandle(), bounds, _weaponSourceHandle);
+	}
 }
 
-void EnemyNormal::Draw()
+ModelLod EnemyNormal::GetDrawLod() const
 {
-	// 当たり判定を行ってからモデルの位置を設定する
-	MV1SetPosition(_animator->GetModelHandle(), GetPos());
-	// モデルの描画
-	MV1DrawModel(_animator->GetModelHandle());
+	if (_modelLod != ModelLod::Impostor) return _modelLod;
 
-	_weapon->Draw();
+	// 姿勢や大きさが変わる状態では焼き込んだ画像と見た目が合わない
+	const bool isSteady = (_nowUpdateState == &EnemyNormal::UpdateIdle ||
+		_nowUpdateState == &EnemyNormal::UpdateChase);
+	if (!isSteady || EnemyFactory::GetImpostor(GetType()) == nullptr) {
+		return ModelLod::Reduced;
+	}
+	return ModelLod::Impostor;
 }
 
 float EnemyNormal::GetMaxHitPoint() const
@@ -191,10 +275,13 @@ void EnemyNormal::TakeDamage(float damage, std::shared_ptr<Collider> attacker)
 	// HPを減らす
 	_hitPoint -= damage;
 
+	// 攻撃中に割り込まれた場合に備え、武器の当たり判定を無効にする
+	_weapon->SetCollisionState(false);
+
 	// プレイヤーの方向を向く
-	if (!_player.expired()) {
+	if (_player.IsValid()) {
 		// プレイヤーへの方向ベクトル
-		Vector3 dirToPlayer = (_player.lock()->GetPos() - GetPos());
+		Vector3 dirToPlayer = (_player->GetPos() - GetPos());
 		if (dirToPlayer.SqrMagnitude() > 0.0f) {
 			// Y軸回転角度を計算
 			_rotAngle = atan2f(dirToPlayer.x, dirToPlayer.z);
@@ -207,25 +294,24 @@ void EnemyNormal::TakeDamage(float damage, std::shared_ptr<Collider> attacker)
 	// 死亡判定
 	if (_hitPoint <= 0.0f &&
 		_state == State::Active) {
-		_state = State::Dying;
+		BeginDying();
 		_nowUpdateState = &EnemyNormal::UpdateDeath;
 		_animator->ChangeAnim(kAnimNameDeath, false);
-		_player.lock()->AddScore(kAddScore);		//スコア加算
-		SoundManager::GetInstance().PlaySoundType(SEType::Attack2);
-		SoundManager::GetInstance().PlaySoundType(SEType::EnemyDeath);
+		// 副作用は記録しておき、物理演算の後に敵の並び順でまとめて実行する
+		_commandBuffer.AddScore(_player, kAddScore);		//スコア加算
+		_commandBuffer.PlaySound(SEType::Attack2);
+		_commandBuffer.PlaySound(SEType::EnemyDeath);
 		// 物理判定から除外する
-		ReleasePhysics();
-		_weapon->ReleasePhysics();
+		_commandBuffer.ReleasePhysics(this);
+		_commandBuffer.ReleasePhysics(_weapon.get());
 		return;
 	}
 
-	SoundManager::GetInstance().PlaySoundType(SEType::Attack1);
+	_commandBuffer.PlaySound(SEType::Attack1);
 
 	// 既に被弾状態ならアニメーションを最初から再生
 	if (_nowUpdateState == &EnemyNormal::UpdateDamage) {
-		auto& animData = _animator->FindAnimData(kAnimNameDamage);
-		animData.frame = 0.0f;
-		animData.isEnd = false;
+		_animator->RestartAnim(kAnimNameDamage);
 	}
 	// そうでなければ被弾状態へ遷移
 	else {
@@ -234,14 +320,98 @@ void EnemyNormal::TakeDamage(float damage, std::shared_ptr<Collider> attacker)
 	}
 }
 
+bool EnemyNormal::IsThinkRequired() const
+{
+	// 死亡したが死亡状態に移っていない
+	if (_hitPoint <= 0.0f && _state == State::Active) return true;
+
+	// 次の状態を決める必要があるアニメーションが終了している
+	if (_nowUpdateState == &EnemyNormal::UpdateSpawning) {
+		return _animator->IsEnd(kAnimNameSpawn);
+	}
+	if (_nowUpdateState == &EnemyNormal::UpdateDamage) {
+		return _animator->IsEnd(kAnimNameDamage);
+	}
+	if (_nowUpdateState == &EnemyNormal::UpdateAttack) {
+		return _animator->IsEnd(kAnimNameAttack);
+	}
+	return false;
+}
+
+void EnemyNormal::SaveSnapshot(SnapshotWriter& writer) const
+{
+	EnemyBase::SaveSnapshot(writer);
+
+	int stateIndex = 0;
+	for (int i = 0; i < kUpdateStateNum; ++i) {
+		if (_nowUpdateState == kUpdateStateTable[i]) {
+			stateIndex = i;
+			break;
+		}
+	}
+	writer.Write(stateIndex);
+	writer.Write(_spawnProgress);
+	writer.WriteString(_animator->GetCurrentAnimName());
+	writer.Write(_animator->GetCurrentAnimFrame());
+}
+
+void EnemyNormal::LoadSnapshot(SnapshotReader& reader)
+{
+	const bool wasEntered = IsPhysicsEntered();
+	EnemyBase::LoadSnapshot(reader);
+
+	int stateIndex = 0;
+	std::wstring animName;
+	float animFrame = 0.0f;
+	reader.Read(stateIndex);
+	reader.Read(_spawnProgress);
+	reader.ReadString(animName);
+	reader.Read(animFrame);
+	assert(reader.IsValid() && "敵の状態を読み込めなかった");
+
+	_nowUpdateState = kUpdateStateTable[std::clamp(stateIndex, 0, kUpdateStateNum - 1)];
+	_animator->RestoreAnim(animName, animFrame);
+
+	// 死亡の前後をまたいで戻した場合はphysicsへの登録を合わせる
+	const bool isEntered = IsPhysicsEntered();
+	if (wasEntered && !isEntered) {
+		ReleasePhysics();
+		_weapon->ReleasePhysics();
+	}
+	else if (!wasEntered && isEntered) {
+		EntryPhysics(physics);
+		_weapon->EntryPhysics(physics);
+	}
+
+	// 攻撃判定はアニメーションイベントで再び有効になる
+	_weapon->SetCollisionState(false);
+
+	// 向きと大きさをモデルに反映する
+	MV1SetRotationXYZ(_animator->GetModelHandle(), Vector3(0, _rotAngle + Calc::ToRadian(180.0f), 0));
+	if (_nowUpdateState == &EnemyNormal::UpdateSpawning) {
+		MV1SetScale(_animator->GetModelHandle(), kModelScale * _spawnProgress);
+	}
+	else {
+		MV1SetScale(_animator->GetModelHandle(), kModelScale);
+	}
+	WeaponUpdate();
+}
+
+void EnemyNormal::Discard()
+{
+	if (!IsPhysicsEntered()) return;
+	ReleasePhysics();
+	_weapon->ReleasePhysics();
+}
+
 void EnemyNormal::CheckStateTransition()
 {
 	// 出現状態か判定(優先)
 	if (_nowUpdateState == &EnemyNormal::UpdateSpawning) {
 		// アニメーションが終了したら、追跡状態に移行
 		if (_animator->IsEnd(kAnimNameSpawn)) {
-			float dist = (GetPos() - _player.lock()->GetPos()).Magnitude();
-			if (dist <= kChaseDist) {
+			float distSq = (GetPos() - _player->GetPos()).SqrMagnitude();
+			if (distSq <= kChaseDistSq) {
 				// プレイヤーを追い始める
 				_state = State::Active;
 				_nowUpdateState = &EnemyNormal::UpdateChase;
@@ -260,12 +430,12 @@ void EnemyNormal::CheckStateTransition()
 	// 死亡したか判定(優先)
 	if (_hitPoint <= 0.0f &&
 		_state == State::Active) {
-		_state = State::Dying;
+		BeginDying();
 		_nowUpdateState = &EnemyNormal::UpdateDeath;
 		_animator->ChangeAnim(kAnimNameDeath, false);
 		// 物理判定から除外する
-		ReleasePhysics();
-		_weapon->ReleasePhysics();
+		_commandBuffer.ReleasePhysics(this);
+		_commandBuffer.ReleasePhysics(_weapon.get());
 		return;	// 死亡した場合は他の状態に遷移しない
 	}
 
@@ -287,7 +457,7 @@ void EnemyNormal::CheckStateTransition()
 	}
 
 	// プレイヤー情報の確認
-	if (_player.expired()) {
+	if (!_player.IsValid()) {
 		// もしプレイヤーがいない場合、待機状態に戻る
 		if (_nowUpdateState != &EnemyNormal::UpdateIdle) {
 			_nowUpdateState = &EnemyNormal::UpdateIdle;
@@ -296,20 +466,20 @@ void EnemyNormal::CheckStateTransition()
 		return;
 	}
 
-	// プレイヤーとの距離
-	float distance = (_player.lock()->GetPos() - GetPos()).Magnitude();
+	// プレイヤーとの距離(2乗)
+	float distanceSq = (_player->GetPos() - GetPos()).SqrMagnitude();
 
 	// 攻撃状態
 	// プレイヤーとの距離が攻撃移行範囲よりも近かったら
-	if (distance <= _transferAttackRad) {
+	if (distanceSq <= _transferAttackRad * _transferAttackRad) {
 		// 剣の攻撃状態をリセット
+		// (効果音はアニメーションイベントで鳴らす)
 		_weapon->ResetAttackState();
-		SoundManager::GetInstance().PlaySoundType(SEType::EnemyAttack);
 
 		// プレイヤーの方向を向く
-		if (!_player.expired()) {
+		if (_player.IsValid()) {
 			// プレイヤーへの方向ベクトル
-			Vector3 dirToPlayer = (_player.lock()->GetPos() - GetPos());
+			Vector3 dirToPlayer = (_player->GetPos() - GetPos());
 			if (dirToPlayer.SqrMagnitude() > 0.0f) {
 				// Y軸回転角度を計算
 				_rotAngle = atan2f(dirToPlayer.x, dirToPlayer.z);
@@ -327,10 +497,8 @@ void EnemyNormal::CheckStateTransition()
 		}
 		else {
 			// アニメーションが終了している場合、再度再生するためにフレームをリセット
-			auto& animData = _animator->FindAnimData(kAnimNameAttack);
-			if (animData.isEnd) {
-				animData.frame = 0.0f;
-				animData.isEnd = false;
+			if (_animator->IsEnd(kAnimNameAttack)) {
+				_animator->RestartAnim(kAnimNameAttack);
 			}
 		}
 		return; // 攻撃状態に決定
@@ -339,7 +507,7 @@ void EnemyNormal::CheckStateTransition()
 	// 追跡状態
 	// プレイヤーが追跡範囲内にいれば追跡する
 	if (_nowUpdateState != &EnemyNormal::UpdateChase &&
-		distance <= kChaseDist) {
+		distanceSq <= kChaseDistSq) {
 		_nowUpdateState = &EnemyNormal::UpdateChase;
 		_animator->ChangeAnim(kAnimNameChase, true);
 		return;
@@ -347,7 +515,7 @@ void EnemyNormal::CheckStateTransition()
 
 	// それ以外の場合、待機状態に戻る
 	if (_nowUpdateState != &EnemyNormal::UpdateIdle &&
-		distance > kChaseDist) {
+		distanceSq > kChaseDistSq) {
 		_nowUpdateState = &EnemyNormal::UpdateIdle;
 		_animator->ChangeAnim(kAnimNameIdle, true);
 	}
@@ -368,8 +536,9 @@ void EnemyNormal::UpdateSpawning()
 		if (std::min<float>(animData.frame, totalFrame)) {
 			progress = std::min<float>(animData.frame / totalFrame, 1.0f);
 		}
-		// スケールを線形補間
-		MV1SetScale(_animator->GetModelHandle(), kModelScale * progress);
+		// スケールを線形補間する
+		// (モデルへの適用はApplyModelで行う)
+		_spawnProgress = progress;
 	}
 }
 
@@ -381,8 +550,14 @@ void EnemyNormal::UpdateIdle()
 
 void EnemyNormal::UpdateChase()
 {
-	// プレイヤーの方向を向く
-	RotateToPlayer();
+	// 群れの進行方向が決まっていればそちらを向き、
+	// 決まっていなければプレイヤーの方向を向く
+	if (_steeringDir.SqrMagnitude() > 0.0f) {
+		RotateToDir(_steeringDir);
+	}
+	else {
+		RotateToPlayer();
+	}
 
 	// 前方に移動
 	Vector3 vel = rigidbody->GetDir() * kChaseSpeed;
@@ -392,38 +567,35 @@ void EnemyNormal::UpdateChase()
 void EnemyNormal::UpdateAttack()
 {
 	// 攻撃中は移動を止める
+	// (当たり判定の切り替えはアニメーションイベントで行う)
 	rigidbody->SetVel(Vector3());
+}
 
-
-	// 攻撃アニメーションの情報を取得
-	auto& animData = _animator->FindAnimData(kAnimNameAttack);
-
-	const bool prevHit = _weapon->IsHit();
-
-	// アニメーションの総フレーム数が0より大きい場合かつ
-	// まだ当たっていない場合のみ処理
-	if (animData.totalFrame > 0.0f && 
-		!prevHit) {
-		// 現在の再生フレームと総フレームから進行度を計算(0.0f-1.0f)
-		float progress = animData.frame / animData.totalFrame;
-
-		// 進行度が指定の範囲内である場合攻撃
-		if (progress >= kAttackColStart && progress <= kAttackColEnd) {
-			// 当たり判定が行われていない場合は
-			// 状態をリセット
-			if (!_weapon->GetCollisionState()) {
-				_weapon->ResetAttackState();
-			}
-			_weapon->SetCollisionState(true);	// 当たり判定を有効にする
+void EnemyNormal::OnAnimEvent(const Animator::AnimEvent& animEvent)
+{
+	switch (animEvent.type) {
+	case Animator::EventType::HitboxOn:
+		// 当たり判定が行われていない場合は
+		// 状態をリセット
+		if (!_weapon->GetCollisionState()) {
+			_weapon->ResetAttackState();
+		}
+		_weapon->SetCollisionState(true);	// 当たり判定を有効にする
+		break;
+	case Animator::EventType::HitboxOff:
+		_weapon->SetCollisionState(false);
+		break;
+	case Animator::EventType::SoundCue:
+		// 記録だけしておき、後でまとめて鳴らす
+		if (_commands) {
+			_commands->PlaySound(static_cast<SEType>(animEvent.param));
 		}
 		else {
-			_weapon->SetCollisionState(false);
+			_commandBuffer.PlaySound(static_cast<SEType>(animEvent.param));
 		}
-	}
-	else {
-		// もしアニメーションが再生されていない、または終了している場合は
-		// 当たり判定を無効にする
-		_weapon->SetCollisionState(false);
+		break;
+	default:
+		break;
 	}
 }
 
@@ -443,15 +615,18 @@ void EnemyNormal::UpdateDeath()
 
 void EnemyNormal::RotateToPlayer()
 {
-	if (_player.expired()) return;
+	if (!_player.IsValid()) return;
 
 	// プレイヤーへの方向ベクトル
-	Vector3 dirToPlayer = (_player.lock()->GetPos() - GetPos());
-	if (dirToPlayer.SqrMagnitude() == 0.0f) return; // 距離がゼロなら何もしない
-	dirToPlayer.Normalized();
+	RotateToDir(_player->GetPos() - GetPos());
+}
 
-	// Y軸回転角度を計算
-	float targetAngle = atan2f(dirToPlayer.x, dirToPlayer.z);
+void EnemyNormal::RotateToDir(const Vector3& dir)
+{
+	if (dir.SqrMagnitude() == 0.0f) return; // 長さがゼロなら何もしない
+
+	// Y軸回転角度を計算(atan2は長さに依存しないので正規化は不要)
+	float targetAngle = atan2f(dir.x, dir.z);
 
 	// 現在の角度から目標角度までの差分を計算
 	float diff = Calc::RadianNormalize(targetAngle - _rotAngle);
@@ -460,8 +635,7 @@ void EnemyNormal::RotateToPlayer()
 	float turnAmount = std::clamp<float>(diff, -kTurnSpeed, kTurnSpeed);
 	_rotAngle += turnAmount;
 
-	// モデルに回転を適用
-	MV1SetRotationXYZ(_animator->GetModelHandle(), Vector3(0, _rotAngle + Calc::ToRadian(180.0f), 0));
+	// モデルへの回転の適用はApplyModelで行う
 
 	// Rigidbodyの向きも更新
 	Vector3 newDir = Vector3(sinf(_rotAngle), 0.0f, cosf(_rotAngle)).Normalize();
@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include "EnemyBase.h"
 #include "EnemyFactory.h"
+#include "Animator.h"
 
 /// <summary>
 /// 無難な行動を行う敵
@@ -11,9 +12,10 @@ public:
 	EnemyNormal(int modelHandle);
 	~EnemyNormal();
 
-	void Init(std::weak_ptr<Player> player, std::weak_ptr<Physics> physics) override;
-	void Update() override;
-	void Draw() override;
+	void Init(Handle<Player> player, std::weak_ptr<Physics> physics) override;
+	void UpdateCompute(EnemyCommandBuffer& commands) override;
+	void ApplyModel() override;
+	void WriteSnapshot(RenderSnapshot& snapshot) const override;
 
 	/// <summary>
 	/// 敵タイプを返す
@@ -37,6 +39,15 @@ public:
 	/// <param name="attacker">攻撃してきた相手</param>
 	void TakeDamage(float damage, std::shared_ptr<Collider> attacker) override;
 
+	/// <summary>
+	/// 予算に関係なくすぐに思考する必要があるか
+	/// </summary>
+	bool IsThinkRequired() const override;
+
+	void SaveSnapshot(SnapshotWriter& writer) const override;
+	void LoadSnapshot(SnapshotReader& reader) override;
+	void Discard() override;
+
 
 private:
 	/// <summary>
@@ -47,6 +58,10 @@ private:
 	using UpdateFunc_t = void(EnemyNormal::*)();
 	UpdateFunc_t _nowUpdateState;
 
+	// 状態の保存時に番号へ置き換えるためのステート一覧
+	static constexpr int kUpdateStateNum = 6;
+	static const UpdateFunc_t kUpdateStateTable[kUpdateStateNum];
+
 private:
 
 	/// <summary>
@@ -78,6 +93,16 @@ private:
 	/// プレイヤーの方を向く
 	/// </summary>
 	void RotateToPlayer();
+	/// <summary>
+	/// 指定の方向(XZ)を向く
+	/// </summary>
+	void RotateToDir(const Vector3& dir);
+
+	/// <summary>
+	/// アニメーションイベントを受け取る
+	/// (攻撃判定と効果音を切り替える)
+	/// </summary>
+	void OnAnimEvent(const Animator::AnimEvent& animEvent);
 
 
 	/// <summary>
@@ -85,6 +110,17 @@ private:
 	/// </summary>
 	void WeaponUpdate();
 
+	/// <summary>
+	/// 描画に使用する詳細度を返す
+	/// (ビルボードは待機中と追跡中のみ使用する)
+	/// </summary>
+	ModelLod GetDrawLod() const;
+
 	// 武器
 	std::shared_ptr<WeaponEnemy> _weapon;
+
+	// UpdateCompute中の副作用の記録先(それ以外ではnullptr)
+	EnemyCommandBuffer* _commands;
+	// 出現時のスケーリングの進行度(0.0-1.0)
+	float _spawnProgress;
 };
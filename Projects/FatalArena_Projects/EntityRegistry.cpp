@@ -0,0 +1,56 @@
+﻿#include "EntityRegistry.h"
+
+EntityRegistry& EntityRegistry::GetInstance()
+{
+	static EntityRegistry ret;
+	return ret;
+}
+
+EntityRegistry::EntityRegistry() :
+	_pools(),
+	_generations(),
+	_freeIndices()
+{
+}
+
+Entity_t EntityRegistry::Create()
+{
+	// 破棄された位置があれば使い回す(世代は破棄時に進めてある)
+	uint32_t index = 0;
+	if (!_freeIndices.empty()) {
+		index = _freeIndices.back();
+		_freeIndices.pop_back();
+	}
+	else {
+		index = static_cast<uint32_t>(_generations.size());
+		// 全てのビットが立った位置はkNullEntityと重なりうるため使わない
+		assert(index < kIndexMask && "エンティティの数が多すぎる");
+		_generations.emplace_back(0);
+	}
+	return (_generations[index] << kIndexBits) | index;
+}
+
+void EntityRegistry::Destroy(Entity_t entity)
+{
+	// 破棄済みの識別番号で、同じ位置を使う新しいエンティティを消さないようにする
+	if (!IsAlive(entity)) return;
+	for (auto& pool : _pools) {
+		if (pool) pool->Remove(entity);
+	}
+	const uint32_t index = GetIndex(entity);
+	_generations[index] = (_generations[index] + 1) & kGenerationMask;
+	_freeIndices.emplace_back(index);
+}
+
+bool EntityRegistry::IsAlive(Entity_t entity) const
+{
+	if (entity == kNullEntity) return false;
+	const uint32_t index = GetIndex(entity);
+	return (index < _generations.size() && _generations[index] == GetGeneration(entity));
+}
+
+int EntityRegistry::NextTypeId()
+{
+	static int nextId = 0;
+	return nextId++;
+}
@@ -0,0 +1,182 @@
+﻿#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cassert>
+
+// エンティティの識別番号
+// 位置(下位)と世代(上位)を32bitにまとめたもので、
+// 破棄された位置が再利用されても、破棄前の識別番号とは一致しない
+using Entity_t = uint32_t;
+// 無効なエンティティ
+constexpr Entity_t kNullEntity = UINT32_MAX;
+
+/// <summary>
+/// エンティティとコンポーネントを管理するシングルトンクラス
+/// コンポーネントは種類ごとに隙間なく並べて保持するため、
+/// 同じ種類のコンポーネントを先頭から順に処理できる
+/// </summary>
+class EntityRegistry final
+{
+private:
+	/// <summary>
+	/// 種類を問わずコンポーネントの列を扱うための基底
+	/// </summary>
+	class PoolBase
+	{
+	public:
+		virtual ~PoolBase() {}
+		virtual void Remove(Entity_t entity) = 0;
+	};
+
+public:
+	// 識別番号のうち位置に使うビット数(残りを世代に使う)
+	static constexpr uint32_t kIndexBits = 20;
+	static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+	static constexpr uint32_t kGenerationMask = (1u << (32 - kIndexBits)) - 1;
+
+	static uint32_t GetIndex(Entity_t entity) { return entity & kIndexMask; }
+	static uint32_t GetGeneration(Entity_t entity) { return entity >> kIndexBits; }
+
+	/// <summary>
+	/// 1種類のコンポーネントの列
+	/// エンティティの位置から列の位置を引く表と、隙間のない列を持つ
+	/// (表は位置のみで引き、列のエンティティと世代まで一致するかを確認する)
+	/// </summary>
+	template<typename T>
+	class Pool final : public PoolBase
+	{
+	public:
+		T& Add(Entity_t entity, const T& component)
+		{
+			const uint32_t entityIndex = GetIndex(entity);
+			if (entityIndex >= _sparse.size()) {
+				_sparse.resize(static_cast<size_t>(entityIndex) + 1, kInvalidIndex);
+			}
+			assert(_sparse[entityIndex] == kInvalidIndex && "既にコンポーネントを持っている");
+			_sparse[entityIndex] = static_cast<int>(_dense.size());
+			_dense.emplace_back(entity);
+			_components.emplace_back(component);
+			return _components.back();
+		}
+
+		void Remove(Entity_t entity) override
+		{
+			if (!Has(entity)) return;
+			// 末尾と入れ替えて削除し、列に隙間を作らない
+			const uint32_t entityIndex = GetIndex(entity);
+			const int index = _sparse[entityIndex];
+			const Entity_t last = _dense.back();
+			_dense[index] = last;
+			_components[index] = std::move(_components.back());
+			_sparse[GetIndex(last)] = index;
+			_dense.pop_back();
+			_components.pop_back();
+			_sparse[entityIndex] = kInvalidIndex;
+		}
+
+		bool Has(Entity_t entity) const
+		{
+			const uint32_t entityIndex = GetIndex(entity);
+			if (entityIndex >= _sparse.size()) return false;
+			const int index = _sparse[entityIndex];
+			// 同じ位置を使う、破棄済みの古い識別番号は一致しない
+			return (index != kInvalidIndex && _dense[index] == entity);
+		}
+
+		T& Get(Entity_t entity)
+		{
+			assert(Has(entity) && "コンポーネントを持っていない");
+			return _components[_sparse[GetIndex(entity)]];
+		}
+		const T& Get(Entity_t entity) const
+		{
+			assert(Has(entity) && "コンポーネントを持っていない");
+			return _components[_sparse[GetIndex(entity)]];
+		}
+
+		int Size() const { return static_cast<int>(_components.size()); }
+		// 先頭から順に処理するためのもの
+		// (同じ添字のEntitiesとComponentsは対応している)
+		const std::vector<Entity_t>& Entities() const { return _dense; }
+		std::vector<T>& Components() { return _components; }
+		const std::vector<T>& Components() const { return _components; }
+
+	private:
+		static constexpr int kInvalidIndex = -1;
+
+		std::vector<int> _sparse;		// エンティティの位置→列の位置
+		std::vector<Entity_t> _dense;	// 列の位置→エンティティ
+		std::vector<T> _components;		// コンポーネント本体
+	};
+
+	/// <summary>
+	/// シングルトンオブジェクトを返す
+	/// </summary>
+	/// <returns>シングルトンオブジェクト</returns>
+	static EntityRegistry& GetInstance();
+
+	/// <summary>
+	/// エンティティを作成する
+	/// </summary>
+	Entity_t Create();
+
+	/// <summary>
+	/// エンティティとその全てのコンポーネントを破棄する
+	/// 破棄済みの識別番号を渡した場合は何もしない
+	/// </summary>
+	void Destroy(Entity_t entity);
+
+	/// <summary>
+	/// エンティティが破棄されていないか
+	/// </summary>
+	bool IsAlive(Entity_t entity) const;
+
+	template<typename T>
+	T& Add(Entity_t entity, const T& component = T()) { return GetPool<T>().Add(entity, component); }
+	template<typename T>
+	void Remove(Entity_t entity) { GetPool<T>().Remove(entity); }
+	template<typename T>
+	bool Has(Entity_t entity) { return GetPool<T>().Has(entity); }
+	template<typename T>
+	T& Get(Entity_t entity) { return GetPool<T>().Get(entity); }
+
+	/// <summary>
+	/// 指定の種類のコンポーネントの列を返す
+	/// </summary>
+	template<typename T>
+	Pool<T>& GetPool()
+	{
+		const int typeId = GetTypeId<T>();
+		if (typeId >= static_cast<int>(_pools.size())) {
+			_pools.resize(static_cast<size_t>(typeId) + 1);
+		}
+		if (!_pools[typeId]) {
+			_pools[typeId] = std::make_unique<Pool<T>>();
+		}
+		return static_cast<Pool<T>&>(*_pools[typeId]);
+	}
+
+private:
+	EntityRegistry();
+	EntityRegistry(const EntityRegistry&) = delete;
+	void operator=(const EntityRegistry&) = delete;
+
+	/// <summary>
+	/// コンポーネントの種類ごとに0から順に番号を割り振る
+	/// </summary>
+	static int NextTypeId();
+	template<typename T>
+	static int GetTypeId()
+	{
+		static const int id = NextTypeId();
+		return id;
+	}
+
+	// 種類番号ごとのコンポーネントの列
+	std::vector<std::unique_ptr<PoolBase>> _pools;
+	// 位置ごとの現在の世代
+	std::vector<uint32_t> _generations;
+	// 破棄されて再利用できる位置
+	std::vector<uint32_t> _freeIndices;
+};
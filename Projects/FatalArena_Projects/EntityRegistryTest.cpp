@@ -0,0 +1,127 @@
+﻿#include "SelfTest.h"
+#include "EntityRegistry.h"
+#include <vector>
+
+namespace {
+	// 列の詰め直しを確認するエンティティの数
+	// (3つおきに破棄した際に末尾も破棄されるよう、3の倍数+1にする)
+	constexpr int kEntityNum = 64;
+
+	/// <summary>
+	/// 確認用のコンポーネント(作成時の順番を持たせ、詰め直し後の対応を確かめる)
+	/// </summary>
+	struct TestComponent
+	{
+		int value = 0;
+	};
+
+	/// <summary>
+	/// 列のエンティティとコンポーネントの対応が崩れていないか
+	/// </summary>
+	bool IsPoolConsistent(const EntityRegistry::Pool<TestComponent>& pool,
+		const std::vector<Entity_t>& entities)
+	{
+		const auto& poolEntities = pool.Entities();
+		const auto& components = pool.Components();
+		if (poolEntities.size() != components.size()) return false;
+		for (size_t i = 0; i < poolEntities.size(); ++i) {
+			if (!pool.Has(poolEntities[i])) return false;
+			if (&pool.Get(poolEntities[i]) != &components[i]) return false;
+			// 値は作成時の順番(entitiesの添字)になっている
+			const int value = components[i].value;
+			if (value < 0 || value >= static_cast<int>(entities.size())) return false;
+			if (entities[value] != poolEntities[i]) return false;
+		}
+		return true;
+	}
+}
+
+void SelfTest::RunEntityRegistryTests()
+{
+	PrintHeader("EntityRegistry");
+	EntityRegistry& registry = EntityRegistry::GetInstance();
+	auto& pool = registry.GetPool<TestComponent>();
+
+	// 作成と破棄
+	{
+		const Entity_t entity = registry.Create();
+		registry.Add(entity, TestComponent{ 1 });
+		Check(registry.IsAlive(entity) && registry.Has<TestComponent>(entity),
+			"a created entity is alive and has its component");
+		registry.Destroy(entity);
+		Check(!registry.IsAlive(entity) && !registry.Has<TestComponent>(entity),
+			"a destroyed entity is no longer alive and loses its components");
+		Check(!registry.IsAlive(kNullEntity), "the null entity is never alive");
+	}
+
+	// 破棄後に同じ位置が再利用されても、古い識別番号は新しいエンティティと一致しない
+	{
+		const Entity_t oldEntity = registry.Create();
+		registry.Destroy(oldEntity);
+		const Entity_t newEntity = registry.Create();
+		registry.Add(newEntity, TestComponent{ 2 });
+		Check(EntityRegistry::GetIndex(newEntity) == EntityRegistry::GetIndex(oldEntity) &&
+			newEntity != oldEntity, "a reused index gets a new generation");
+		Check(!registry.IsAlive(oldEntity) && !registry.Has<TestComponent>(oldEntity),
+			"a stale id does not alias the entity that reused its index");
+
+		// 古い識別番号での破棄は何もしない
+		registry.Destroy(oldEntity);
+		Check(registry.IsAlive(newEntity) && registry.Get<TestComponent>(newEntity).value == 2,
+			"destroying a stale id leaves the new entity intact");
+
+		registry.Destroy(newEntity);
+		registry.Destroy(newEntity);
+		const Entity_t nextEntity = registry.Create();
+		const Entity_t otherEntity = registry.Create();
+		Check(nextEntity != otherEntity, "destroying twice does not hand out an index twice");
+		registry.Destroy(nextEntity);
+		registry.Destroy(otherEntity);
+	}
+
+	// 途中を削除しても列は隙間なく、エンティティとの対応を保つ
+	{
+		std::vector<Entity_t> entities;
+		entities.reserve(kEntityNum);
+		for (int i = 0; i < kEntityNum; ++i) {
+			const Entity_t entity = registry.Create();
+			registry.Add(entity, TestComponent{ i });
+			entities.emplace_back(entity);
+		}
+		// 先頭・途中・末尾を含めて3つおきに破棄する
+		int aliveNum = kEntityNum;
+		for (int i = 0; i < kEntityNum; i += 3) {
+			registry.Destroy(entities[i]);
+			--aliveNum;
+		}
+
+		Check(pool.Size() == aliveNum, "the pool stays dense after removals");
+		Check(IsPoolConsistent(pool, entities), "entities and components stay paired after swap-removal");
+
+		bool isEveryAliveFound = true;
+		for (int i = 0; i < kEntityNum; ++i) {
+			const bool isDestroyed = (i % 3 == 0);
+			if (registry.Has<TestComponent>(entities[i]) == isDestroyed) isEveryAliveFound = false;
+			if (!isDestroyed && registry.Get<TestComponent>(entities[i]).value != i) isEveryAliveFound = false;
+		}
+		Check(isEveryAliveFound, "every remaining entity still finds its own component");
+
+		// AISchedulerと同じく、列を先頭から順に処理すると生きている全てに1度ずつ届く
+		for (auto& component : pool.Components()) {
+			component.value += kEntityNum;
+		}
+		int updatedNum = 0;
+		for (int i = 0; i < kEntityNum; ++i) {
+			if (registry.Has<TestComponent>(entities[i]) &&
+				registry.Get<TestComponent>(entities[i]).value == i + kEntityNum) {
+				++updatedNum;
+			}
+		}
+		Check(updatedNum == aliveNum, "a linear pass reaches every remaining component exactly once");
+
+		for (Entity_t entity : entities) {
+			registry.Destroy(entity);
+		}
+		Check(pool.Size() == 0, "destroying every entity empties the pool");
+	}
+}
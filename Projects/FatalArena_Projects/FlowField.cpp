@@ -0,0 +1,227 @@
+﻿#include "FlowField.h"
+#include <cassert>
+#include <cmath>
+#include <climits>
+#include <algorithm>
+
+namespace {
+	// 1フレームに計算を進めるセル数
+	constexpr int kBuildCellsPerFrame = 400;
+
+	// 隣接セルへの移動コスト
+	constexpr int kStraightCost = 10;
+	constexpr int kDiagonalCost = 14;
+
+	// 周囲8方向
+	constexpr int kNeighborNum = 8;
+	constexpr int kNeighborX[kNeighborNum] = { 1, -1, 0,  0, 1,  1, -1, -1 };
+	constexpr int kNeighborZ[kNeighborNum] = { 0,  0, 1, -1, 1, -1,  1, -1 };
+	constexpr int kNeighborCost[kNeighborNum] = {
+		kStraightCost, kStraightCost, kStraightCost, kStraightCost,
+		kDiagonalCost, kDiagonalCost, kDiagonalCost, kDiagonalCost };
+
+	constexpr int kUnreachedCost = INT_MAX;
+}
+
+FlowField::FlowField(float radius, float cellSize) :
+	_radius(radius),
+	_cellSize(cellSize),
+	_cellNum(0),
+	_isWalkable(),
+	_directions(),
+	_goalCell(-1),
+	_isReady(false),
+	_buildingGoalCell(-1),
+	_buildCost(),
+	_openList()
+{
+	assert(radius > 0.0f && cellSize > 0.0f && "フィールドの大きさが正しくない");
+	_cellNum = std::max<int>(1, static_cast<int>(std::ceil(radius * 2.0f / cellSize)));
+	const int total = _cellNum * _cellNum;
+	_isWalkable.resize(total);
+	_directions.resize(total);
+	_buildCost.resize(total, kUnreachedCost);
+
+	// セルの中心が円の内側にあれば移動可能とする
+	const float radiusSq = radius * radius;
+	for (int cz = 0; cz < _cellNum; ++cz) {
+		for (int cx = 0; cx < _cellNum; ++cx) {
+			const float x = (cx + 0.5f) * _cellSize - _radius;
+			const float z = (cz + 0.5f) * _cellSize - _radius;
+			_isWalkable[cz * _cellNum + cx] = (x * x + z * z <= radiusSq);
+		}
+	}
+}
+
+FlowField::~FlowField()
+{
+}
+
+void FlowField::Update(const Position3& targetPos)
+{
+	const int goalCell = ToCellIndex(targetPos.x, targetPos.z);
+
+	// 目標のセルが変わったら計算し直す
+	// (計算中のものと同じであればそのまま続ける)
+	if (goalCell >= 0 && _isWalkable[goalCell] &&
+		goalCell != _goalCell && goalCell != _buildingGoalCell) {
+		StartBuild(goalCell);
+	}
+
+	// 計算中であれば続きを進める
+	if (_buildingGoalCell >= 0) {
+		if (ContinueBuild(kBuildCellsPerFrame)) {
+			FinishBuild();
+		}
+	}
+}
+
+Vector3 FlowField::GetDirection(const Position3& pos) const
+{
+	if (!_isReady) return Vector3();
+	const int cell = ToCellIndex(pos.x, pos.z);
+	if (cell < 0 || cell == _goalCell) return Vector3();
+
+	// 周囲4セルの中心の方向を距離で補間し、セルの境目で向きが急に変わらないようにする
+	// (方向が無いセルは寄与しない)
+	const float fx = (pos.x + _radius) / _cellSize - 0.5f;
+	const float fz = (pos.z + _radius) / _cellSize - 0.5f;
+	const int baseX = static_cast<int>(std::floor(fx));
+	const int baseZ = static_cast<int>(std::floor(fz));
+	const float tx = fx - baseX;
+	const float tz = fz - baseZ;
+	Vector2 blended;
+	for (int i = 0; i < 4; ++i) {
+		const int sx = baseX + (i & 1);
+		const int sz = baseZ + (i >> 1);
+		if (sx < 0 || sx >= _cellNum || sz < 0 || sz >= _cellNum) continue;
+		const float weight = ((i & 1) ? tx : 1.0f - tx) * ((i >> 1) ? tz : 1.0f - tz);
+		const Vector2& dir = _directions[sz * _cellNum + sx];
+		blended.x += dir.x * weight;
+		blended.y += dir.y * weight;
+	}
+	// 補間で打ち消し合った場合は自身のセルの方向を使う
+	if (blended.x * blended.x + blended.y * blended.y <= 0.0f) {
+		const Vector2& dir = _directions[cell];
+		return Vector3(dir.x, 0.0f, dir.y);
+	}
+	blended.Normalized();
+	return Vector3(blended.x, 0.0f, blended.y);
+}
+
+void FlowField::StartBuild(int goalCell)
+{
+	_buildingGoalCell = goalCell;
+	std::fill(_buildCost.begin(), _buildCost.end(), kUnreachedCost);
+	// 探索候補を空にする(確保済みの領域は使い回す)
+	while (!_openList.empty()) _openList.pop();
+
+	_buildCost[goalCell] = 0;
+	_openList.emplace(0, goalCell);
+}
+
+bool FlowField::ContinueBuild(int cellBudget)
+{
+	// 目標からのコストを広げていく(ダイクストラ法)
+	int processed = 0;
+	while (!_openList.empty() && processed < cellBudget) {
+		const auto [cost, cell] = _openList.top();
+		_openList.pop();
+		// より安いコストで確定済み
+		if (cost > _buildCost[cell]) continue;
+		++processed;
+
+		const int cx = cell % _cellNum;
+		const int cz = cell / _cellNum;
+		for (int i = 0; i < kNeighborNum; ++i) {
+			const int nx = cx + kNeighborX[i];
+			const int nz = cz + kNeighborZ[i];
+			if (nx < 0 || nx >= _cellNum || nz < 0 || nz >= _cellNum) continue;
+			const int next = nz * _cellNum + nx;
+			if (!_isWalkable[next]) continue;
+			const int nextCost = cost + kNeighborCost[i];
+			if (nextCost < _buildCost[next]) {
+				_buildCost[next] = nextCost;
+				_openList.emplace(nextCost, next);
+			}
+		}
+	}
+	return _openList.empty();
+}
+
+void FlowField::FinishBuild()
+{
+	// 各セルでコストの勾配を下る方向を進行方向とする
+	// (最もコストの低い隣接セルへ向かうだけでは45度単位の向きにしかならないため)
+	for (int cz = 0; cz < _cellNum; ++cz) {
+		for (int cx = 0; cx < _cellNum; ++cx) {
+			const int cell = cz * _cellNum + cx;
+			_directions[cell] = Vector2();
+			if (!_isWalkable[cell] || _buildCost[cell] == kUnreachedCost) continue;
+
+			int bestCost = _buildCost[cell];
+			int bestIndex = -1;
+			for (int i = 0; i < kNeighborNum; ++i) {
+				const int nx = cx + kNeighborX[i];
+				const int nz = cz + kNeighborZ[i];
+				if (nx < 0 || nx >= _cellNum || nz < 0 || nz >= _cellNum) continue;
+				const int next = nz * _cellNum + nx;
+				if (_buildCost[next] < bestCost) {
+					bestCost = _buildCost[next];
+					bestIndex = i;
+				}
+			}
+			if (bestIndex < 0) continue;
+
+			const Vector2 neighborDir = Vector2(static_cast<float>(kNeighborX[bestIndex]),
+				static_cast<float>(kNeighborZ[bestIndex])).Normalize();
+			const Vector2 gradient(
+				GetCostSlope(cx, cz, 1, 0),
+				GetCostSlope(cx, cz, 0, 1));
+			const Vector2 downhill(-gradient.x, -gradient.y);
+
+			// 勾配が求まらない場合や、壁際の片側差分で隣接セルと逆を向く場合は
+			// 最もコストの低い隣接セルへの方向を使う
+			if (downhill.x * neighborDir.x + downhill.y * neighborDir.y <= 0.0f) {
+				_directions[cell] = neighborDir;
+				continue;
+			}
+			_directions[cell] = downhill.Normalize();
+		}
+	}
+
+	_goalCell = _buildingGoalCell;
+	_buildingGoalCell = -1;
+	_isReady = true;
+}
+
+float FlowField::GetCostSlope(int cx, int cz, int dx, int dz) const
+{
+	const int cost = _buildCost[cz * _cellNum + cx];
+	const int forward = GetBuildCost(cx + dx, cz + dz);
+	const int backward = GetBuildCost(cx - dx, cz - dz);
+
+	// 両側が求まっていれば中心差分、片側のみであればその側との差分
+	if (forward != kUnreachedCost && backward != kUnreachedCost) {
+		return (forward - backward) * 0.5f;
+	}
+	if (forward != kUnreachedCost) return static_cast<float>(forward - cost);
+	if (backward != kUnreachedCost) return static_cast<float>(cost - backward);
+	return 0.0f;
+}
+
+int FlowField::GetBuildCost(int cx, int cz) const
+{
+	if (cx < 0 || cx >= _cellNum || cz < 0 || cz >= _cellNum) return kUnreachedCost;
+	const int cell = cz * _cellNum + cx;
+	if (!_isWalkable[cell]) return kUnreachedCost;
+	return _buildCost[cell];
+}
+
+int FlowField::ToCellIndex(float x, float z) const
+{
+	const int cx = static_cast<int>(std::floor((x + _radius) / _cellSize));
+	const int cz = static_cast<int>(std::floor((z + _radius) / _cellSize));
+	if (cx < 0 || cx >= _cellNum || cz < 0 || cz >= _cellNum) return -1;
+	return cz * _cellNum + cx;
+}
@@ -0,0 +1,90 @@
+﻿#pragma once
+#include "Vector2.h"
+#include "Vector3.h"
+#include <vector>
+#include <functional>
+#include <queue>
+#include <utility>
+
+/// <summary>
+/// アリーナ(円形)全体を覆う、目標へ向かう進行方向の場
+/// 目標のセルが変わった際に数フレームに分けて再計算し、
+/// 計算が終わるまでは前回のものを使い続ける
+/// 進行方向の取得はO(1)
+/// </summary>
+class FlowField final
+{
+public:
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="radius">移動可能な範囲の半径</param>
+	/// <param name="cellSize">セル一辺の長さ</param>
+	FlowField(float radius, float cellSize);
+	~FlowField();
+
+	/// <summary>
+	/// 目標位置を更新する
+	/// 目標のセルが変わっていれば再計算を始め、計算中であれば続きを進める
+	/// </summary>
+	void Update(const Position3& targetPos);
+
+	/// <summary>
+	/// 指定位置での進行方向を返す(XZ平面、正規化済み)
+	/// 目標と同じセルや範囲外、計算が一度も終わっていない場合は長さ0
+	/// </summary>
+	Vector3 GetDirection(const Position3& pos) const;
+
+private:
+	/// <summary>
+	/// 指定のセルを目標として再計算を始める
+	/// </summary>
+	void StartBuild(int goalCell);
+	/// <summary>
+	/// 再計算を指定のセル数だけ進める
+	/// </summary>
+	/// <returns>計算が終わったか</returns>
+	bool ContinueBuild(int cellBudget);
+	/// <summary>
+	/// 計算したコストから進行方向を求めて反映する
+	/// </summary>
+	void FinishBuild();
+
+	/// <summary>
+	/// 計算したコストの、指定の軸方向の傾き(1セルあたり)
+	/// </summary>
+	/// <param name="dx">軸のX方向(1か0)</param>
+	/// <param name="dz">軸のZ方向(1か0)</param>
+	float GetCostSlope(int cx, int cz, int dx, int dz) const;
+	/// <summary>
+	/// 計算したコストを返す(範囲外や移動できないセルは到達できない扱い)
+	/// </summary>
+	int GetBuildCost(int cx, int cz) const;
+
+	/// <summary>
+	/// 座標からセル番号を求める(範囲外は-1)
+	/// </summary>
+	int ToCellIndex(float x, float z) const;
+
+	float _radius;
+	float _cellSize;
+	int _cellNum;	// 一辺のセル数
+
+	// セルごとの移動可否
+	std::vector<bool> _isWalkable;
+
+	// 反映済みの進行方向(XZ)
+	std::vector<Vector2> _directions;
+	// 反映済みのフィールドの目標セル
+	int _goalCell;
+	// 一度でも計算が終わっているか
+	bool _isReady;
+
+	// 計算中のフィールドの目標セル(-1なら計算していない)
+	int _buildingGoalCell;
+	// 計算中の目標までのコスト
+	std::vector<int> _buildCost;
+	// 計算中の探索候補(コスト, セル)
+	std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>,
+		std::greater<std::pair<int, int>>> _openList;
+};
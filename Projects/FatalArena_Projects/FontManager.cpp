@@ -0,0 +1,108 @@
+﻿#include "FontManager.h"
+#include "Statistics.h"
+#include <DxLib.h>
+#include <cassert>
+#include <cstdio>
+#include <iterator>
+
+namespace {
+	// 起動時に作成しておくフォント
+	// (シーン切り替えやポップアップの表示で作成待ちにならないよう、
+	//   複数のシーンで使う既定のフォントをまとめておく)
+	constexpr int kDefaultFontThickness = 3;
+	constexpr int kPreloadFontSizes[] = { 56, 64, 92, 96, 128 };
+}
+
+FontManager& FontManager::GetInstance()
+{
+	// 初実行時にメモリ確保
+	static FontManager manager;
+	return manager;
+}
+
+void FontManager::LoadResources()
+{
+#ifdef _DEBUG
+	const long long startTime = GetNowHiPerformanceCount();
+#endif // _DEBUG
+	for (int size : kPreloadFontSizes) {
+		// 参照は持たず、作成だけしておく
+		Release(Acquire(Statistics::kDefaultFontName, size, kDefaultFontThickness,
+			DX_FONTTYPE_ANTIALIASING_EDGE));
+	}
+#ifdef _DEBUG
+	printf("Font preload : %d fonts, %.3f ms\n",
+		static_cast<int>(std::size(kPreloadFontSizes)),
+		(GetNowHiPerformanceCount() - startTime) / 1000.0);
+#endif // _DEBUG
+}
+
+void FontManager::ReleaseResources()
+{
+	// 終了時はシーンが参照を持ったままのため、参照に関わらず削除する
+	for (auto& pair : _fonts) {
+		Entry& entry = pair.second;
+		entry.atlas.reset();
+		DeleteFontToHandle(entry.handle);
+	}
+	_fonts.clear();
+}
+
+int FontManager::Acquire(const std::wstring& name, int size, int thickness, int type)
+{
+	const FontDesc desc = { name, size, thickness, type };
+	auto it = _fonts.find(desc);
+	if (it == _fonts.end()) {
+		const long long startTime = GetNowHiPerformanceCount();
+		Entry entry;
+		entry.handle = CreateFontToHandle(name.c_str(), size, thickness, type);
+		assert(entry.handle >= 0 && "フォントの作成に失敗");
+		RecordCreateTime(L"Font", desc, GetNowHiPerformanceCount() - startTime);
+		it = _fonts.emplace(desc, std::move(entry)).first;
+	}
+	++it->second.refCount;
+	return it->second.handle;
+}
+
+void FontManager::Release(int fontHandle)
+{
+	// ReleaseResources後に破棄されたものは何もしない
+	auto it = FindFont(fontHandle);
+	if (it == _fonts.end()) return;
+	assert(it->second.refCount > 0 && "取得していないフォントを解放しようとした");
+	// 参照がなくなっても次に使うときのために残しておく
+	--it->second.refCount;
+}
+
+const GlyphAtlas& FontManager::GetAtlas(int fontHandle)
+{
+	auto it = FindFont(fontHandle);
+	assert(it != _fonts.end() && "取得していないフォントのアトラスを求めた");
+	Entry& entry = it->second;
+	if (!entry.atlas) {
+		const long long startTime = GetNowHiPerformanceCount();
+		entry.atlas = std::make_unique<GlyphAtlas>();
+		entry.atlas->Create(fontHandle);
+		RecordCreateTime(L"Atlas", it->first, GetNowHiPerformanceCount() - startTime);
+	}
+	return *entry.atlas;
+}
+
+FontManager::FontMap_t::iterator FontManager::FindFont(int fontHandle)
+{
+	// フォントの種類は少ないため順に探す
+	for (auto it = _fonts.begin(); it != _fonts.end(); ++it) {
+		if (it->second.handle == fontHandle) return it;
+	}
+	return _fonts.end();
+}
+
+void FontManager::RecordCreateTime(const wchar_t* what, const FontDesc& desc, long long time)
+{
+	++_createCount;
+	_totalCreateTime += time;
+#ifdef _DEBUG
+	printf("%ls created : %ls %d (%.3f ms, total %.3f ms)\n",
+		what, desc.name.c_str(), desc.size, time / 1000.0, _totalCreateTime / 1000.0);
+#endif // _DEBUG
+}
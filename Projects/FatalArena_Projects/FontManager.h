@@ -0,0 +1,107 @@
+﻿#pragma once
+#include "GlyphAtlas.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+
+/// <summary>
+/// フォントの作成に使う設定
+/// </summary>
+struct FontDesc
+{
+	std::wstring name;
+	int size = -1;
+	int thickness = -1;
+	int type = -1;	// DX_FONTTYPE_～
+
+	bool operator<(const FontDesc& other) const
+	{
+		return std::tie(name, size, thickness, type) <
+			std::tie(other.name, other.size, other.thickness, other.type);
+	}
+};
+
+/// <summary>
+/// フォントを設定ごとに1つだけ作成し、各シーンで共有するシングルトンクラス
+/// 参照がなくなってもフォントは保持し、再び使われた際に作り直さないようにする
+/// </summary>
+class FontManager
+{
+private:
+	FontManager() :
+		_fonts(),
+		_createCount(0),
+		_totalCreateTime(0)
+	{
+	}
+	FontManager(const FontManager&) = delete;
+	void operator=(const FontManager&) = delete;
+
+public:
+	static FontManager& GetInstance();
+
+	/// <summary>
+	/// 複数のシーンで使うフォントを起動時に作成しておく
+	/// </summary>
+	void LoadResources();
+
+	/// <summary>
+	/// 作成したフォントをすべて削除する
+	/// 以降のReleaseは何もしない
+	/// </summary>
+	void ReleaseResources();
+
+	/// <summary>
+	/// フォントを取得する(なければ作成する)
+	/// 使い終わったらReleaseを呼ぶこと
+	/// </summary>
+	/// <returns>フォントハンドル</returns>
+	int Acquire(const std::wstring& name, int size, int thickness, int type);
+
+	/// <summary>
+	/// Acquireで取得したフォントの参照を返す
+	/// </summary>
+	void Release(int fontHandle);
+
+	/// <summary>
+	/// フォントの文字をまとめたアトラスを返す(なければ作成する)
+	/// 描画先が切り替わるため、描画処理の途中では呼ばないこと
+	/// </summary>
+	const GlyphAtlas& GetAtlas(int fontHandle);
+
+	/// <summary>
+	/// これまでにフォントとアトラスを作成した回数
+	/// </summary>
+	int GetCreateCount() const { return _createCount; }
+	/// <summary>
+	/// これまでにフォントとアトラスの作成にかかった時間の合計(マイクロ秒)
+	/// </summary>
+	long long GetTotalCreateTime() const { return _totalCreateTime; }
+
+private:
+	// フォントごとの情報
+	struct Entry
+	{
+		int handle = -1;
+		int refCount = 0;
+		std::unique_ptr<GlyphAtlas> atlas;
+	};
+
+	using FontMap_t = std::map<FontDesc, Entry>;
+
+	/// <summary>
+	/// ハンドルからフォントを探す(なければend)
+	/// </summary>
+	FontMap_t::iterator FindFont(int fontHandle);
+
+	/// <summary>
+	/// 作成にかかった時間を記録する(Debugでは出力もする)
+	/// </summary>
+	void RecordCreateTime(const wchar_t* what, const FontDesc& desc, long long time);
+
+	FontMap_t _fonts;
+
+	int _createCount;
+	long long _totalCreateTime;
+};
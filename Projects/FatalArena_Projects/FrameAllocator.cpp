@@ -0,0 +1,57 @@
+﻿#include "FrameAllocator.h"
+#include <cassert>
+#include <cstdint>
+
+namespace {
+	// 1フレームで使用できる領域の大きさ
+	constexpr size_t kCapacity = 1024 * 1024;
+}
+
+FrameAllocator& FrameAllocator::GetInstance()
+{
+	static FrameAllocator instance;
+	return instance;
+}
+
+FrameAllocator::FrameAllocator() :
+	_buffer(std::make_unique<std::byte[]>(kCapacity)),
+	_capacity(kCapacity),
+	_offset(0),
+	_peakSize(0)
+{
+}
+
+void* FrameAllocator::Allocate(size_t size, size_t alignment)
+{
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0 && "アライメントが2の累乗でない");
+
+	// 切り出す位置を他のスレッドと競合しないよう進める
+	size_t offset = _offset.load(std::memory_order_relaxed);
+	size_t alignedOffset = 0;
+	do {
+		const uintptr_t address = reinterpret_cast<uintptr_t>(_buffer.get()) + offset;
+		const uintptr_t alignedAddress = (address + alignment - 1) & ~(alignment - 1);
+		alignedOffset = offset + (alignedAddress - address);
+		if (alignedOffset + size > _capacity) {
+			// 足りない場合は呼び出し側で別途確保してもらう
+			return nullptr;
+		}
+	} while (!_offset.compare_exchange_weak(offset, alignedOffset + size, std::memory_order_relaxed));
+
+	return _buffer.get() + alignedOffset;
+}
+
+void FrameAllocator::Reset()
+{
+	const size_t used = _offset.load(std::memory_order_relaxed);
+	if (used > _peakSize) {
+		_peakSize = used;
+	}
+	_offset.store(0, std::memory_order_relaxed);
+}
+
+bool FrameAllocator::IsOwned(const void* ptr) const
+{
+	const std::byte* p = static_cast<const std::byte*>(ptr);
+	return (p >= _buffer.get() && p < _buffer.get() + _capacity);
+}
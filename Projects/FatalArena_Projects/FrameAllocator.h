@@ -0,0 +1,93 @@
+﻿#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/// <summary>
+/// 1フレームの間だけ使う一時データ用の線形アロケータ
+/// 先頭から順に切り出すだけで個別の解放は行わず、フレームの始めにまとめて巻き戻す
+/// 切り出しは複数のスレッドから同時に行ってよい
+/// </summary>
+class FrameAllocator final
+{
+public:
+	/// <summary>
+	/// シングルトンオブジェクトを返す
+	/// </summary>
+	static FrameAllocator& GetInstance();
+
+	/// <summary>
+	/// 指定サイズの領域を切り出す
+	/// 確保済みの領域が足りない場合はnullptrを返す
+	/// </summary>
+	void* Allocate(size_t size, size_t alignment);
+
+	/// <summary>
+	/// 切り出した領域を全て破棄する
+	/// フレームの始め(ジョブが動いていない時)にメインスレッドから呼ぶ
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// 指定の領域がこのアロケータから切り出されたものか
+	/// </summary>
+	bool IsOwned(const void* ptr) const;
+
+	/// <summary>
+	/// 今のフレームで使用したサイズ
+	/// </summary>
+	size_t GetUsedSize() const { return _offset.load(std::memory_order_relaxed); }
+
+	/// <summary>
+	/// これまでのフレームで使用したサイズの最大値
+	/// </summary>
+	size_t GetPeakSize() const { return _peakSize; }
+
+private:
+	FrameAllocator();
+	FrameAllocator(const FrameAllocator&) = delete;
+	void operator=(const FrameAllocator&) = delete;
+
+	std::unique_ptr<std::byte[]> _buffer;
+	size_t _capacity;
+	std::atomic<size_t> _offset;
+	size_t _peakSize;
+};
+
+/// <summary>
+/// FrameAllocatorから領域を切り出すSTLコンテナ用のアロケータ
+/// フレームを跨いで保持するコンテナには使わないこと
+/// 領域が足りない場合は通常のヒープから確保する
+/// </summary>
+template<typename T>
+class FrameStlAllocator
+{
+public:
+	using value_type = T;
+
+	FrameStlAllocator() = default;
+	template<typename U>
+	FrameStlAllocator(const FrameStlAllocator<U>&) {}
+
+	T* allocate(size_t n)
+	{
+		void* ptr = FrameAllocator::GetInstance().Allocate(sizeof(T) * n, alignof(T));
+		if (ptr == nullptr) {
+			ptr = ::operator new(sizeof(T) * n);
+		}
+		return static_cast<T*>(ptr);
+	}
+
+	void deallocate(T* ptr, size_t)
+	{
+		// フレームの領域は巻き戻しでまとめて破棄する
+		if (!FrameAllocator::GetInstance().IsOwned(ptr)) {
+			::operator delete(ptr);
+		}
+	}
+
+	template<typename U>
+	bool operator==(const FrameStlAllocator<U>&) const { return true; }
+	template<typename U>
+	bool operator!=(const FrameStlAllocator<U>&) const { return false; }
+};
@@ -1,6 +1,7 @@
 ﻿#include "GameManager.h"
 #include "Player.h"
 #include "WaveManager.h"
+#include "SnapshotArchive.h"
 #include <algorithm>
 #include <cassert>
 
@@ -113,3 +114,19 @@ int GameManager::GetResultScreenHandle() const
 void GameManager::ReleaseResultScreen()
 {
 }
+
+void GameManager::SaveSnapshot(SnapshotWriter& writer) const
+{
+	writer.Write(_enemyDefeatScore);
+	writer.Write(_clearTime);
+	writer.Write(_timeBonusScore);
+	writer.Write(_isClear);
+}
+
+void GameManager::LoadSnapshot(SnapshotReader& reader)
+{
+	reader.Read(_enemyDefeatScore);
+	reader.Read(_clearTime);
+	reader.Read(_timeBonusScore);
+	reader.Read(_isClear);
+}
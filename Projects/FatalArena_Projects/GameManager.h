@@ -3,6 +3,8 @@
 
 class Player;
 class WaveManager;
+class SnapshotWriter;
+class SnapshotReader;
 
 // シングルトンとして実装
 class GameManager final {
@@ -92,6 +94,12 @@ public:
 	/// </summary>
 	void ReleaseResultScreen();
 
+	/// <summary>
+	/// スコアとクリアタイムを書き込む・読み込む
+	/// </summary>
+	void SaveSnapshot(SnapshotWriter& writer) const;
+	void LoadSnapshot(SnapshotReader& reader);
+
 
 	// getter
 	int GetTotalScore() const { return _enemyDefeatScore + _timeBonusScore; }
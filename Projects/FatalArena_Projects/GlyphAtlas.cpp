@@ -0,0 +1,199 @@
+﻿#include "GlyphAtlas.h"
+#include "UIBatcher.h"
+#include <DxLib.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+	// アトラスの1行に並べる文字数
+	constexpr int kAtlasColumnNum = 16;
+	// 文字がはみ出す分として、縁取りに加えて空ける幅(フォントサイズに対する割合)
+	constexpr float kOverhangRate = 0.125f;
+
+	// 文字は白で描画しておき、頂点の色で着色する
+	const unsigned int kGlyphColor = GetColor(255, 255, 255);
+	const unsigned int kGlyphEdgeColor = GetColor(0, 0, 0);
+
+	/// <summary>
+	/// 指定の値以上の最小の2のべき乗を返す
+	/// </summary>
+	int ToPowerOfTwo(int value)
+	{
+		int result = 1;
+		while (result < value) result <<= 1;
+		return result;
+	}
+}
+
+GlyphAtlas::GlyphAtlas() :
+	_graphHandle(-1),
+	_glyphs(),
+	_cellWidth(0),
+	_cellHeight(0),
+	_padding(0),
+	_lineHeight(0)
+{
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+	Release();
+}
+
+void GlyphAtlas::Create(int fontHandle)
+{
+	assert(fontHandle >= 0 && "フォントが正しくない");
+	Release();
+
+	// 1文字分の大きさを求める
+	const int fontSize = GetFontSizeToHandle(fontHandle);
+	_lineHeight = GetFontLineSpaceToHandle(fontHandle);
+	_padding = GetFontEdgeSizeToHandle(fontHandle) + static_cast<int>(std::ceil(fontSize * kOverhangRate));
+
+	int maxAdvance = 0;
+	for (int i = 0; i < kGlyphNum; ++i) {
+		const wchar_t str[2] = { static_cast<wchar_t>(kFirstChar + i), L'\0' };
+		_glyphs[i].advance = GetDrawStringWidthToHandle(str, 1, fontHandle);
+		maxAdvance = std::max<int>(maxAdvance, _glyphs[i].advance);
+	}
+	_cellWidth = maxAdvance + _padding * 2;
+	_cellHeight = _lineHeight + _padding * 2;
+
+	// 環境によって2のべき乗以外の大きさが拡張されUVがずれないよう、2のべき乗にしておく
+	const int rowNum = (kGlyphNum + kAtlasColumnNum - 1) / kAtlasColumnNum;
+	const int atlasWidth = ToPowerOfTwo(_cellWidth * kAtlasColumnNum);
+	const int atlasHeight = ToPowerOfTwo(_cellHeight * rowNum);
+	_graphHandle = MakeScreen(atlasWidth, atlasHeight, true);
+	assert(_graphHandle >= 0 && "アトラスの作成に失敗");
+
+	// 透明で塗りつぶしてから各文字を描画する
+	FillGraph(_graphHandle, 0, 0, 0, 0);
+	const int prevScreen = GetDrawScreen();
+	SetDrawScreen(_graphHandle);
+	SetDrawBlendMode(DX_BLENDMODE_NOBLEND, 0);
+	for (int i = 0; i < kGlyphNum; ++i) {
+		const int cellX = (i % kAtlasColumnNum) * _cellWidth;
+		const int cellY = (i / kAtlasColumnNum) * _cellHeight;
+		const wchar_t str[2] = { static_cast<wchar_t>(kFirstChar + i), L'\0' };
+		DrawStringToHandle(cellX + _padding, cellY + _padding, str, kGlyphColor, fontHandle, kGlyphEdgeColor);
+
+		Glyph& glyph = _glyphs[i];
+		glyph.u0 = static_cast<float>(cellX) / atlasWidth;
+		glyph.v0 = static_cast<float>(cellY) / atlasHeight;
+		glyph.u1 = static_cast<float>(cellX + _cellWidth) / atlasWidth;
+		glyph.v1 = static_cast<float>(cellY + _cellHeight) / atlasHeight;
+	}
+	SetDrawScreen(prevScreen);
+}
+
+void GlyphAtlas::Release()
+{
+	if (_graphHandle >= 0) {
+		DeleteGraph(_graphHandle);
+		_graphHandle = -1;
+	}
+}
+
+TextLayout GlyphAtlas::BuildLayout(const std::wstring& text) const
+{
+	assert(IsCreated() && "アトラスが作成されていない");
+
+	TextLayout layout;
+	layout.quads.reserve(text.length());
+	int x = 0;
+	int y = 0;
+	for (wchar_t c : text) {
+		if (c == L'\n') {
+			layout.width = std::max<int>(layout.width, x);
+			x = 0;
+			y += _lineHeight;
+			continue;
+		}
+		const int glyph = ToGlyphIndex(c);
+		assert(glyph >= 0 && "アトラスにない文字が含まれている");
+		if (glyph < 0) continue;
+
+		// 空白は幅だけ進める
+		if (c != L' ') {
+			layout.quads.push_back({ glyph, static_cast<float>(x), static_cast<float>(y) });
+		}
+		x += _glyphs[glyph].advance;
+	}
+	layout.width = std::max<int>(layout.width, x);
+	layout.height = y + _lineHeight;
+	return layout;
+}
+
+void GlyphAtlas::DrawLayout(UIBatcher& batcher, const TextLayout& layout, float x, float y,
+	unsigned int color) const
+{
+	for (const auto& quad : layout.quads) {
+		AddGlyph(batcher, quad.glyph, x + quad.x, y + quad.y, color);
+	}
+}
+
+int GlyphAtlas::DrawNumber(UIBatcher& batcher, int value, int digitNum, float x, float y,
+	unsigned int color) const
+{
+	int digits[kMaxDigitNum];
+	const int count = SplitDigits(value, digitNum, digits);
+
+	int penX = 0;
+	for (int i = 0; i < count; ++i) {
+		const int glyph = ToGlyphIndex(static_cast<wchar_t>(L'0' + digits[i]));
+		AddGlyph(batcher, glyph, x + penX, y, color);
+		penX += _glyphs[glyph].advance;
+	}
+	return penX;
+}
+
+int GlyphAtlas::MeasureNumber(int value, int digitNum) const
+{
+	int digits[kMaxDigitNum];
+	const int count = SplitDigits(value, digitNum, digits);
+
+	int width = 0;
+	for (int i = 0; i < count; ++i) {
+		width += _glyphs[ToGlyphIndex(static_cast<wchar_t>(L'0' + digits[i]))].advance;
+	}
+	return width;
+}
+
+int GlyphAtlas::ToGlyphIndex(wchar_t c)
+{
+	if (c < kFirstChar || c > kLastChar) return -1;
+	return c - kFirstChar;
+}
+
+void GlyphAtlas::AddGlyph(UIBatcher& batcher, int glyph, float x, float y, unsigned int color) const
+{
+	// 画素の境界に合わせて描画し、文字がぼやけないようにする
+	const float left = std::floor(x) - _padding;
+	const float top = std::floor(y) - _padding;
+	const Glyph& g = _glyphs[glyph];
+	batcher.AddSprite(_graphHandle, left, top, left + _cellWidth, top + _cellHeight,
+		g.u0, g.v0, g.u1, g.v1, color);
+}
+
+int GlyphAtlas::SplitDigits(int value, int digitNum, int (&digits)[kMaxDigitNum])
+{
+	assert(value >= 0 && "負の値は描画できない");
+	value = std::max<int>(value, 0);
+	digitNum = std::clamp<int>(digitNum, 1, kMaxDigitNum);
+
+	// 下の桁から求めて、上の桁から並ぶよう後ろから詰める
+	int reversed[kMaxDigitNum];
+	int count = 0;
+	do {
+		reversed[count++] = value % 10;
+		value /= 10;
+	} while (value > 0 && count < kMaxDigitNum);
+	while (count < digitNum) {
+		reversed[count++] = 0;
+	}
+	for (int i = 0; i < count; ++i) {
+		digits[i] = reversed[count - 1 - i];
+	}
+	return count;
+}
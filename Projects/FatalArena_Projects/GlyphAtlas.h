@@ -0,0 +1,123 @@
+﻿#pragma once
+#include <array>
+#include <string>
+#include <vector>
+
+class UIBatcher;
+
+/// <summary>
+/// 文字列を描画する位置を事前に計算したもの
+/// 内容が変わらない文字列はこれを保持しておき、毎フレームの計算をなくす
+/// </summary>
+struct TextLayout
+{
+	// 1文字分の配置
+	struct Quad
+	{
+		int glyph = 0;	// アトラス内の文字番号
+		float x = 0.0f;	// 描画開始位置からのずれ
+		float y = 0.0f;
+	};
+	std::vector<Quad> quads;
+	int width = 0;	// 最も長い行の幅
+	int height = 0;	// 全ての行の高さ
+};
+
+/// <summary>
+/// フォントの文字を1枚の画像にまとめて描画しておき、
+/// 文字列を画像の切り抜きの並びとして描画する
+/// 描画はUIBatcherに追加するため、同じアトラスの文字は1回の描画にまとまる
+/// 対応する文字はASCIIの表示可能な文字のみ
+/// </summary>
+class GlyphAtlas final
+{
+public:
+	GlyphAtlas();
+	~GlyphAtlas();
+	// 画像を所有するためコピーしない
+	GlyphAtlas(const GlyphAtlas&) = delete;
+	void operator=(const GlyphAtlas&) = delete;
+
+	/// <summary>
+	/// フォントの文字をアトラスに描画する
+	/// 描画先が切り替わるため、描画処理の途中では呼ばないこと
+	/// </summary>
+	/// <param name="fontHandle">CreateFontToHandleで作成したフォント</param>
+	void Create(int fontHandle);
+
+	/// <summary>
+	/// アトラスを解放する
+	/// </summary>
+	void Release();
+
+	bool IsCreated() const { return _graphHandle >= 0; }
+
+	/// <summary>
+	/// 文字列の配置を計算する('\n'で改行する)
+	/// </summary>
+	TextLayout BuildLayout(const std::wstring& text) const;
+
+	/// <summary>
+	/// 計算済みの文字列を追加する
+	/// </summary>
+	/// <param name="x">左上のX座標(DrawStringToHandleと同じ基準)</param>
+	/// <param name="color">文字の色(縁の色は変わらない)</param>
+	void DrawLayout(UIBatcher& batcher, const TextLayout& layout, float x, float y,
+		unsigned int color) const;
+
+	/// <summary>
+	/// 0以上の整数を文字列に変換せずに追加する
+	/// </summary>
+	/// <param name="digitNum">最低の桁数(足りない桁は0で埋める)</param>
+	/// <returns>描画した幅</returns>
+	int DrawNumber(UIBatcher& batcher, int value, int digitNum, float x, float y,
+		unsigned int color) const;
+
+	/// <summary>
+	/// DrawNumberで描画される幅を返す
+	/// </summary>
+	int MeasureNumber(int value, int digitNum) const;
+
+	int GetLineHeight() const { return _lineHeight; }
+
+private:
+	// アトラスに含める文字の範囲(' 'から'~'まで)
+	static constexpr wchar_t kFirstChar = L' ';
+	static constexpr wchar_t kLastChar = L'~';
+	static constexpr int kGlyphNum = kLastChar - kFirstChar + 1;
+	// 整数の最大桁数
+	static constexpr int kMaxDigitNum = 10;
+
+	// 1文字分の情報
+	struct Glyph
+	{
+		float u0 = 0.0f;
+		float v0 = 0.0f;
+		float u1 = 0.0f;
+		float v1 = 0.0f;
+		int advance = 0;	// 次の文字までの幅
+	};
+
+	/// <summary>
+	/// 文字から文字番号を求める(アトラスにない文字は-1)
+	/// </summary>
+	static int ToGlyphIndex(wchar_t c);
+
+	/// <summary>
+	/// 1文字分を追加する
+	/// </summary>
+	void AddGlyph(UIBatcher& batcher, int glyph, float x, float y, unsigned int color) const;
+
+	/// <summary>
+	/// 整数を上の桁から順に分解する
+	/// </summary>
+	/// <returns>桁数</returns>
+	static int SplitDigits(int value, int digitNum, int (&digits)[kMaxDigitNum]);
+
+	int _graphHandle;
+	std::array<Glyph, kGlyphNum> _glyphs;
+	int _cellWidth;		// 1文字分の切り抜きの大きさ
+	int _cellHeight;
+	int _padding;		// 縁取りのために文字の周りに空ける幅
+	int _lineHeight;	// 改行の幅
+};
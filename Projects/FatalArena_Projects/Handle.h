@@ -0,0 +1,141 @@
+﻿#pragma once
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+template<typename T>
+class SlotMap;
+
+/// <summary>
+/// オブジェクトを参照するための識別番号
+/// 位置(下位)と世代(上位)を32bitにまとめたもので、コピーしても参照カウントは変化しない
+/// 参照先が破棄された後は世代が一致しなくなるため、nullptrに解決される
+/// </summary>
+template<typename T>
+class Handle final
+{
+public:
+	Handle() : _value(kNullValue) {}
+
+	/// <summary>
+	/// 参照先を返す(破棄済みならnullptr)
+	/// </summary>
+	T* Get() const { return SlotMap<T>::GetInstance().Get(*this); }
+
+	/// <summary>
+	/// 参照先が存在するか
+	/// </summary>
+	bool IsValid() const { return Get() != nullptr; }
+
+	/// <summary>
+	/// 参照先を返す
+	/// 参照先が破棄されている場合はdebugならassertを投げる
+	/// </summary>
+	T* operator->() const
+	{
+		T* object = Get();
+		assert(object != nullptr && "破棄されたオブジェクトを参照しようとした");
+		return object;
+	}
+
+	bool operator==(const Handle& other) const { return _value == other._value; }
+	bool operator!=(const Handle& other) const { return _value != other._value; }
+
+private:
+	friend class SlotMap<T>;
+
+	static constexpr uint32_t kIndexBits = 20;
+	static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+	static constexpr uint32_t kGenerationMask = (1u << (32 - kIndexBits)) - 1;
+	static constexpr uint32_t kNullValue = UINT32_MAX;
+
+	Handle(uint32_t index, uint32_t generation) :
+		_value((generation << kIndexBits) | index)
+	{
+	}
+
+	uint32_t GetIndex() const { return _value & kIndexMask; }
+	uint32_t GetGeneration() const { return _value >> kIndexBits; }
+
+	uint32_t _value;
+};
+
+/// <summary>
+/// Handleからオブジェクトを引くための表(型ごとのシングルトン)
+/// オブジェクトは所有せず、登録と解除は参照される側が行う
+/// </summary>
+template<typename T>
+class SlotMap final
+{
+public:
+	/// <summary>
+	/// シングルトンオブジェクトを返す
+	/// </summary>
+	static SlotMap& GetInstance()
+	{
+		// 終了時の破棄の順番に依存しないよう解放しない
+		static SlotMap* instance = new SlotMap();
+		return *instance;
+	}
+
+	/// <summary>
+	/// オブジェクトを登録し、参照するためのHandleを返す
+	/// </summary>
+	Handle<T> Insert(T* object)
+	{
+		assert(object != nullptr && "登録するオブジェクトが存在しない");
+		uint32_t index = 0;
+		if (!_freeIndices.empty()) {
+			index = _freeIndices.back();
+			_freeIndices.pop_back();
+		}
+		else {
+			index = static_cast<uint32_t>(_slots.size());
+			assert(index < Handle<T>::kIndexMask && "登録できる数を超えた");
+			_slots.emplace_back();
+		}
+		_slots[index].object = object;
+		return Handle<T>(index, _slots[index].generation);
+	}
+
+	/// <summary>
+	/// 登録を解除する
+	/// 以降、このHandleと同じものはnullptrに解決される
+	/// </summary>
+	void Remove(Handle<T> handle)
+	{
+		if (Get(handle) == nullptr) return;
+		Slot& slot = _slots[handle.GetIndex()];
+		slot.object = nullptr;
+		// 世代を進めて古いHandleを無効にする
+		slot.generation = (slot.generation + 1) & Handle<T>::kGenerationMask;
+		_freeIndices.emplace_back(handle.GetIndex());
+	}
+
+	/// <summary>
+	/// Handleから参照先を返す(破棄済みならnullptr)
+	/// </summary>
+	T* Get(Handle<T> handle) const
+	{
+		if (handle._value == Handle<T>::kNullValue) return nullptr;
+		const uint32_t index = handle.GetIndex();
+		if (index >= _slots.size()) return nullptr;
+		const Slot& slot = _slots[index];
+		if (slot.generation != handle.GetGeneration()) return nullptr;
+		return slot.object;
+	}
+
+private:
+	SlotMap() = default;
+	SlotMap(const SlotMap&) = delete;
+	void operator=(const SlotMap&) = delete;
+
+	struct Slot
+	{
+		T* object = nullptr;
+		uint32_t generation = 0;
+	};
+
+	std::vector<Slot> _slots;
+	std::vector<uint32_t> _freeIndices;
+};
@@ -18,6 +18,31 @@ Input& Input::GetInstance() {
 void Input::Update() {
     _last = _current;
 
+    // 今フレームの入力を決める
+    InputReplay::Frame frame;
+    if (_replayMode == ReplayMode::Playback) {
+        // 記録した入力を周辺機器の代わりに使う
+        if (!_replay.Read(frame)) {
+            // 最後まで再生したら周辺機器の入力に戻す
+            _replayMode = ReplayMode::None;
+            _isReplayFinished = true;
+            frame = ReadHardwareFrame();
+        }
+    }
+    else {
+        frame = ReadHardwareFrame();
+        if (_replayMode == ReplayMode::Recording) {
+            _replay.Record(frame);
+        }
+    }
+
+    ApplyFrame(frame);
+}
+
+InputReplay::Frame Input::ReadHardwareFrame()
+{
+    InputReplay::Frame frame;
+
     // 直前の情報をコピー
     std::copy(std::begin(_currentRawKeybdState), std::end(_currentRawKeybdState), std::begin(_lastRawKeybdState));
     _lastRawPadState = _currentRawPadState;
@@ -26,55 +51,106 @@ void Input::Update() {
     _currentRawPadState = GetJoypadInputState(DX_INPUT_PAD1);//パッド１の状態を取得
 
     //入力チェック(生の入力をゲームのイベントに変換していく)
+    PeripheralType inputType = _lastInputType;
+    int actionIndex = 0;
     for (const auto& inputRow : _inputTable) {
-        // 行のキー
-        const std::string& key = inputRow.first;
-        // 「押してる状態」の初期化
-        if (_current.find(key) != _current.end()) {
-            _current[key] = false;
-        }
-        
-        PeripheralType inputType = _lastInputType;
+        bool isPress = false;
 
         // 入力定義vectorのループ
         for (const auto& hardInput : inputRow.second) {
             if (hardInput.type == PeripheralType::keybd) {
-                _current[key] = _currentRawKeybdState[hardInput.id];
+                isPress = _currentRawKeybdState[hardInput.id];
             }
             else if (hardInput.type == PeripheralType::pad1) {
-                _current[key] = hardInput.id & _currentRawPadState;
+                isPress = hardInput.id & _currentRawPadState;
             }
             // どれか一つでも「押されている」状態ならもう調べない
             // 機器の情報が欲しいわけではない為、誰かが押されていればもうOK
-            if (_current[key]) {
+            if (isPress) {
                 inputType = hardInput.type;
                 break;
             }
         }
 
-        _lastInputType = inputType;
+        if (isPress) {
+            frame.actionBits |= (1u << actionIndex);
+        }
+        ++actionIndex;
     }
+    frame.lastInputType = static_cast<uint8_t>(inputType);
 
-    // 左右スティック更新
+    // 左右スティック
     int xInput, zInput;
     GetJoypadAnalogInputRight(&xInput, &zInput, DX_INPUT_PAD1);
-    _currentRightStickInput = { static_cast<float>(xInput), 0, static_cast<float>(zInput) };
+    frame.rightStickX = static_cast<int16_t>(xInput);
+    frame.rightStickZ = static_cast<int16_t>(zInput);
+    GetJoypadAnalogInput(&xInput, &zInput, DX_INPUT_PAD1);
+    frame.leftStickX = static_cast<int16_t>(xInput);
+    frame.leftStickZ = static_cast<int16_t>(zInput);
+
+    // マウス
+    frame.mouseState = static_cast<uint8_t>(GetMouseInput());
+    GetMousePoint(&xInput, &zInput);
+    frame.mouseX = static_cast<int16_t>(xInput);
+    frame.mouseY = static_cast<int16_t>(zInput);
+
+    return frame;
+}
+
+void Input::ApplyFrame(const InputReplay::Frame& frame)
+{
+    // 入力テーブルの順に押されているかを反映
+    int actionIndex = 0;
+    for (const auto& inputRow : _inputTable) {
+        _current[inputRow.first] = (frame.actionBits & (1u << actionIndex)) != 0;
+        ++actionIndex;
+    }
+    _lastInputType = static_cast<PeripheralType>(frame.lastInputType);
+
+    // 左右スティック更新
+    _currentRightStickInput = { static_cast<float>(frame.rightStickX), 0, static_cast<float>(frame.rightStickZ) };
     if (_currentRightStickInput.SqrMagnitude() != 0.0f) {  // 入力があった場合更新
         _lastRightStickInput = _currentRightStickInput;
     }
-    GetJoypadAnalogInput(&xInput, &zInput, DX_INPUT_PAD1);
-    _currentLeftStickInput = { static_cast<float>(xInput), 0, static_cast<float>(zInput) };
+    _currentLeftStickInput = { static_cast<float>(frame.leftStickX), 0, static_cast<float>(frame.leftStickZ) };
     if (_currentLeftStickInput.SqrMagnitude() != 0.0f) {   // 入力があった場合更新
         _lastLeftStickInput = _currentLeftStickInput;
     }
 
     // マウスボタン更新
     _lastRawMouseState = _currentRawMouseState;
-    _currentRawMouseState = GetMouseInput();
+    _currentRawMouseState = frame.mouseState;
     // マウス位置更新
     _lastMousePosition = _currentMousePosition;
-    GetMousePoint(&xInput, &zInput);
-    _currentMousePosition = { static_cast<float>(xInput), 0, static_cast<float>(zInput) };
+    _currentMousePosition = { static_cast<float>(frame.mouseX), 0, static_cast<float>(frame.mouseY) };
+}
+
+void Input::StartRecording(uint64_t seed)
+{
+    assert(_replayMode == ReplayMode::None && "既に記録・再生している");
+    _replay.StartRecording(seed, static_cast<int>(_inputTable.size()));
+    _replayMode = ReplayMode::Recording;
+}
+
+bool Input::StopRecording(const std::wstring& path)
+{
+    if (_replayMode != ReplayMode::Recording) return false;
+    _replayMode = ReplayMode::None;
+    return _replay.Save(path);
+}
+
+bool Input::StartPlayback(const std::wstring& path)
+{
+    assert(_replayMode == ReplayMode::None && "既に記録・再生している");
+    if (!_replay.Load(path)) return false;
+    // 記録時と入力テーブルが異なると正しく再生できない
+    if (_replay.GetActionNum() != static_cast<int>(_inputTable.size())) {
+        assert(false && "記録時と入力テーブルの項目数が異なる");
+        return false;
+    }
+    _replayMode = ReplayMode::Playback;
+    _isReplayFinished = false;
+    return true;
 }
 
 bool Input::IsPress(const char* key) const {
@@ -195,10 +271,15 @@ Input::Input() :
     _currentRawMouseState(),
     _lastRawMouseState(),
     _currentMousePosition(),
-    _lastMousePosition()
+    _lastMousePosition(),
+    _replayMode(ReplayMode::None),
+    _replay(),
+    _isReplayFinished(false)
 {
     SetDefault();
     LoadInputTable();
+    // 押されているかを1フレーム32bitで記録するため
+    assert(_inputTable.size() <= 32 && "入力テーブルの項目数が多すぎる");
     // 一時テーブルにコピー
     _tempInputTable = _inputTable;
     // 表示順序初期化
@@ -271,6 +352,7 @@ void Input::SetDefault()
     _inputTable["Debug::NextScene2"] = { {PeripheralType::keybd, KEY_INPUT_O},
                             {PeripheralType::pad1, PAD_INPUT_7}     // LStartボタン
     };
+    _inputTable["Debug::RetryWave"] = { {PeripheralType::keybd, KEY_INPUT_R} };
 
     
     _tempInputTable = _inputTable;  // 一時テーブルにコピー
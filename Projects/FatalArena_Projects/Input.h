@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include "Vector3.h"
+#include "InputReplay.h"
 
 #include <map>
 #include <string>
@@ -128,6 +129,42 @@ public:
 	/// <returns></returns>
 	Vector3 GetMousePositionLast() const;
 
+	/// <summary>
+	/// 入力の記録を始める
+	/// 以降のUpdateで確定した入力を1フレームずつ記録する
+	/// </summary>
+	/// <param name="seed">試合の乱数のシード値</param>
+	void StartRecording(uint64_t seed);
+	/// <summary>
+	/// 入力の記録を終え、ファイルに書き出す
+	/// </summary>
+	/// <returns>成功したか</returns>
+	bool StopRecording(const std::wstring& path);
+
+	/// <summary>
+	/// 記録した入力の再生を始める
+	/// 以降のUpdateでは周辺機器の代わりに記録した入力を使う
+	/// </summary>
+	/// <returns>成功したか</returns>
+	bool StartPlayback(const std::wstring& path);
+	/// <summary>
+	/// 再生中のリプレイのシード値
+	/// </summary>
+	uint64_t GetReplaySeed() const { return _replay.GetSeed(); }
+	/// <summary>
+	/// 記録した入力を再生しているか
+	/// </summary>
+	bool IsPlayingReplay() const { return _replayMode == ReplayMode::Playback; }
+	/// <summary>
+	/// 入力を記録または再生しているか
+	/// (結果を再現できるよう、実行時間に依存する処理を避ける必要がある)
+	/// </summary>
+	bool IsReplayActive() const { return _replayMode != ReplayMode::None; }
+	/// <summary>
+	/// 記録した入力を最後まで再生し終えたか
+	/// </summary>
+	bool IsReplayFinished() const { return _isReplayFinished; }
+
 private:
 	Input();
 	Input(const Input&) = delete;
@@ -194,6 +231,25 @@ private:
 	/// <returns></returns>
 	int GetKeyboradState()const;
 
+	/// <summary>
+	/// 周辺機器の状態を取得し、入力テーブルに従って1フレーム分の入力にする
+	/// </summary>
+	InputReplay::Frame ReadHardwareFrame();
+	/// <summary>
+	/// 1フレーム分の入力を現在の入力として反映する
+	/// </summary>
+	void ApplyFrame(const InputReplay::Frame& frame);
+
+	// 入力の記録・再生の状態
+	enum class ReplayMode {
+		None,		// 周辺機器の入力をそのまま使う
+		Recording,	// 周辺機器の入力を使い、記録する
+		Playback,	// 記録した入力を使う
+	};
+	ReplayMode _replayMode;
+	InputReplay _replay;
+	bool _isReplayFinished;
+
 	/// <summary>
 	/// 現在のPAD状態を調べて最も
 	/// 若いキー入力を返す
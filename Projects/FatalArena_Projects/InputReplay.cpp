@@ -0,0 +1,195 @@
+﻿#include "InputReplay.h"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+	const std::string kReplaySignature = "rply";
+	constexpr uint32_t kReplayVersion = 1;
+
+	// 前のフレームから変化した項目を表すbit
+	enum FieldBit : uint16_t {
+		kFieldActionBits	= 1 << 0,
+		kFieldRightStickX	= 1 << 1,
+		kFieldRightStickZ	= 1 << 2,
+		kFieldLeftStickX	= 1 << 3,
+		kFieldLeftStickZ	= 1 << 4,
+		kFieldMouseState	= 1 << 5,
+		kFieldMouseX		= 1 << 6,
+		kFieldMouseY		= 1 << 7,
+		kFieldLastInputType	= 1 << 8,
+	};
+
+	// ファイルの先頭に書き込む情報
+	struct Header {
+		char signature[4];	// シグネチャ
+		uint32_t version;	// バージョン
+		uint64_t seed;		// 乱数のシード値
+		uint32_t actionNum;	// 入力テーブルの項目数
+		uint32_t frameCount;// フレーム数
+		uint32_t dataSize;	// 差分データのサイズ
+	};
+
+	template<typename T>
+	void WriteValue(std::vector<uint8_t>& data, const T& value)
+	{
+		const size_t pos = data.size();
+		data.resize(pos + sizeof(T));
+		std::memcpy(data.data() + pos, &value, sizeof(T));
+	}
+
+	template<typename T>
+	bool ReadValue(const std::vector<uint8_t>& data, size_t& pos, T& value)
+	{
+		if (pos + sizeof(T) > data.size()) return false;
+		std::memcpy(&value, data.data() + pos, sizeof(T));
+		pos += sizeof(T);
+		return true;
+	}
+}
+
+InputReplay::InputReplay() :
+	_seed(0),
+	_actionNum(0),
+	_frameCount(0),
+	_data(),
+	_prevFrame(),
+	_readPos(0),
+	_readFrameCount(0)
+{
+}
+
+InputReplay::~InputReplay()
+{
+}
+
+void InputReplay::StartRecording(uint64_t seed, int actionNum)
+{
+	_seed = seed;
+	_actionNum = actionNum;
+	_frameCount = 0;
+	_data.clear();
+	_prevFrame = Frame();
+}
+
+void InputReplay::Record(const Frame& frame)
+{
+	Encode(frame);
+	++_frameCount;
+}
+
+bool InputReplay::Save(const std::wstring& path) const
+{
+	FILE* fp = nullptr;
+	auto err = _wfopen_s(&fp, path.c_str(), L"wb");	// バイナリで「書き込み」
+	if (err != 0 || fp == nullptr) {
+		assert(false && "リプレイファイルを開けなかった");
+		return false;
+	}
+
+	Header header = {};
+	std::memcpy(header.signature, kReplaySignature.data(), sizeof(header.signature));
+	header.version = kReplayVersion;
+	header.seed = _seed;
+	header.actionNum = static_cast<uint32_t>(_actionNum);
+	header.frameCount = static_cast<uint32_t>(_frameCount);
+	header.dataSize = static_cast<uint32_t>(_data.size());
+	fwrite(&header, sizeof(header), 1, fp);
+	fwrite(_data.data(), 1, _data.size(), fp);
+
+	fclose(fp);
+	return true;
+}
+
+bool InputReplay::Load(const std::wstring& path)
+{
+	FILE* fp = nullptr;
+	auto err = _wfopen_s(&fp, path.c_str(), L"rb");	// バイナリで「読み込み」
+	if (err != 0 || fp == nullptr) {
+		assert(false && "リプレイファイルを開けなかった");
+		return false;
+	}
+
+	Header header = {};
+	bool isValid = (fread(&header, sizeof(header), 1, fp) == 1) &&
+		(std::memcmp(header.signature, kReplaySignature.data(), sizeof(header.signature)) == 0) &&
+		(header.version == kReplayVersion);
+	if (isValid) {
+		_data.resize(header.dataSize);
+		isValid = (fread(_data.data(), 1, _data.size(), fp) == _data.size());
+	}
+	fclose(fp);
+
+	if (!isValid) {
+		assert(false && "リプレイファイルの形式が正しくない");
+		_data.clear();
+		return false;
+	}
+
+	_seed = header.seed;
+	_actionNum = static_cast<int>(header.actionNum);
+	_frameCount = static_cast<int>(header.frameCount);
+	_prevFrame = Frame();
+	_readPos = 0;
+	_readFrameCount = 0;
+	return true;
+}
+
+bool InputReplay::Read(Frame& out)
+{
+	if (_readFrameCount >= _frameCount) return false;
+	if (!Decode(_prevFrame)) {
+		assert(false && "リプレイのデータが途中で途切れている");
+		_readFrameCount = _frameCount;
+		return false;
+	}
+	++_readFrameCount;
+	out = _prevFrame;
+	return true;
+}
+
+void InputReplay::Encode(const Frame& frame)
+{
+	uint16_t mask = 0;
+	if (frame.actionBits != _prevFrame.actionBits)		mask |= kFieldActionBits;
+	if (frame.rightStickX != _prevFrame.rightStickX)	mask |= kFieldRightStickX;
+	if (frame.rightStickZ != _prevFrame.rightStickZ)	mask |= kFieldRightStickZ;
+	if (frame.leftStickX != _prevFrame.leftStickX)		mask |= kFieldLeftStickX;
+	if (frame.leftStickZ != _prevFrame.leftStickZ)		mask |= kFieldLeftStickZ;
+	if (frame.mouseState != _prevFrame.mouseState)		mask |= kFieldMouseState;
+	if (frame.mouseX != _prevFrame.mouseX)				mask |= kFieldMouseX;
+	if (frame.mouseY != _prevFrame.mouseY)				mask |= kFieldMouseY;
+	if (frame.lastInputType != _prevFrame.lastInputType)mask |= kFieldLastInputType;
+
+	// 変化した項目のbitと、変化した項目の値だけを書き込む
+	WriteValue(_data, mask);
+	if (mask & kFieldActionBits)	WriteValue(_data, frame.actionBits);
+	if (mask & kFieldRightStickX)	WriteValue(_data, frame.rightStickX);
+	if (mask & kFieldRightStickZ)	WriteValue(_data, frame.rightStickZ);
+	if (mask & kFieldLeftStickX)	WriteValue(_data, frame.leftStickX);
+	if (mask & kFieldLeftStickZ)	WriteValue(_data, frame.leftStickZ);
+	if (mask & kFieldMouseState)	WriteValue(_data, frame.mouseState);
+	if (mask & kFieldMouseX)		WriteValue(_data, frame.mouseX);
+	if (mask & kFieldMouseY)		WriteValue(_data, frame.mouseY);
+	if (mask & kFieldLastInputType)	WriteValue(_data, frame.lastInputType);
+
+	_prevFrame = frame;
+}
+
+bool InputReplay::Decode(Frame& frame)
+{
+	uint16_t mask = 0;
+	if (!ReadValue(_data, _readPos, mask)) return false;
+
+	bool isValid = true;
+	if (mask & kFieldActionBits)	isValid &= ReadValue(_data, _readPos, frame.actionBits);
+	if (mask & kFieldRightStickX)	isValid &= ReadValue(_data, _readPos, frame.rightStickX);
+	if (mask & kFieldRightStickZ)	isValid &= ReadValue(_data, _readPos, frame.rightStickZ);
+	if (mask & kFieldLeftStickX)	isValid &= ReadValue(_data, _readPos, frame.leftStickX);
+	if (mask & kFieldLeftStickZ)	isValid &= ReadValue(_data, _readPos, frame.leftStickZ);
+	if (mask & kFieldMouseState)	isValid &= ReadValue(_data, _readPos, frame.mouseState);
+	if (mask & kFieldMouseX)		isValid &= ReadValue(_data, _readPos, frame.mouseX);
+	if (mask & kFieldMouseY)		isValid &= ReadValue(_data, _readPos, frame.mouseY);
+	if (mask & kFieldLastInputType)	isValid &= ReadValue(_data, _readPos, frame.lastInputType);
+	return isValid;
+}
@@ -0,0 +1,88 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// 1フレーム分の入力を記録し、後で同じ順に再生するためのデータ
+/// 前のフレームから変化した項目だけを書き込むことで小さく保つ
+/// </summary>
+class InputReplay final
+{
+public:
+	/// <summary>
+	/// 1フレーム分の入力(ボタン名への変換を済ませたもの)
+	/// </summary>
+	struct Frame
+	{
+		uint32_t actionBits = 0;	// 入力テーブルの順に、押されているかを1bitずつ
+		int16_t rightStickX = 0;
+		int16_t rightStickZ = 0;
+		int16_t leftStickX = 0;
+		int16_t leftStickZ = 0;
+		uint8_t mouseState = 0;
+		int16_t mouseX = 0;
+		int16_t mouseY = 0;
+		uint8_t lastInputType = 0;	// 最後に入力された機器
+	};
+
+	InputReplay();
+	~InputReplay();
+
+	/// <summary>
+	/// 記録した内容を破棄して記録を始める
+	/// </summary>
+	/// <param name="seed">試合の乱数のシード値</param>
+	/// <param name="actionNum">入力テーブルの項目数</param>
+	void StartRecording(uint64_t seed, int actionNum);
+
+	/// <summary>
+	/// 1フレーム分の入力を追記する
+	/// </summary>
+	void Record(const Frame& frame);
+
+	/// <summary>
+	/// 記録した内容をファイルに書き出す
+	/// </summary>
+	/// <returns>成功したか</returns>
+	bool Save(const std::wstring& path) const;
+
+	/// <summary>
+	/// ファイルを読み込み、先頭から再生できる状態にする
+	/// </summary>
+	/// <returns>成功したか</returns>
+	bool Load(const std::wstring& path);
+
+	/// <summary>
+	/// 次のフレームの入力を取り出す
+	/// </summary>
+	/// <returns>最後まで再生し終わっていればfalse</returns>
+	bool Read(Frame& out);
+
+	uint64_t GetSeed() const { return _seed; }
+	int GetActionNum() const { return _actionNum; }
+	int GetFrameCount() const { return _frameCount; }
+
+private:
+	/// <summary>
+	/// 前のフレームとの差分を書き込む
+	/// </summary>
+	void Encode(const Frame& frame);
+	/// <summary>
+	/// 読み込み位置から1フレーム分の差分を読み、前のフレームに反映する
+	/// </summary>
+	bool Decode(Frame& frame);
+
+	uint64_t _seed;
+	int _actionNum;
+	int _frameCount;
+
+	// 差分を書き込んだデータ
+	std::vector<uint8_t> _data;
+	// 差分の基準となる、直前に記録(再生)したフレーム
+	Frame _prevFrame;
+
+	// 再生中の読み込み位置
+	size_t _readPos;
+	int _readFrameCount;
+};
@@ -3,9 +3,23 @@
 #include "ColliderDataSphere.h"
 #include "Calculation.h"
 #include "Player.h"
+#include "RenderSnapshot.h"
+#include "SnapshotArchive.h"
 
 #include <DxLib.h>
 #include <cassert>
+#include <algorithm>
+
+namespace {
+	// 当たり判定の半径に対する、視界内判定に使用する境界球の半径の倍率
+	constexpr float kCullRadiusMul = 2.0f;
+}
+
+const ItemBase::UpdateFunc_t ItemBase::kUpdateStateTable[kUpdateStateNum] = {
+	&ItemBase::UpdateSpawning,
+	&ItemBase::UpdateIdle,
+	&ItemBase::UpdateDestroying,
+};
 
 ItemBase::ItemBase(BuffData data, int modelHandle, 
 	std::weak_ptr<PlayerBuffManager> manager) :
@@ -25,7 +39,9 @@ ItemBase::ItemBase(BuffData data, int modelHandle,
 	_data(data),
 	_isAlive(true),
 	_animFrame(0),
-	_totalAnimFrame(0)
+	_totalAnimFrame(0),
+	_cullRadius(0.0f),
+	_sourceModelHandle(-1)
 {
 	assert(_modelHandle >= 0 && "モデルハンドルが正しくない");
 
@@ -45,6 +61,7 @@ void ItemBase::Init(float colRad, Vector3 transOffset, Vector3 scale, Vector3 an
 	_transOffset = transOffset;
 	_rotAngle = angle;
 	_scale = scale;
+	_cullRadius = colRad * kCullRadiusMul;
 
 	// 当たり判定データ設定
 	SphereColliderDesc desc;
@@ -71,10 +88,19 @@ void ItemBase::Update()
 	(this->*_nowUpdateState)();
 }
 
-void ItemBase::Draw()
+void ItemBase::WriteSnapshot(RenderSnapshot& snapshot) const
 {
-	// 描画
-	MV1DrawModel(_modelHandle);
+	BoundingSphere bounds;
+	bounds.center = GetPos();
+	bounds.radius = _cullRadius;
+
+	// 位置は更新時にモデルへ設定済み
+	snapshot.AddModel(_modelHandle, bounds, _sourceModelHandle);
+}
+
+void ItemBase::SetSourceModel(int sourceHandle)
+{
+	_sourceModelHandle = sourceHandle;
 }
 
 void ItemBase::Spawn(Position3 pos, float depthY, int totalAnimFrame, float modelRotSpeed)
@@ -108,6 +134,69 @@ bool ItemBase::GetCollisionState()
 	return colliderData->isCollision;
 }
 
+void ItemBase::SaveSnapshot(SnapshotWriter& writer) const
+{
+	int stateIndex = 0;
+	for (int i = 0; i < kUpdateStateNum; ++i) {
+		if (_nowUpdateState == kUpdateStateTable[i]) {
+			stateIndex = i;
+			break;
+		}
+	}
+	writer.Write(stateIndex);
+	writer.Write(_spawnPos);
+	writer.Write(_depthY);
+	writer.Write(_modelRotSpeed);
+	writer.Write(_rotAngle);
+	writer.Write(_animFrame);
+	writer.Write(_totalAnimFrame);
+	writer.Write(colliderData->isCollision);
+	writer.Write(_isAlive);
+}
+
+void ItemBase::LoadSnapshot(SnapshotReader& reader)
+{
+	const bool wasAlive = _isAlive;
+
+	int stateIndex = 0;
+	bool isCollision = false;
+	reader.Read(stateIndex);
+	reader.Read(_spawnPos);
+	reader.Read(_depthY);
+	reader.Read(_modelRotSpeed);
+	reader.Read(_rotAngle);
+	reader.Read(_animFrame);
+	reader.Read(_totalAnimFrame);
+	reader.Read(isCollision);
+	reader.Read(_isAlive);
+	assert(reader.IsValid() && "アイテムの状態を読み込めなかった");
+
+	_nowUpdateState = kUpdateStateTable[std::clamp(stateIndex, 0, kUpdateStateNum - 1)];
+	SetCollisionState(isCollision);
+
+	// 消滅の前後をまたいで戻した場合はphysicsへの登録を合わせる
+	if (wasAlive && !_isAlive) {
+		ReleasePhysics();
+	}
+	else if (!wasAlive && _isAlive) {
+		EntryPhysics(physics);
+	}
+
+	// 進行度から位置を求めてモデルに反映する(回転は進めない)
+	float ratio = 0.0f;
+	if (_totalAnimFrame > 0) {
+		ratio = static_cast<float>(_animFrame) / _totalAnimFrame;
+	}
+	SetMatrix(_spawnPos + Position3(0, _depthY * ratio, 0), 0.0f);
+}
+
+void ItemBase::Discard()
+{
+	if (!_isAlive) return;
+	ReleasePhysics();
+	_isAlive = false;
+}
+
 void ItemBase::UpdateSpawning()
 {
 	_animFrame--;	// 比率を1->0に遷移させたいため
@@ -6,6 +6,9 @@
 #include <memory>
 
 class PlayerBuffManager;
+struct RenderSnapshot;
+class SnapshotWriter;
+class SnapshotReader;
 
 /// <summary>
 /// アイテムの基底クラス
@@ -35,9 +38,15 @@ public:
 	void Update();
 
 	/// <summary>
-	/// 描画
+	/// 描画に必要な情報をスナップショットに書き込む
 	/// </summary>
-	void Draw();
+	void WriteSnapshot(RenderSnapshot& snapshot) const;
+
+	/// <summary>
+	/// 複製元のモデルを設定する
+	/// (同じ複製元のものは続けて描画する)
+	/// </summary>
+	void SetSourceModel(int sourceHandle);
 
 	/// <summary>
 	/// 衝突したときに呼ばれる
@@ -80,6 +89,18 @@ public:
 	/// <returns></returns>
 	bool IsAlive() { return _isAlive; }
 
+	/// <summary>
+	/// 生成・消滅の進行度や向き、当たり判定の状態を書き込む・読み込む
+	/// </summary>
+	void SaveSnapshot(SnapshotWriter& writer) const;
+	void LoadSnapshot(SnapshotReader& reader);
+
+	/// <summary>
+	/// 状態の復元で不要になった際に呼ばれる
+	/// physicsに登録されていれば登録を解除する
+	/// </summary>
+	void Discard();
+
 private:
 
 	// UpdateのStateパターン
@@ -87,6 +108,10 @@ private:
 	using UpdateFunc_t = void(ItemBase::*)();
 	UpdateFunc_t _nowUpdateState;
 
+	// 状態の保存時に番号へ置き換えるためのステート一覧
+	static constexpr int kUpdateStateNum = 3;
+	static const UpdateFunc_t kUpdateStateTable[kUpdateStateNum];
+
 	/// <summary>
 	/// 生成中
 	/// 1 -> 0
@@ -125,5 +150,11 @@ protected:
 
 	int _animFrame;
 	int _totalAnimFrame;
+
+	// 視界内判定に使用する境界球の半径
+	float _cullRadius;
+
+	// 複製元のモデル
+	int _sourceModelHandle;
 };
 
@@ -160,6 +160,8 @@ std::shared_ptr<ItemBase> ItemFactory::CreateAndRegister(
 
 	// 生成した敵の初期化
 	if (newItem) {
+		// 描画をまとめる単位として複製元を設定
+		newItem->SetSourceModel(it->second);
 		// 生成処理
 		newItem->Spawn(position, kSpawnDepthY, (int)kTotalAnimFrame, kModelRotSpeed);
 		// 当たり判定登録
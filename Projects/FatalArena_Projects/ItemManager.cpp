@@ -3,6 +3,8 @@
 #include "ItemFactory.h"
 #include "Calculation.h"
 #include "Arena.h"
+#include "Random.h"
+#include "SnapshotArchive.h"
 #include <DxLib.h>
 
 namespace {
@@ -11,14 +13,16 @@ namespace {
 
 ItemManager::ItemManager() :
 	_items(),
-	_physics()
+	_physics(),
+	_handle()
 {
-	// 処理なし
+	// 他のオブジェクトから参照できるよう登録する
+	_handle = SlotMap<ItemManager>::GetInstance().Insert(this);
 }
 
 ItemManager::~ItemManager()
 {
-	// 処理なし
+	SlotMap<ItemManager>::GetInstance().Remove(_handle);
 }
 
 void ItemManager::Init(std::weak_ptr<Physics> physics,
@@ -30,6 +34,8 @@ void ItemManager::Init(std::weak_ptr<Physics> physics,
 
 void ItemManager::Update()
 {
+	// アイテムはウェーブごとに数個しか無く、ジョブに分ける手間の方が大きいため順に更新する
+	// (モデルへの反映と物理からの除外も行うため、並列にする場合は敵と同様に計算と反映を分ける)
 	for (auto& item : _items) {
 		item->Update();
 	}
@@ -38,17 +44,18 @@ void ItemManager::Update()
 	CleanupDestroyedItems();
 }
 
-void ItemManager::Draw()
+void ItemManager::WriteSnapshot(RenderSnapshot& snapshot) const
 {
 	for (const auto& item : _items)	{
-		item->Draw();
+		item->WriteSnapshot(snapshot);
 	}
 }
 
 void ItemManager::SpawnItem(const BuffType type)
 {
 	// spawnRadius内にランダムな位置を計算
-	float angle = Calc::ToRadian(static_cast<float>(GetRand(360)));
+	RandomStream& random = RandomService::GetInstance().GetStream(RandomStreamType::ItemSpawn);
+	float angle = random.GetFloat(0.0f, Calc::ToRadian(360.0f));
 	//float radius = static_cast<float>(GetRand(static_cast<int>(kSpawnRadius)));
 	float radius = static_cast<float>(kSpawnRadius);	// 外周に生成
 	// 原点を中心に生成
@@ -60,6 +67,51 @@ void ItemManager::SpawnItem(const BuffType type)
 	_items.emplace_back(newItem);
 }
 
+void ItemManager::SaveSnapshot(SnapshotWriter& writer) const
+{
+	writer.Write(static_cast<int>(_items.size()));
+	for (const auto& item : _items) {
+		writer.Write(item->GetType());
+		item->SaveSnapshot(writer);
+	}
+}
+
+void ItemManager::LoadSnapshot(SnapshotReader& reader)
+{
+	int itemNum = 0;
+	reader.Read(itemNum);
+	if (!reader.IsValid()) return;
+
+	for (int i = 0; i < itemNum; ++i) {
+		BuffType type = BuffType::None;
+		reader.Read(type);
+		if (!reader.IsValid()) break;
+
+		// 同じ位置に同じ種類のアイテムがあれば使い回す
+		const bool isReusable = (i < static_cast<int>(_items.size()) &&
+			_items[i]->GetType() == type);
+		if (!isReusable) {
+			auto newItem = ItemFactory::CreateAndRegister(type, Vector3(), _manager, _physics);
+			if (i < static_cast<int>(_items.size())) {
+				_items[i]->Discard();
+				_items[i] = newItem;
+			}
+			else {
+				_items.emplace_back(newItem);
+			}
+		}
+		_items[i]->LoadSnapshot(reader);
+	}
+
+	// 保存時より多い分は破棄する
+	for (int i = itemNum; i < static_cast<int>(_items.size()); ++i) {
+		_items[i]->Discard();
+	}
+	if (static_cast<int>(_items.size()) > itemNum) {
+		_items.erase(_items.begin() + itemNum, _items.end());
+	}
+}
+
 void ItemManager::CleanupDestroyedItems()
 {
 	// 消滅処理が終了したアイテムをvectorの末尾に集めてから削除する
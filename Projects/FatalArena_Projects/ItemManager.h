@@ -1,11 +1,15 @@
 ﻿#pragma once
 #include "PlayerBuffManager.h"
+#include "Handle.h"
 
 #include <memory>
 #include <vector>
 
 class ItemBase;
 class Physics;
+struct RenderSnapshot;
+class SnapshotWriter;
+class SnapshotReader;
 enum class ItemType;
 
 class ItemManager
@@ -26,9 +30,10 @@ public:
 	void Update();
 
 	/// <summary>
-	/// 描画
+	/// 描画に必要な情報をスナップショットに書き込む
+	/// (描画はスナップショットから行う)
 	/// </summary>
-	void Draw();
+	void WriteSnapshot(RenderSnapshot& snapshot) const;
 
 	/// <summary>
 	/// 指定されたアイテムを生成する
@@ -36,6 +41,18 @@ public:
 	/// <param name="type"></param>
 	void SpawnItem(const BuffType type);
 
+	/// <summary>
+	/// 自身を参照するためのHandleを返す
+	/// </summary>
+	Handle<ItemManager> GetHandle() const { return _handle; }
+
+	/// <summary>
+	/// 全てのアイテムの種類と状態を書き込む・読み込む
+	/// 読み込み時は同じ位置に同じ種類のアイテムがあれば使い回す
+	/// </summary>
+	void SaveSnapshot(SnapshotWriter& writer) const;
+	void LoadSnapshot(SnapshotReader& reader);
+
 private:
 	/// <summary>
 	/// 消滅処理が終了したアイテムをリストから削除する
@@ -54,5 +71,7 @@ private:
 	std::weak_ptr<PlayerBuffManager> _manager;
 	std::weak_ptr<Physics> _physics;
 
+	// 自身を参照するためのHandle
+	Handle<ItemManager> _handle;
 };
 
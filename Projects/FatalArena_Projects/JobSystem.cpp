@@ -0,0 +1,218 @@
+﻿#include "JobSystem.h"
+#include <cassert>
+#include <algorithm>
+
+namespace {
+	// 同時に存在できるジョブの最大数(2の累乗)
+	constexpr unsigned int kMaxJobNum = 4096;
+
+	// このスレッドが使用する列の番号(メインスレッドは0)
+	thread_local int tQueueIndex = 0;
+}
+
+JobSystem& JobSystem::GetInstance()
+{
+	static JobSystem ret;
+	return ret;
+}
+
+JobSystem::JobSystem() :
+	_jobPool(std::make_unique<Job[]>(kMaxJobNum)),
+	_allocatedJobCount(0),
+	_queues(),
+	_workers(),
+	_queuedJobCount(0),
+	_wakeMutex(),
+	_wakeCondition(),
+	_isQuit(false)
+{
+	// Init前でもメインスレッドだけで動作できるようにしておく
+	_queues.emplace_back(std::make_unique<WorkQueue>(kMaxJobNum));
+}
+
+void JobSystem::Init(int workerNum)
+{
+	assert(_workers.empty() && "既に初期化されている");
+	if (workerNum < 0) {
+		const int coreNum = static_cast<int>(std::thread::hardware_concurrency());
+		workerNum = std::max<int>(0, coreNum - 1);
+	}
+
+	_isQuit = false;
+	for (int i = 0; i < workerNum; ++i) {
+		_queues.emplace_back(std::make_unique<WorkQueue>(kMaxJobNum));
+	}
+	for (int i = 0; i < workerNum; ++i) {
+		_workers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+	}
+}
+
+void JobSystem::Terminate()
+{
+	{
+		std::lock_guard<std::mutex> lock(_wakeMutex);
+		_isQuit = true;
+	}
+	_wakeCondition.notify_all();
+	for (auto& worker : _workers) {
+		worker.join();
+	}
+	_workers.clear();
+	_queues.resize(1);
+}
+
+JobSystem::Job* JobSystem::CreateJob(JobFunc_t func, Job* parent)
+{
+	// 置き場を順に使い回す
+	// (一周する前に以前のジョブは終わっている前提)
+	const unsigned int index = _allocatedJobCount.fetch_add(1) & (kMaxJobNum - 1);
+	Job* job = &_jobPool[index];
+	assert(job->unfinishedCount == 0 && "ジョブの置き場が足りない");
+
+	job->func = std::move(func);
+	job->parent = parent;
+	job->unfinishedCount = 1;
+	if (parent) {
+		parent->unfinishedCount.fetch_add(1);
+	}
+	return job;
+}
+
+void JobSystem::Run(Job* job)
+{
+	WorkQueue& queue = *_queues[tQueueIndex];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.PushBack(job);
+	}
+	{
+		// 眠っているワーカーを起こす
+		std::lock_guard<std::mutex> lock(_wakeMutex);
+		_queuedJobCount.fetch_add(1);
+	}
+	_wakeCondition.notify_one();
+}
+
+void JobSystem::Wait(const Job* job)
+{
+	while (job->unfinishedCount.load() > 0) {
+		// 待っている間も他のジョブを進める
+		Job* next = GetJob();
+		if (next) {
+			Execute(next);
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::ParallelFor(int count, int grainSize, const RangeFunc_t& func)
+{
+	if (count <= 0) return;
+	assert(grainSize > 0 && "分割数が正しくない");
+
+	// 1つに収まる場合はそのまま実行する
+	if (count <= grainSize) {
+		func(0, count);
+		return;
+	}
+
+	Job* root = CreateJob(nullptr);
+	for (int begin = 0; begin < count; begin += grainSize) {
+		const int end = std::min<int>(begin + grainSize, count);
+		Run(CreateJob([&func, begin, end]() { func(begin, end); }, root));
+	}
+	// 親の分を終わらせ、子が全て終わるのを待つ
+	Finish(root);
+	Wait(root);
+}
+
+void JobSystem::WorkerLoop(int index)
+{
+	tQueueIndex = index;
+	while (true) {
+		Job* job = GetJob();
+		if (job) {
+			Execute(job);
+			continue;
+		}
+
+		// 仕事がなければ積まれるまで眠る
+		std::unique_lock<std::mutex> lock(_wakeMutex);
+		_wakeCondition.wait(lock, [this]() {
+			return _isQuit.load() || _queuedJobCount.load() > 0;
+			});
+		if (_isQuit) return;
+	}
+}
+
+JobSystem::Job* JobSystem::GetJob()
+{
+	const int queueNum = static_cast<int>(_queues.size());
+
+	// 自分の列の末尾から取り出す
+	{
+		WorkQueue& own = *_queues[tQueueIndex];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.IsEmpty()) {
+			Job* job = own.PopBack();
+			_queuedJobCount.fetch_sub(1);
+			return job;
+		}
+	}
+
+	// 他の列の先頭から盗む
+	for (int i = 1; i < queueNum; ++i) {
+		WorkQueue& other = *_queues[(tQueueIndex + i) % queueNum];
+		std::lock_guard<std::mutex> lock(other.mutex);
+		if (!other.IsEmpty()) {
+			Job* job = other.PopFront();
+			_queuedJobCount.fetch_sub(1);
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+void JobSystem::WorkQueue::PushBack(Job* job)
+{
+	const unsigned int capacity = static_cast<unsigned int>(jobs.size());
+	assert(count < capacity && "積めるジョブの数を超えた");
+	jobs[(head + count) % capacity] = job;
+	++count;
+}
+
+JobSystem::Job* JobSystem::WorkQueue::PopBack()
+{
+	assert(count > 0 && "ジョブが積まれていない");
+	--count;
+	return jobs[(head + count) % jobs.size()];
+}
+
+JobSystem::Job* JobSystem::WorkQueue::PopFront()
+{
+	assert(count > 0 && "ジョブが積まれていない");
+	Job* job = jobs[head];
+	head = (head + 1) % jobs.size();
+	--count;
+	return job;
+}
+
+void JobSystem::Execute(Job* job)
+{
+	if (job->func) {
+		job->func();
+	}
+	Finish(job);
+}
+
+void JobSystem::Finish(Job* job)
+{
+	// 自身と子が全て終わったら親へ伝える
+	if (job->unfinishedCount.fetch_sub(1) == 1) {
+		if (job->parent) {
+			Finish(job->parent);
+		}
+	}
+}
@@ -0,0 +1,138 @@
+﻿#pragma once
+#include <vector>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/// <summary>
+/// 固定数のワーカースレッドで処理(ジョブ)を並列に実行するシングルトンクラス
+/// スレッドごとにジョブの列を持ち、自分の列が空になったら他の列から盗んで実行する
+/// 親ジョブは全ての子ジョブが終わるまで終了しない
+/// 待機中のメインスレッドもジョブを実行する
+/// </summary>
+class JobSystem final
+{
+public:
+	// ジョブの処理
+	using JobFunc_t = std::function<void()>;
+	// 範囲を受け取る処理([begin, end))
+	using RangeFunc_t = std::function<void(int begin, int end)>;
+
+	/// <summary>
+	/// ジョブ
+	/// 内容はJobSystemが管理する
+	/// </summary>
+	struct Job
+	{
+		JobFunc_t func;
+		Job* parent = nullptr;
+		// 自身と子ジョブのうち終わっていない数
+		std::atomic<int> unfinishedCount = 0;
+	};
+
+	/// <summary>
+	/// シングルトンオブジェクトを返す
+	/// </summary>
+	/// <returns>シングルトンオブジェクト</returns>
+	static JobSystem& GetInstance();
+
+	/// <summary>
+	/// ワーカースレッドを起動する
+	/// </summary>
+	/// <param name="workerNum">ワーカースレッド数(負ならコア数-1)</param>
+	void Init(int workerNum = -1);
+
+	/// <summary>
+	/// ワーカースレッドを終了する
+	/// </summary>
+	void Terminate();
+
+	/// <summary>
+	/// ジョブを作成する(まだ実行はされない)
+	/// </summary>
+	/// <param name="func">処理</param>
+	/// <param name="parent">親ジョブ(親は子が終わるまで終了しない)</param>
+	Job* CreateJob(JobFunc_t func, Job* parent = nullptr);
+
+	/// <summary>
+	/// ジョブを呼び出したスレッドの列に積む
+	/// </summary>
+	void Run(Job* job);
+
+	/// <summary>
+	/// ジョブ(と子ジョブ)が終わるまで待つ
+	/// 待っている間は他のジョブを実行する
+	/// </summary>
+	void Wait(const Job* job);
+
+	/// <summary>
+	/// [0, count)をgrainSizeごとに分けて並列に処理し、全て終わるまで待つ
+	/// 分け方はスレッド数に関係なく一定になる
+	/// </summary>
+	/// <param name="count">要素数</param>
+	/// <param name="grainSize">1つのジョブで処理する要素数</param>
+	/// <param name="func">範囲を受け取る処理</param>
+	void ParallelFor(int count, int grainSize, const RangeFunc_t& func);
+
+	/// <summary>
+	/// メインスレッドを含めた、ジョブを実行するスレッド数
+	/// </summary>
+	int GetThreadNum() const { return static_cast<int>(_queues.size()); }
+
+private:
+	JobSystem();
+	JobSystem(const JobSystem&) = delete;
+	void operator=(const JobSystem&) = delete;
+
+	// スレッドごとのジョブの列
+	// 持ち主は末尾から取り出し、他のスレッドは先頭から盗む
+	// (積むたびに確保が起きないよう、固定長の領域を環状に使う)
+	struct WorkQueue
+	{
+		explicit WorkQueue(unsigned int capacity) : jobs(capacity) {}
+
+		bool IsEmpty() const { return count == 0; }
+		void PushBack(Job* job);
+		Job* PopBack();
+		Job* PopFront();
+
+		std::mutex mutex;
+		std::vector<Job*> jobs;
+		unsigned int head = 0;	// 先頭の位置
+		unsigned int count = 0;	// 積まれている数
+	};
+
+	/// <summary>
+	/// ワーカースレッドの処理
+	/// </summary>
+	void WorkerLoop(int index);
+
+	/// <summary>
+	/// 実行するジョブを取得する(自分の列、他の列の順)
+	/// </summary>
+	Job* GetJob();
+
+	/// <summary>
+	/// ジョブを実行し、終了を親へ伝える
+	/// </summary>
+	void Execute(Job* job);
+	void Finish(Job* job);
+
+	// ジョブの置き場(使い回す)
+	std::unique_ptr<Job[]> _jobPool;
+	std::atomic<unsigned int> _allocatedJobCount;
+
+	// [0]はメインスレッド用
+	std::vector<std::unique_ptr<WorkQueue>> _queues;
+	std::vector<std::thread> _workers;
+
+	// 積まれていて、まだ取り出されていないジョブの数
+	std::atomic<int> _queuedJobCount;
+	// 仕事がない間ワーカーを眠らせる
+	std::mutex _wakeMutex;
+	std::condition_variable _wakeCondition;
+	std::atomic<bool> _isQuit;
+};
@@ -0,0 +1,158 @@
+﻿#include "SelfTest.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+	// 結果の比較に使う要素数と、1つのジョブで処理する要素数
+	constexpr int kElementNum = 100000;
+	constexpr int kGrainSize = 1024;
+	// 速度の計測に使う要素数と、計測を繰り返す回数(最短の時間を使う)
+	constexpr int kBenchElementNum = 1 << 18;
+	constexpr int kBenchRepeatNum = 3;
+	// 親子関係の確認に使う子ジョブの数
+	constexpr int kChildJobNum = 500;
+	// 1要素分の処理の重さ
+	constexpr int kWorkLoopNum = 32;
+
+	/// <summary>
+	/// 1要素分の処理
+	/// 要素の番号だけから求めるため、どのスレッドで実行しても同じ値になる
+	/// </summary>
+	float Work(int index)
+	{
+		float value = static_cast<float>(index) * 0.001f;
+		for (int i = 0; i < kWorkLoopNum; ++i) {
+			value = std::sin(value) * 0.5f + std::cos(value * 1.5f);
+		}
+		return value;
+	}
+
+	/// <summary>
+	/// ParallelForの結果
+	/// </summary>
+	struct ParallelResult
+	{
+		std::vector<float> values;	// 要素ごとの値
+		double sum = 0.0;			// 塊ごとの部分和を塊の順に足したもの
+	};
+
+	/// <summary>
+	/// 指定のスレッド数でParallelForを実行する
+	/// 塊の分け方はスレッド数に関係なく一定なので、部分和を塊の順に足せば合計も一定になる
+	/// </summary>
+	ParallelResult RunParallelSum(int threadNum)
+	{
+		JobSystem& jobSystem = JobSystem::GetInstance();
+		jobSystem.Init(threadNum - 1);
+
+		ParallelResult result;
+		result.values.resize(kElementNum);
+		const int chunkNum = (kElementNum + kGrainSize - 1) / kGrainSize;
+		std::vector<double> partialSums(chunkNum, 0.0);
+		jobSystem.ParallelFor(kElementNum, kGrainSize, [&result, &partialSums](int begin, int end) {
+			double sum = 0.0;
+			for (int i = begin; i < end; ++i) {
+				result.values[i] = Work(i);
+				sum += result.values[i];
+			}
+			partialSums[begin / kGrainSize] = sum;
+			});
+		for (double partialSum : partialSums) {
+			result.sum += partialSum;
+		}
+
+		jobSystem.Terminate();
+		return result;
+	}
+
+	/// <summary>
+	/// 2つの結果がビット単位で一致しているか
+	/// </summary>
+	bool IsSameResult(const ParallelResult& a, const ParallelResult& b)
+	{
+		return a.values.size() == b.values.size() &&
+			std::memcmp(a.values.data(), b.values.data(), a.values.size() * sizeof(float)) == 0 &&
+			std::memcmp(&a.sum, &b.sum, sizeof(double)) == 0;
+	}
+
+	/// <summary>
+	/// 指定のスレッド数でParallelForにかかる時間を計測する
+	/// </summary>
+	/// <returns>繰り返したうち最短の時間(ミリ秒)</returns>
+	double MeasureParallelFor(int threadNum, std::vector<float>& output)
+	{
+		JobSystem& jobSystem = JobSystem::GetInstance();
+		jobSystem.Init(threadNum - 1);
+
+		auto func = [&output](int begin, int end) {
+			for (int i = begin; i < end; ++i) {
+				output[i] = Work(i);
+			}
+			};
+
+		// ワーカーが起きるまでの時間を含めないよう、1回実行しておく
+		jobSystem.ParallelFor(kBenchElementNum, kGrainSize, func);
+
+		double bestMs = 0.0;
+		for (int i = 0; i < kBenchRepeatNum; ++i) {
+			const auto start = std::chrono::steady_clock::now();
+			jobSystem.ParallelFor(kBenchElementNum, kGrainSize, func);
+			const auto end = std::chrono::steady_clock::now();
+			const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+			if (i == 0 || ms < bestMs) bestMs = ms;
+		}
+
+		jobSystem.Terminate();
+		return bestMs;
+	}
+}
+
+void SelfTest::RunJobSystemTests()
+{
+	PrintHeader("JobSystem");
+	JobSystem& jobSystem = JobSystem::GetInstance();
+	const int maxThreadNum = std::max<int>(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+	// 親ジョブは全ての子ジョブが終わるまで終了しない
+	{
+		jobSystem.Init(maxThreadNum - 1);
+		std::atomic<int> finishedCount = 0;
+		JobSystem::Job* root = jobSystem.CreateJob(nullptr);
+		for (int i = 0; i < kChildJobNum; ++i) {
+			jobSystem.Run(jobSystem.CreateJob([&finishedCount]() { finishedCount.fetch_add(1); }, root));
+		}
+		jobSystem.Run(root);
+		jobSystem.Wait(root);
+		Check(finishedCount.load() == kChildJobNum, "Wait returns after every child job has finished");
+		jobSystem.Terminate();
+	}
+
+	// スレッド数を変えても結果が変わらない
+	{
+		const ParallelResult single = RunParallelSum(1);
+		const ParallelResult dual = RunParallelSum(2);
+		const ParallelResult full = RunParallelSum(maxThreadNum);
+		Check(IsSameResult(single, dual), "ParallelFor gives identical results on 1 and 2 threads");
+		Check(IsSameResult(single, full), "ParallelFor gives identical results on 1 and all threads");
+	}
+
+	// 1スレッドから全コアまでの速度
+	{
+		printf("  ParallelFor scaling (%d elements, grain %d)\n", kBenchElementNum, kGrainSize);
+		std::vector<float> output(kBenchElementNum);
+		double singleMs = 0.0;
+		for (int threadNum = 1; threadNum <= maxThreadNum; ++threadNum) {
+			const double ms = MeasureParallelFor(threadNum, output);
+			if (threadNum == 1) singleMs = ms;
+			printf("    threads %2d : %8.3f ms (x%.2f)\n",
+				threadNum, ms, (ms > 0.0) ? singleMs / ms : 0.0);
+		}
+	}
+}
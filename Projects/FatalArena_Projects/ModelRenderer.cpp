@@ -0,0 +1,147 @@
+﻿#include "ModelRenderer.h"
+
+namespace {
+	// インデックスで参照できる頂点数の上限
+	constexpr int kMaxVertexNum = 65535;
+
+	// ビルボード1枚分の頂点とインデックス
+	constexpr int kQuadVertexNum = 4;
+	constexpr int kQuadIndexNum = 6;
+	constexpr int kQuadPolygonNum = 2;
+	constexpr int kMaxQuadNum = kMaxVertexNum / kQuadVertexNum;
+}
+
+ModelRenderer::ModelRenderer() :
+	_impostorGraph(-1),
+	_impostorVertices(),
+	_impostorIndices(),
+	_impostorRight(),
+	_impostorNormal(),
+	_drawCallCount(0),
+	_instanceCount(0),
+	_impostorCount(0)
+{
+}
+
+ModelRenderer::~ModelRenderer()
+{
+}
+
+void ModelRenderer::Begin()
+{
+	_drawCallCount = 0;
+	_instanceCount = 0;
+	_impostorCount = 0;
+	_impostorGraph = -1;
+	_impostorVertices.clear();
+
+	// ビルボードは縦に立てたままカメラへ向ける
+	const MATRIX billboard = GetCameraBillboardMatrix();
+	_impostorRight = VNorm(VGet(billboard.m[0][0], 0.0f, billboard.m[0][2]));
+	_impostorNormal = VCross(_impostorRight, VGet(0.0f, 1.0f, 0.0f));
+}
+
+void ModelRenderer::ChangeState(uint64_t stateKey)
+{
+	// 状態が変わる前にためていたものを描画する
+	FlushImpostors();
+}
+
+void ModelRenderer::Execute(const RenderCommand& command)
+{
+	if (command.shader == RenderShader::Custom) {
+		FlushImpostors();
+		command.func();
+		return;
+	}
+	if (command.shader == RenderShader::Impostor) {
+		AddImpostor(command);
+		return;
+	}
+	FlushImpostors();
+
+	++_instanceCount;
+	if (command.isSetPosition) {
+		MV1SetPosition(command.modelHandle, command.pos);
+	}
+	DrawModel(command);
+}
+
+void ModelRenderer::End()
+{
+	FlushImpostors();
+}
+
+void ModelRenderer::DrawModel(const RenderCommand& command)
+{
+	MV1DrawModel(command.modelHandle);
+	++_drawCallCount;
+}
+
+void ModelRenderer::AddImpostor(const RenderCommand& command)
+{
+	const int quadNum = static_cast<int>(_impostorVertices.size()) / kQuadVertexNum;
+	if (command.graphHandle != _impostorGraph || quadNum >= kMaxQuadNum) {
+		FlushImpostors();
+	}
+	_impostorGraph = command.graphHandle;
+	++_impostorCount;
+
+	const VECTOR halfWidth = VScale(_impostorRight, command.width * 0.5f);
+	const VECTOR height = VGet(0.0f, command.height, 0.0f);
+	const VECTOR bottomLeft = VSub(command.pos, halfWidth);
+	const VECTOR bottomRight = VAdd(command.pos, halfWidth);
+
+	VERTEX3D vertex[kQuadVertexNum];
+	vertex[0].pos = VAdd(bottomLeft, height);	// 左上
+	vertex[1].pos = VAdd(bottomRight, height);	// 右上
+	vertex[2].pos = bottomLeft;					// 左下
+	vertex[3].pos = bottomRight;				// 右下
+	vertex[0].u = 0.0f; vertex[0].v = 0.0f;
+	vertex[1].u = 1.0f; vertex[1].v = 0.0f;
+	vertex[2].u = 0.0f; vertex[2].v = 1.0f;
+	vertex[3].u = 1.0f; vertex[3].v = 1.0f;
+	for (auto& v : vertex) {
+		v.norm = _impostorNormal;
+		v.dif = GetColorU8(255, 255, 255, 255);
+		v.spc = GetColorU8(0, 0, 0, 0);
+		v.su = 0.0f;
+		v.sv = 0.0f;
+		_impostorVertices.emplace_back(v);
+	}
+}
+
+void ModelRenderer::FlushImpostors()
+{
+	const int quadNum = static_cast<int>(_impostorVertices.size()) / kQuadVertexNum;
+	if (quadNum == 0) return;
+
+	// インデックスは並びが変わらないため、足りない分だけ作る
+	const int builtNum = static_cast<int>(_impostorIndices.size()) / kQuadIndexNum;
+	if (builtNum < quadNum) {
+		_impostorIndices.resize(static_cast<size_t>(quadNum) * kQuadIndexNum);
+		for (int i = builtNum; i < quadNum; ++i) {
+			const unsigned short base = static_cast<unsigned short>(i * kQuadVertexNum);
+			unsigned short* index = &_impostorIndices[static_cast<size_t>(i) * kQuadIndexNum];
+			// 左上、右上、左下 / 左下、右上、右下
+			index[0] = base + 0;
+			index[1] = base + 1;
+			index[2] = base + 2;
+			index[3] = base + 2;
+			index[4] = base + 1;
+			index[5] = base + 3;
+		}
+	}
+
+	// ビルボードは陰影を付けずに画像の色のまま描画する
+	SetUseLighting(FALSE);
+	DrawPolygonIndexed3D(
+		_impostorVertices.data(), quadNum * kQuadVertexNum,
+		_impostorIndices.data(), quadNum * kQuadPolygonNum,
+		_impostorGraph, true);
+	SetUseLighting(TRUE);
+	++_drawCallCount;
+
+	_impostorVertices.clear();
+	_impostorGraph = -1;
+}
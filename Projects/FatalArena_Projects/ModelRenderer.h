@@ -0,0 +1,62 @@
+﻿#pragma once
+#include "RenderQueue.h"
+#include <DxLib.h>
+#include <vector>
+
+/// <summary>
+/// 描画キューの命令をDxLibで実行する
+/// モデルはマテリアルとライティングを保つためMV1DrawModelで1つずつ描画する
+/// (描画キューが同じ複製元のモデルを連続して渡してくるため、状態の切り替えは少なくなる)
+/// ライティングを使わないビルボードのみ、同じ画像のものを1回のポリゴン描画にまとめる
+/// </summary>
+class ModelRenderer final : public RenderBackendBase
+{
+public:
+	ModelRenderer();
+	~ModelRenderer();
+
+	void Begin() override;
+	void ChangeState(uint64_t stateKey) override;
+	void Execute(const RenderCommand& command) override;
+	void End() override;
+
+	/// <summary>
+	/// 直近の描画での描画呼び出し回数
+	/// </summary>
+	int GetDrawCallCount() const { return _drawCallCount; }
+	/// <summary>
+	/// 直近の描画で描画したモデルの数
+	/// </summary>
+	int GetInstanceCount() const { return _instanceCount; }
+	/// <summary>
+	/// 直近の描画でモデルの代わりにビルボードで描画した数
+	/// </summary>
+	int GetImpostorCount() const { return _impostorCount; }
+
+private:
+	/// <summary>
+	/// モデルを1つ描画する
+	/// </summary>
+	void DrawModel(const RenderCommand& command);
+
+	/// <summary>
+	/// ビルボードをためておく
+	/// </summary>
+	void AddImpostor(const RenderCommand& command);
+	/// <summary>
+	/// ためているビルボードをまとめて描画する
+	/// </summary>
+	void FlushImpostors();
+
+	// まとめて描画するためにためているビルボードの画像(-1ならためていない)
+	int _impostorGraph;
+	std::vector<VERTEX3D> _impostorVertices;
+	std::vector<unsigned short> _impostorIndices;
+	// ビルボードを向ける方向(描画の開始時のカメラから求める)
+	VECTOR _impostorRight;
+	VECTOR _impostorNormal;
+
+	int _drawCallCount;
+	int _instanceCount;
+	int _impostorCount;
+};
@@ -7,10 +7,16 @@
 #include "Rigidbody.h"
 #include "DebugDraw.h"
 #include "Collision.h"
+#include "JobSystem.h"
 
 #include <cassert>
 #include <vector>
 
+namespace {
+	// 移動の計算で1つのジョブにまとめるColliderの数
+	constexpr int kIntegrateGrainSize = 32;
+}
+
 void Physics::Entry(std::shared_ptr<Collider> collider)
 {
 	// (見つからなかった場合はend)
@@ -47,40 +53,54 @@ void Physics::Release(std::shared_ptr<Collider> collider)
 void Physics::Update()
 {
 	// 移動
-	for (auto& collider : _colliders) {
-		// 位置に移動量を足す
-		Position3 pos = collider->rigidbody->GetPos();
-		Vector3 vel = collider->rigidbody->GetVel();
-
-		// 減速量を掛ける
-		vel.x *= PhysicsData::decelerationRate * 0.5f;
-		vel.z *= PhysicsData::decelerationRate * 0.5f;
+	// 各Colliderの計算は独立しているので並列に行う
+	JobSystem::GetInstance().ParallelFor(static_cast<int>(_colliders.size()), kIntegrateGrainSize,
+		[this](int begin, int end) {
+			for (int i = begin; i < end; ++i) {
+				auto& collider = _colliders[i];
+				// 位置に移動量を足す
+				Position3 pos = collider->rigidbody->GetPos();
+				Vector3 vel = collider->rigidbody->GetVel();
+
+				// 減速量を掛ける
+				vel.x *= PhysicsData::decelerationRate * 0.5f;
+				vel.z *= PhysicsData::decelerationRate * 0.5f;
+
+				// 重力を利用するなら重力を与える
+				if (collider->rigidbody->UseGravity()) {
+					vel += PhysicsData::Gravity;
+
+					// 最大重力加速度より小さかったら補正
+					// (重力はマイナスのため)
+					if (vel.y < PhysicsData::MaxGravityAccel.y) {
+						vel.y = PhysicsData::MaxGravityAccel.y;
+					}
+				}
 
-		// 重力を利用するなら重力を与える
-		if (collider->rigidbody->UseGravity()) {
-			vel += PhysicsData::Gravity;
+				// 移動量切り捨て処理
+				Vector3 velXZ = vel;
+				velXZ.y = 0.0f;
+				// 移動していないとみなされる閾値よりも小さければ
+				if (vel.Magnitude() < PhysicsData::sleepThreshold) {
+					vel = {};
+				}
+				// XZのみを見て閾値よりも小さければ
+				else if (velXZ.Magnitude() < PhysicsData::sleepThreshold) {
+					vel.x = vel.z = 0.0f;
+				}
 
-			// 最大重力加速度より小さかったら補正
-			// (重力はマイナスのため)
-			if (vel.y < PhysicsData::MaxGravityAccel.y) {
-				vel.y = PhysicsData::MaxGravityAccel.y;
+				// 予定位置、移動量設定
+				Position3 nextPos = pos + vel;
+				collider->rigidbody->SetVel(vel);
+				collider->nextPos = nextPos;
 			}
-		}
+		});
 
-		// 移動量切り捨て処理
-		Vector3 velXZ = vel;
-		velXZ.y = 0.0f;
-		// 移動していないとみなされる閾値よりも小さければ
-		if (vel.Magnitude() < PhysicsData::sleepThreshold) {
-			vel = {};
-		}
-		// XZのみを見て閾値よりも小さければ
-		else if (velXZ.Magnitude() < PhysicsData::sleepThreshold) {
-			vel.x = vel.z = 0.0f;
-		}
-
-		// もともとの情報、予定情報をデバッグ表示
 #ifdef _DEBUG
+	// もともとの情報、予定情報をデバッグ表示
+	// (DebugDrawはスレッドに対応していないためまとめて行う)
+	for (auto& collider : _colliders) {
+		Position3 pos = collider->rigidbody->GetPos();
 		int color = 0xff00ff;
 		// 当たらない場合は色を変える
 		if (!(collider->colliderData->isCollision)) {
@@ -105,30 +125,27 @@ void Physics::Update()
 			DebugDraw::GetInstance().DrawSphere(end, radius, color);
 			DebugDraw::GetInstance().DrawCapsule(start, end, radius, color);
 		}
-#endif
-
-		// 予定位置、移動量設定
-		Position3 nextPos = pos + vel;
-		collider->rigidbody->SetVel(vel);
-		collider->nextPos = nextPos;
 	}
+#endif
 
 	// 当たり判定チェック（nextPos指定）
-	std::list<OnCollideInfo> onCollideInfo = CheckCollide();
+	CheckCollide(_onCollideInfo);
 
 	// 位置確定
 	FixPosition();
 
 	// 当たり通知
-	for (auto& info : onCollideInfo)
+	for (auto& info : _onCollideInfo)
 	{
 		info.owner->OnCollide(info.colider);
 	}
+	// Colliderの参照を残さないよう消去しておく(確保済みの領域は残る)
+	_onCollideInfo.clear();
 }
 
-std::list<Physics::OnCollideInfo> Physics::CheckCollide() const
+void Physics::CheckCollide(std::vector<OnCollideInfo>& onCollideInfo) const
 {
-	std::list<OnCollideInfo> onCollideInfo;
+	onCollideInfo.clear();
 	// 衝突通知、ポジション補正
 	bool doCheck = true;
 	int	checkCount = 0;	// チェック回数
@@ -139,7 +156,11 @@ std::list<Physics::OnCollideInfo> Physics::CheckCollide() const
 		// 2重ループで全オブジェクト当たり判定
 		// 重いので近いオブジェクト同士のみ当たり判定するなど工夫がいる
 		for (auto& objA : _colliders) {
+			// 当たり判定が無効なものは候補から外す
+			// (攻撃判定はアニメーションイベントで有効になっている間だけ候補になる)
+			if (!objA->colliderData->isCollision) continue;
 			for (auto& objB : _colliders) {
+				if (!objB->colliderData->isCollision) continue;
 				if (objA != objB) {
 					// ぶつかっていれば
 					if (IsCollide(objA, objB)) {
@@ -177,10 +198,10 @@ std::list<Physics::OnCollideInfo> Physics::CheckCollide() const
 						}
 						if (!hasPrimaryInfo) {
 							// MEMO:(実体作って入れるよりこっちの方が速そう)
-							onCollideInfo.push_back({ primary, secondary });
+							onCollideInfo.emplace_back(OnCollideInfo{ primary, secondary });
 						}
 						if (!hasSecondaryInfo) {
-							onCollideInfo.push_back({ secondary, primary });
+							onCollideInfo.emplace_back(OnCollideInfo{ secondary, primary });
 						}
 
 						// 一度でもヒット+補正したら衝突判定と補正やりなおし
@@ -205,7 +226,6 @@ std::list<Physics::OnCollideInfo> Physics::CheckCollide() const
 			break;
 		}
 	}
-	return onCollideInfo;
 }
 
 bool Physics::IsCollide(const std::shared_ptr<Collider> objA, const std::shared_ptr<Collider> objB) const
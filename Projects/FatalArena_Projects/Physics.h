@@ -1,6 +1,6 @@
 ﻿#pragma once
 #include <memory>
-#include <list>
+#include <vector>
 
 class Collider;
 
@@ -31,9 +31,18 @@ private:
 	};
 
 	// 登録されたColliderのリスト
-	std::list<std::shared_ptr<Collider>> _colliders;
+	// (移動の計算を添字で分割して並列に行うためvector)
+	std::vector<std::shared_ptr<Collider>> _colliders;
 
-	std::list<OnCollideInfo> CheckCollide() const;
+	// 衝突通知の一覧
+	// (毎フレーム確保し直さないようメンバとして使い回す)
+	std::vector<OnCollideInfo> _onCollideInfo;
+
+	/// <summary>
+	/// 当たり判定と位置補正を行い、衝突通知の一覧を作る
+	/// </summary>
+	/// <param name="onCollideInfo">衝突通知の一覧(中身は消去してから追加する)</param>
+	void CheckCollide(std::vector<OnCollideInfo>& onCollideInfo) const;
 
 	/// <summary>
 	/// 当たっているかどうかだけ判定
@@ -17,6 +17,7 @@
 #include "Arena.h"
 #include "SoundManager.h"
 #include "Physics.h"
+#include "SnapshotArchive.h"
 #include <cassert>
 #include <algorithm>
 
@@ -49,6 +50,9 @@ namespace {
 	constexpr float kMaxStepTriggerDist = 1200.0f;		// 踏み込みを行う最大距離
 	constexpr float kStepAmount = 70.0f;				// 踏み込み量
 
+	// 武器をアタッチするフレームの名前
+	constexpr const wchar_t* kWeaponAttachFrameName = L"mixamorig:RightHandThumb3";
+
 	const std::wstring kAnimName = L"Armature|Animation_";
 	const std::wstring kAnimNameIdle =			kAnimName + L"Idle";
 	const std::wstring kAnimNameWalk =			kAnimName + L"Walk";
@@ -133,8 +137,12 @@ Player::Player() :
 	_staminaRecoveryStandbyFrame(0),
 	_isAlive(true),
 	_reactCooltime(0),
-	_isPlayAttackSound(false)
+	_isInputWindowOpen(false),
+	_handle()
 {
+	// 他のオブジェクトから参照できるよう登録する
+	_handle = SlotMap<Player>::GetInstance().Insert(this);
+
 	// データ設定
 	StatsData data;
 	data.maxHealth = kMaxHitPoint;
@@ -167,8 +175,8 @@ Player::Player() :
 	_animator->SetAnimData(kAnimNameRun,			kRunAnimSpeed, true);
 	_animator->SetAnimData(kAnimNameAttackNormal,	kBaseAnimSpeed, false);
 	_animator->SetAnimData(kAnimNameAttackBack,		kBaseAnimSpeed, false);
-	_animator->SetAnimData(kAnimNameAttackCombo1,	kAttackAnim1Speed, false, kAttackCombo1InputStart, kAttackCombo1InputEnd);
-	_animator->SetAnimData(kAnimNameAttackCombo2,	kAttackAnim2Speed, false, kAttackCombo2InputStart, kAttackCombo2InputEnd);
+	_animator->SetAnimData(kAnimNameAttackCombo1,	kAttackAnim1Speed, false);
+	_animator->SetAnimData(kAnimNameAttackCombo2,	kAttackAnim2Speed, false);
 	_animator->SetAnimData(kAnimNameAttackCombo3,	kAttackAnim3Speed, false);
 	_animator->SetAnimData(kAnimNameSpecialAttack1, kBaseAnimSpeed, false);
 	_animator->SetAnimData(kAnimNameSpecialAttack2, kBaseAnimSpeed, false);
@@ -180,19 +188,55 @@ Player::Player() :
 	_animator->SetAnimData(kAnimNameAppeal,			kBaseAnimSpeed, false);
 	// 最初のアニメーションを設定する
 	_animator->SetStartAnim(kAnimNameIdle);
+
+	// 攻撃アニメーションのイベントを設定する
+	using EventType = Animator::EventType;
+	// 1段目
+	_animator->AddAnimEvent(kAnimNameAttackCombo1, kAttackCombo1InputStart,		EventType::InputWindowOpen);
+	_animator->AddAnimEvent(kAnimNameAttackCombo1, kAttackCombo1InputEnd,		EventType::InputWindowClose);
+	_animator->AddAnimEvent(kAnimNameAttackCombo1, kAttackCombo1SoundTiming,	EventType::SoundCue, static_cast<int>(SEType::Swing1));
+	_animator->AddAnimEvent(kAnimNameAttackCombo1, kAttackCombo1Start,			EventType::HitboxOn);
+	_animator->AddAnimEvent(kAnimNameAttackCombo1, kAttackCombo1End,			EventType::HitboxOff);
+	// 2段目
+	_animator->AddAnimEvent(kAnimNameAttackCombo2, kAttackCombo2InputStart,		EventType::InputWindowOpen);
+	_animator->AddAnimEvent(kAnimNameAttackCombo2, kAttackCombo2InputEnd,		EventType::InputWindowClose);
+	_animator->AddAnimEvent(kAnimNameAttackCombo2, kAttackCombo2SoundTiming,	EventType::SoundCue, static_cast<int>(SEType::Swing1));
+	_animator->AddAnimEvent(kAnimNameAttackCombo2, kAttackCombo2Start,			EventType::HitboxOn);
+	_animator->AddAnimEvent(kAnimNameAttackCombo2, kAttackCombo2End,			EventType::HitboxOff);
+	// 3段目(派生なし)
+	_animator->AddAnimEvent(kAnimNameAttackCombo3, kAttackCombo3SoundTiming,	EventType::SoundCue, static_cast<int>(SEType::Swing2));
+	_animator->AddAnimEvent(kAnimNameAttackCombo3, kAttackCombo3Start,			EventType::HitboxOn);
+	_animator->AddAnimEvent(kAnimNameAttackCombo3, kAttackCombo3End,			EventType::HitboxOff);
+
+	// イベントを受け取る
+	_animator->SetEventHandler(
+		[this](const Animator::AnimEvent& animEvent) { OnAnimEvent(animEvent); });
 }
 
+const Player::UpdateFunc_t Player::kUpdateStateTable[kUpdateStateNum] = {
+	&Player::UpdateIdle,
+	&Player::UpdateWalk,
+	&Player::UpdateDash,
+	&Player::UpdateAttackFirst,
+	&Player::UpdateAttackSecond,
+	&Player::UpdateAttackThird,
+	&Player::UpdateDamage,
+	&Player::UpdateDeath,
+};
+
 Player::~Player()
 {
 	// modelはanimator側で消している
+
+	SlotMap<Player>::GetInstance().Remove(_handle);
 }
 
 void Player::Init(std::weak_ptr<Camera> camera, std::weak_ptr<Physics> physics, 
 	std::weak_ptr<PlayerBuffManager> playerBuffManager, std::weak_ptr<EnemyManager> enemyManager)
 {
 	_camera = camera;
-	_enemyManager = enemyManager;
-	_buffManager = playerBuffManager;
+	_enemyManager = enemyManager.lock()->GetHandle();
+	_buffManager = playerBuffManager.lock()->GetHandle();
 	MV1SetRotationXYZ(_animator->GetModelHandle(), Vector3(0, _rotAngle, 0));
 
 
@@ -281,8 +325,9 @@ float Player::GetAttackPower() const
 {
 	auto data = PlayerReinforcementManager::GetStatsData();
 	float power = data.maxStrength * data.maxStrengthMag;
-	if (_buffManager.lock()->GetData(BuffType::Strength).isActive) {
-		power *= _buffManager.lock()->GetData(BuffType::Strength).amount;
+	const BuffData buff = _buffManager->GetData(BuffType::Strength);
+	if (buff.isActive) {
+		power *= buff.amount;
 	}
 	return power;
 }
@@ -304,7 +349,8 @@ void Player::TakeDamage(float damage, std::shared_ptr<Collider> attacker)
 		//_reactCooltime = kReactCooltimeFrame;
 		SoundManager::GetInstance().PlaySoundType(SEType::PlayerReact);
 
-		// 武器の当たり判定を無効化
+		// 振りの途中で割り込まれた場合に備え、武器の当たり判定を無効にする
+		// (HitboxOffのイベントは発行されないまま次のアニメーションに切り替わるため)
 		_weapon->SetCollisionState(false);
 		// 攻撃してきた相手の方向を向く
 		if (attacker) {
@@ -330,9 +376,7 @@ void Player::TakeDamage(float damage, std::shared_ptr<Collider> attacker)
 
 		// 既に被弾状態ならアニメーションを最初から再生
 		if (_nowUpdateState == &Player::UpdateDamage) {
-			auto& animData = _animator->FindAnimData(kAnimNameReact);
-			animData.frame = 0.0f;
-			animData.isEnd = false;
+			_animator->RestartAnim(kAnimNameReact);
 		}
 		// そうでなければ被弾状態へ遷移
 		else {
@@ -347,8 +391,9 @@ void Player::TakeDamage(float damage, std::shared_ptr<Collider> attacker)
 void Player::AddScore(int addScore)
 {
 	int finalAddScore = addScore;
-	if (_buffManager.lock()->GetData(BuffType::ScoreBoost).isActive) {
-		finalAddScore = static_cast<int>(finalAddScore * _buffManager.lock()->GetData(BuffType::ScoreBoost).amount);
+	const BuffData buff = _buffManager->GetData(BuffType::ScoreBoost);
+	if (buff.isActive) {
+		finalAddScore = static_cast<int>(finalAddScore * buff.amount);
 	}
 	GameManager::GetInstance().AddEnemyDefeatScore(finalAddScore);	// スコア加算
 }
@@ -359,6 +404,69 @@ void Player::Heal(float amount)
 	_hitPoint += healAmount;
 }
 
+void Player::SaveSnapshot(SnapshotWriter& writer) const
+{
+	int stateIndex = 0;
+	for (int i = 0; i < kUpdateStateNum; ++i) {
+		if (_nowUpdateState == kUpdateStateTable[i]) {
+			stateIndex = i;
+			break;
+		}
+	}
+
+	writer.Write(GetPos());
+	writer.Write(GetVel());
+	writer.Write(stateIndex);
+	writer.Write(_frameCount);
+	writer.Write(_rotAngle);
+	writer.Write(_quaternion);
+	writer.Write(_hasDerivedAttackInput);
+	writer.Write(_hitPoint);
+	writer.Write(_stamina);
+	writer.Write(_staminaRecoveryStandbyFrame);
+	writer.Write(_isAlive);
+	writer.Write(_reactCooltime);
+	writer.Write(_isInputWindowOpen);
+	writer.WriteString(_animator->GetCurrentAnimName());
+	writer.Write(_animator->GetCurrentAnimFrame());
+}
+
+void Player::LoadSnapshot(SnapshotReader& reader)
+{
+	Vector3 pos;
+	Vector3 vel;
+	int stateIndex = 0;
+	std::wstring animName;
+	float animFrame = 0.0f;
+
+	reader.Read(pos);
+	reader.Read(vel);
+	reader.Read(stateIndex);
+	reader.Read(_frameCount);
+	reader.Read(_rotAngle);
+	reader.Read(_quaternion);
+	reader.Read(_hasDerivedAttackInput);
+	reader.Read(_hitPoint);
+	reader.Read(_stamina);
+	reader.Read(_staminaRecoveryStandbyFrame);
+	reader.Read(_isAlive);
+	reader.Read(_reactCooltime);
+	reader.Read(_isInputWindowOpen);
+	reader.ReadString(animName);
+	reader.Read(animFrame);
+	assert(reader.IsValid() && "プレイヤーの状態を読み込めなかった");
+
+	rigidbody->SetPos(pos);
+	rigidbody->SetVel(vel);
+	_nowUpdateState = kUpdateStateTable[std::clamp(stateIndex, 0, kUpdateStateNum - 1)];
+	MV1SetRotationXYZ(_animator->GetModelHandle(), Vector3(0, _rotAngle, 0));
+	_animator->RestoreAnim(animName, animFrame);
+
+	// 攻撃判定はアニメーションイベントで再び有効になる
+	_weapon->SetCollisionState(false);
+	WeaponUpdate();
+}
+
 void Player::CheckStateTransition()
 {
 	// 死亡判定を最優先
@@ -405,8 +513,8 @@ void Player::CheckStateTransition()
 				CanStaminaDecreace()) {
 				// スタミナを減らす
 				StaminaDecreace();
-				// 攻撃効果音を鳴らしていない状態にする
-				_isPlayAttackSound = false;
+				// 入力受付はイベントで開始されるまで閉じておく
+				_isInputWindowOpen = false;
 				
 				// 入力があった場合キャラクターの向きを変更
 				if (stick.x != 0.0f || stick.z != 0.0f) {
@@ -426,22 +534,24 @@ void Player::CheckStateTransition()
 					MV1SetRotationXYZ(_animator->GetModelHandle(), Vector3(0, _rotAngle, 0));
 				}
 
-				// 最寄りの敵を取得し距離が一定以下ならそちらを向く
-				std::weak_ptr<EnemyBase> enemy = _enemyManager.lock()->GetNearestEnemy(GetPos(), EnemyType::None, false);
+				// 一定距離以内で最寄りの敵を取得しそちらを向く
+				std::weak_ptr<EnemyBase> enemy = _enemyManager->GetNearestEnemy(
+					GetPos(), EnemyType::None, false, kMaxStepTriggerDist);
 				// 帰ってきた敵が有効なら処理を行う
-				if (enemy.lock()) {
-					Vector3 playerToEnemy = GetPos() - enemy.lock()->GetPos();
-					float dist = playerToEnemy.Magnitude();
-					if (dist <= kMaxStepTriggerDist) {
-						// 距離が0でなければ
-						if (playerToEnemy.SqrMagnitude() > 0.0f) {
-							// Y軸の回転角度を計算し、モデルの向きに反映する
-							_rotAngle = atan2f(playerToEnemy.x, playerToEnemy.z);
-							MV1SetRotationXYZ(_animator->GetModelHandle(), Vector3(0, _rotAngle, 0));
-						}
+				if (auto target = enemy.lock()) {
+					Vector3 playerToEnemy = GetPos() - target->GetPos();
+					// 距離が0でなければ
+					if (playerToEnemy.SqrMagnitude() > 0.0f) {
+						// Y軸の回転角度を計算し、モデルの向きに反映する
+						_rotAngle = atan2f(playerToEnemy.x, playerToEnemy.z);
+						MV1SetRotationXYZ(_animator->GetModelHandle(), Vector3(0, _rotAngle, 0));
 					}
 				}
 
+				// 前の振りの当たり判定が残っていると、次の振りで攻撃リストがリセットされないため
+				// 派生する前に無効にしておく
+				_weapon->SetCollisionState(false);
+
 				// どの攻撃からの派生か
 				if (_nowUpdateState == &Player::UpdateAttackFirst) {
 					_nowUpdateState = &Player::UpdateAttackSecond;
@@ -502,8 +612,8 @@ void Player::CheckStateTransition()
 		_hasDerivedAttackInput = false;
 		_frameCount = 0;
 		StaminaDecreace();
-		// 攻撃効果音を鳴らしていない状態にする
-		_isPlayAttackSound = false;
+		// 入力受付はイベントで開始されるまで閉じておく
+		_isInputWindowOpen = false;
 
 		// 入力があった場合キャラクターの向きを変更
 		if (stick.x != 0.0f || stick.z != 0.0f) {
@@ -523,19 +633,17 @@ void Player::CheckStateTransition()
 			MV1SetRotationXYZ(_animator->GetModelHandle(), Vector3(0, _rotAngle, 0));
 		}
 
-		// 最寄りの敵を取得し距離が一定以下ならそちらを向く
-		std::weak_ptr<EnemyBase> enemy = _enemyManager.lock()->GetNearestEnemy(GetPos(), EnemyType::None, false);
+		// 一定距離以内で最寄りの敵を取得しそちらを向く
+		std::weak_ptr<EnemyBase> enemy = _enemyManager->GetNearestEnemy(
+			GetPos(), EnemyType::None, false, kMaxStepTriggerDist);
 		// 帰ってきた敵が有効なら処理を行う
-		if (enemy.lock()) {
-			Vector3 playerToEnemy = GetPos() - enemy.lock()->GetPos();
-			float dist = playerToEnemy.Magnitude();
-			if (dist <= kMaxStepTriggerDist) {
-				// 距離が0でなければ
-				if (playerToEnemy.SqrMagnitude() > 0.0f) {
-					// Y軸の回転角度を計算し、モデルの向きに反映する
-					_rotAngle = atan2f(playerToEnemy.x, playerToEnemy.z);
-					MV1SetRotationXYZ(_animator->GetModelHandle(), Vector3(0, _rotAngle, 0));
-				}
+		if (auto target = enemy.lock()) {
+			Vector3 playerToEnemy = GetPos() - target->GetPos();
+			// 距離が0でなければ
+			if (playerToEnemy.SqrMagnitude() > 0.0f) {
+				// Y軸の回転角度を計算し、モデルの向きに反映する
+				_rotAngle = atan2f(playerToEnemy.x, playerToEnemy.z);
+				MV1SetRotationXYZ(_animator->GetModelHandle(), Vector3(0, _rotAngle, 0));
 			}
 		}
 
@@ -589,9 +697,8 @@ void Player::WeaponUpdate()
 	// 位置更新
 
 	// 手の行列を武器のワールド行列とする
-	std::wstring handName = L"mixamorig:RightHandThumb3";
 	// 武器をアタッチするフレームの番号を検索
-	int frameIndex = MV1SearchFrame(_animator->GetModelHandle(), handName.c_str());
+	int frameIndex = MV1SearchFrame(_animator->GetModelHandle(), kWeaponAttachFrameName);
 	// インデックスが有効かチェック
 	if (frameIndex < 0) {
 		assert(false && "指定されたフレームが見つからなかった");
@@ -604,72 +711,34 @@ void Player::WeaponUpdate()
 	// 手のワールド行列を渡す
 	_weapon->Update(handWorldMatrix);
 
+	// 当たり判定の切り替えはアニメーションイベントで行う
+}
 
-
-	// 判定更新
-
-	// 攻撃状態でないならreturn
-	if (!(_nowUpdateState == &Player::UpdateAttackFirst ||
-		_nowUpdateState == &Player::UpdateAttackSecond ||
-		_nowUpdateState == &Player::UpdateAttackThird)) {
-		return;
-	}
-
-	std::wstring animName = L"";
-	float start = 0.0f;
-	float end = 0.0f;
-
-	if (_nowUpdateState == &Player::UpdateAttackFirst) {
-		animName = kAnimNameAttackCombo1;
-		start = kAttackCombo1Start;
-		end = kAttackCombo1End;
-	}
-	else if (_nowUpdateState == &Player::UpdateAttackSecond) {
-		animName = kAnimNameAttackCombo2;
-		start = kAttackCombo2Start;
-		end = kAttackCombo2End;
-	}
-	else {
-		animName = kAnimNameAttackCombo3;
-		start = kAttackCombo3Start;
-		end = kAttackCombo3End;
-	}
-
-	// 攻撃アニメーションの情報を取得
-	auto& animData = _animator->FindAnimData(animName);
-
-#ifdef _DEBUG
-	//float prog = animData.frame / animData.totalFrame;
-	//int color = 0xffffff;
-	//int y = 16 * 12;
-	//DrawFormatString(0, y, color, 
-	//	L"Player:AttackAnimProgress : %.3f", 
-	//	prog);
-#endif // _DEBUG
-
-	
-	// アニメーションの総フレーム数が0より大きい場合のみ処理
-	if (animData.totalFrame > 0.0f) {
-		// 現在の再生フレームと総フレームから進行度を計算(0.0f - 1.0f)
-		float progress = animData.frame / animData.totalFrame;
-
-		// 進行度が指定の範囲内である場合攻撃
-		if (progress >= start && progress <= end) {
-			// 当たり判定が行われていない場合は
-			// 攻撃リストをリセット
-			if (!_weapon->GetCollisionState()) {
-				_weapon->ResetAttackState();
-			}
-			_weapon->SetCollisionState(true);	// 当たり判定を有効にする	
-		}
-		else {
-			_weapon->SetCollisionState(false);
+void Player::OnAnimEvent(const Animator::AnimEvent& animEvent)
+{
+	switch (animEvent.type) {
+	case Animator::EventType::HitboxOn:
+		// 当たり判定が行われていない場合は
+		// 攻撃リストをリセット
+		if (!_weapon->GetCollisionState()) {
+			_weapon->ResetAttackState();
 		}
-	}
-	else {
-		// もしアニメーションが再生されていない、または終了している場合は
-		// 当たり判定を無効にする
+		_weapon->SetCollisionState(true);	// 当たり判定を有効にする
+		break;
+	case Animator::EventType::HitboxOff:
 		_weapon->SetCollisionState(false);
+		break;
+	case Animator::EventType::SoundCue:
+		SoundManager::GetInstance().PlaySoundType(static_cast<SEType>(animEvent.param));
+		break;
+	case Animator::EventType::InputWindowOpen:
+		_isInputWindowOpen = true;
+		break;
+	case Animator::EventType::InputWindowClose:
+		_isInputWindowOpen = false;
+		break;
+	default:
+		break;
 	}
 }
 
@@ -706,9 +775,7 @@ void Player::UpdateDash()
 
 void Player::UpdateAttackFirst()
 {
-	// アニメーションの現在のフレームを取得
-	float currentFrame = _animator->GetCurrentAnimFrame();
-	// 現在のアニメーションデータから入力受付期間を取得
+	// 現在のアニメーションデータ(踏み込み期間の計算用)
 	const Animator::AnimData& currentAnimData = _animator->FindAnimData(_animator->GetCurrentAnimName());
 	
 	const int maxStepFrameCount = static_cast<int>(currentAnimData.totalFrame * (0.1f*2));
@@ -719,31 +786,19 @@ void Player::UpdateAttackFirst()
 	}
 
 	// 入力受付期間内かつ
-	// 再生された瞬間ではないかつ
 	// 攻撃ボタンが押されたら
 	// 次の攻撃へ派生可能にする
-	if (currentAnimData.animName == kAnimNameAttackCombo1 &&
-		currentAnimData.frame != currentAnimData.animSpeed*1.1f &&
-		currentFrame >= currentAnimData.inputAcceptanceStartFrame &&
-		currentFrame <= currentAnimData.inputAcceptanceEndFrame &&
+	// (受付期間と効果音はアニメーションイベントで切り替わる)
+	if (_isInputWindowOpen &&
 		CanAttackInput())
 	{
 		_hasDerivedAttackInput = true;
 	}
-
-	if (!_isPlayAttackSound &&
-		currentAnimData.animName == kAnimNameAttackCombo1 &&
-		currentAnimData.frame / currentAnimData.totalFrame >= kAttackCombo1SoundTiming) {
-		SoundManager::GetInstance().PlaySoundType(SEType::Swing1);
-		_isPlayAttackSound = true;
-	}
 }
 
 void Player::UpdateAttackSecond()
 {
-	// アニメーションの現在のフレーム
-	float currentFrame = _animator->GetCurrentAnimFrame();
-	// 現在のアニメーションデータ(入力受付期間取得用)
+	// 現在のアニメーションデータ(踏み込み期間の計算用)
 	const Animator::AnimData& currentAnimData = 
 		_animator->FindAnimData(_animator->GetCurrentAnimName());
 
@@ -755,27 +810,18 @@ void Player::UpdateAttackSecond()
 	}
 
 	// 入力受付期間内かつ、攻撃ボタンが押されたら次の攻撃へ派生可能にする
-	if (currentAnimData.animName == kAnimNameAttackCombo2 &&
-		currentFrame >= currentAnimData.inputAcceptanceStartFrame &&
-		currentFrame <= currentAnimData.inputAcceptanceEndFrame &&
+	if (_isInputWindowOpen &&
 		CanAttackInput())
 	{
 		_hasDerivedAttackInput = true;
 	}
-
-	if (!_isPlayAttackSound &&
-		currentAnimData.animName == kAnimNameAttackCombo2 &&
-		currentAnimData.frame / currentAnimData.totalFrame >= kAttackCombo2SoundTiming) {
-		SoundManager::GetInstance().PlaySoundType(SEType::Swing1);
-		_isPlayAttackSound = true;
-	}
 }
 
 void Player::UpdateAttackThird()
 {
 	// 派生は不要
 
-	// 現在のアニメーションデータ(入力受付期間取得用)
+	// 現在のアニメーションデータ(踏み込み期間の計算用)
 	const Animator::AnimData& currentAnimData =
 		_animator->FindAnimData(_animator->GetCurrentAnimName());
 
@@ -785,13 +831,6 @@ void Player::UpdateAttackThird()
 		// 踏み込みを行う
 		Step(kStepAmount);
 	}
-
-	if (!_isPlayAttackSound &&
-		currentAnimData.animName == kAnimNameAttackCombo3 &&
-		currentAnimData.frame / currentAnimData.totalFrame >= kAttackCombo3SoundTiming) {
-		SoundManager::GetInstance().PlaySoundType(SEType::Swing2);
-		_isPlayAttackSound = true;
-	}
 }
 
 void Player::UpdateDamage()
@@ -1,14 +1,17 @@
 ﻿#pragma once
 #include "Geometry.h"
 #include "Collider.h"
+#include "Animator.h"
+#include "Handle.h"
 #include <memory>
 
 class Camera;
-class Animator;
 class WeaponPlayer;
 class PlayerBuffManager;
 class EnemyManager;
 class Physics;
+class SnapshotWriter;
+class SnapshotReader;
 
 /// <summary>
 /// 
@@ -35,6 +38,11 @@ public:
 	float GetMaxStamina() const;
 	bool IsAlive() { return _isAlive; }
 	float GetAttackPower()const;
+
+	/// <summary>
+	/// 自身を参照するためのHandleを返す
+	/// </summary>
+	Handle<Player> GetHandle() const { return _handle; }
 	
 	/// <summary>
 	/// ダメージを受ける処理
@@ -51,12 +59,22 @@ public:
 
 	void Heal(float amount);
 
+	/// <summary>
+	/// 位置やステータス、ステート、アニメーションの状態を書き込む・読み込む
+	/// </summary>
+	void SaveSnapshot(SnapshotWriter& writer) const;
+	void LoadSnapshot(SnapshotReader& reader);
+
 private:
 	// UpdateのStateパターン
 	// _nowUpdateStateが変数であることを分かりやすくしている
 	using UpdateFunc_t = void(Player::*)();
 	UpdateFunc_t _nowUpdateState;
 
+	// 状態の保存時に番号へ置き換えるためのステート一覧
+	static constexpr int kUpdateStateNum = 8;
+	static const UpdateFunc_t kUpdateStateTable[kUpdateStateNum];
+
 private:
 	/// <summary>
 	/// ステートの遷移条件を確認し、変更可能なステートがあればそれに遷移する
@@ -68,6 +86,12 @@ private:
 	/// </summary>
 	void WeaponUpdate();
 
+	/// <summary>
+	/// アニメーションイベントを受け取る
+	/// (攻撃判定、効果音、派生入力の受付を切り替える)
+	/// </summary>
+	void OnAnimEvent(const Animator::AnimEvent& animEvent);
+
 	void UpdateIdle();
 	void UpdateWalk();
 	void UpdateDash();
@@ -127,10 +151,10 @@ private:
 	std::unique_ptr<Animator> _animator;
 
 	std::weak_ptr<Camera> _camera;
-	std::weak_ptr<EnemyManager> _enemyManager;
+	Handle<EnemyManager> _enemyManager;
 
 	std::shared_ptr<WeaponPlayer> _weapon;
-	std::weak_ptr<PlayerBuffManager> _buffManager;
+	Handle<PlayerBuffManager> _buffManager;
 
 	int _frameCount;
 	float _rotAngle;
@@ -147,6 +171,10 @@ private:
 
 	int _reactCooltime;
 
-	bool _isPlayAttackSound;
+	// 攻撃の派生入力を受け付けているか(アニメーションイベントで切り替わる)
+	bool _isInputWindowOpen;
+
+	// 自身を参照するためのHandle
+	Handle<Player> _handle;
 };
 
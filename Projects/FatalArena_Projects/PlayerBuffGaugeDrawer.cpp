@@ -30,7 +30,8 @@ namespace {
 	};
 }
 
-PlayerBuffGaugeDrawer::PlayerBuffGaugeDrawer()
+PlayerBuffGaugeDrawer::PlayerBuffGaugeDrawer() :
+	_iconBatcher()
 {
 }
 
@@ -90,20 +91,21 @@ void PlayerBuffGaugeDrawer::Draw()
 			
 		}
 
-		// アイコンを描画
+		// アイコンはためておき、全てのゲージの後にまとめて描画する
 		auto iconIt = _buffIconHandles.find(buff.type);
 		if (iconIt != _buffIconHandles.end()) {
 			int handle = iconIt->second;
 			int w, h;
 			GetGraphSize(handle, &w, &h);
-			DrawRectRotaGraph(
-				drawX, drawY,
-				0,0,
-				w,h,
-				kIconScale, 0.0,
-				handle, true,
-				false, false);
+			// 描画位置が中心になるようにする
+			const float halfW = static_cast<float>(w * kIconScale * 0.5);
+			const float halfH = static_cast<float>(h * kIconScale * 0.5);
+			_iconBatcher.AddSprite(handle,
+				drawX - halfW, drawY - halfH,
+				drawX + halfW, drawY + halfH);
 		}
 		drawCount++;
 	}
+
+	_iconBatcher.Flush();
 }
@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include "PlayerBuffManager.h"
+#include "UIBatcher.h"
 #include <memory>
 #include <unordered_map>
 
@@ -31,5 +32,8 @@ private:
 	std::unordered_map<BuffType, int> _buffIconHandles;
 	// ゲージ画像のハンドル
 	std::unordered_map<BuffType, int> _gaugeGraphHandles;
+
+	// アイコンをまとめて描画する
+	UIBatcher _iconBatcher;
 };
 
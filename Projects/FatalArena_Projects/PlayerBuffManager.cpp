@@ -1,9 +1,25 @@
 ﻿#include "PlayerBuffManager.h"
 #include "Player.h"
 #include "PlayerBuffGaugeDrawer.h"
+#include "SnapshotArchive.h"
 
 #include <cassert>
 
+PlayerBuffManager::PlayerBuffManager() :
+	_owner(),
+	_buffs(),
+	_gaugeDrawer(),
+	_handle()
+{
+	// 他のオブジェクトから参照できるよう登録する
+	_handle = SlotMap<PlayerBuffManager>::GetInstance().Insert(this);
+}
+
+PlayerBuffManager::~PlayerBuffManager()
+{
+	SlotMap<PlayerBuffManager>::GetInstance().Remove(_handle);
+}
+
 void PlayerBuffManager::Init(std::weak_ptr<Player> owner)
 {
 	_owner = std::static_pointer_cast<Player>(owner.lock());
@@ -22,6 +38,24 @@ void PlayerBuffManager::Draw()
 	_gaugeDrawer->Draw();
 }
 
+void PlayerBuffManager::SaveSnapshot(SnapshotWriter& writer) const
+{
+	writer.Write(static_cast<int>(_buffs.size()));
+	for (const auto& buff : _buffs) {
+		writer.Write(buff);
+	}
+}
+
+void PlayerBuffManager::LoadSnapshot(SnapshotReader& reader)
+{
+	int buffNum = 0;
+	reader.Read(buffNum);
+	assert(buffNum == static_cast<int>(_buffs.size()) && "バフの数が一致しない");
+	for (auto& buff : _buffs) {
+		reader.Read(buff);
+	}
+}
+
 void PlayerBuffManager::AttachBuff(BuffData input)
 {
 	// 更新対象のアイテムをvectorの末尾に置いてから削除する
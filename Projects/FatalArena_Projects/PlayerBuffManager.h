@@ -1,9 +1,12 @@
 ﻿#pragma once
 #include <memory>
 #include <unordered_map>
+#include "Handle.h"
 
 class Player;
 class PlayerBuffGaugeDrawer;
+class SnapshotWriter;
+class SnapshotReader;
 
 enum class BuffType {
 	Heal,		// 継続回復
@@ -27,6 +30,8 @@ struct BuffData {
 class PlayerBuffManager final : public std::enable_shared_from_this<PlayerBuffManager>
 {
 public:
+	PlayerBuffManager();
+	~PlayerBuffManager();
 
 	void Init(std::weak_ptr<Player> owner);
 	void Update();
@@ -44,6 +49,17 @@ public:
 	/// バフデータのリストを返す
 	/// </summary>
 	const std::vector<BuffData>& GetBuffs() const { return _buffs; }
+
+	/// <summary>
+	/// 自身を参照するためのHandleを返す
+	/// </summary>
+	Handle<PlayerBuffManager> GetHandle() const { return _handle; }
+
+	/// <summary>
+	/// 全てのバフの状態を書き込む・読み込む
+	/// </summary>
+	void SaveSnapshot(SnapshotWriter& writer) const;
+	void LoadSnapshot(SnapshotReader& reader);
 private:
 
 	/// <summary>
@@ -61,5 +77,8 @@ private:
 	std::vector<BuffData> _buffs;	// バフと詳細
 
 	std::shared_ptr<PlayerBuffGaugeDrawer> _gaugeDrawer;
+
+	// 自身を参照するためのHandle
+	Handle<PlayerBuffManager> _handle;
 };
 
@@ -4,6 +4,8 @@
 #include "Statistics.h"
 #include "Input.h"
 #include "SoundManager.h"
+#include "FontManager.h"
+#include "Random.h"
 
 #include <DxLib.h>
 #include <cassert>
@@ -61,17 +63,56 @@ PopupPlayerReinforcement::PopupPlayerReinforcement() :
 	_isProcessingCompleted(false),
 	_playerSelectSerialNumber(0),
 	_playerSelectCursorHandle(-1),
-	_cards()
+	_cards(),
+	_cardPool(),
+	_cardGraphHandles(),
+	_iconGraphHandles(),
+	_headingFontHandle(-1),
+	_enterFontHandle(-1),
+	_headingAtlas(nullptr),
+	_enterAtlas(nullptr),
+	_headingLayout(),
+	_padEnterLayout(),
+	_keybdEnterLayout(),
+	_batcher()
 {
-	_headingFontHandle = CreateFontToHandle(kFontName.c_str(), kHeadingFontSize, kFontThickness,
+	// ウェーブごとに作り直さないよう、共有のフォントを使う
+	_headingFontHandle = FontManager::GetInstance().Acquire(kFontName, kHeadingFontSize, kFontThickness,
 		DX_FONTTYPE_ANTIALIASING_EDGE);
 	assert(_headingFontHandle >= 0 && "フォントの作成に失敗");
-	_enterFontHandle = CreateFontToHandle(kFontName.c_str(), kEnterFontSize, kFontThickness,
+	_enterFontHandle = FontManager::GetInstance().Acquire(kFontName, kEnterFontSize, kFontThickness,
 		DX_FONTTYPE_ANTIALIASING_EDGE);
 	assert(_enterFontHandle >= 0 && "フォントの作成に失敗");
 
+	// 文字をまとめたアトラスを取得し、文字列の配置を先に計算しておく
+	_headingAtlas = &FontManager::GetInstance().GetAtlas(_headingFontHandle);
+	_enterAtlas = &FontManager::GetInstance().GetAtlas(_enterFontHandle);
+	_headingLayout = _headingAtlas->BuildLayout(kHeadingText);
+	_padEnterLayout = _enterAtlas->BuildLayout(kPadEnterText);
+	_keybdEnterLayout = _enterAtlas->BuildLayout(kKeybdEnterText);
+
 	_playerSelectCursorHandle = LoadGraph(kCardIconPaths[4].c_str());
 	assert(_playerSelectCursorHandle >= 0 && "不正なハンドル");
+
+	// 開いたフレームで読み込みが発生しないよう、全ての種別の画像を先に読み込む
+	const int cardTypeNum = static_cast<int>(CardType::TypeNum);
+	_cardGraphHandles.reserve(cardTypeNum);
+	_iconGraphHandles.reserve(cardTypeNum);
+	for (int i = 0; i < cardTypeNum; ++i) {
+		const int cardHandle = LoadGraph(kCardPaths[i].c_str());
+		assert(cardHandle >= 0 && "不正なハンドル");
+		_cardGraphHandles.emplace_back(cardHandle);
+		const int iconHandle = LoadGraph(kCardIconPaths[i].c_str());
+		assert(iconHandle >= 0 && "不正なハンドル");
+		_iconGraphHandles.emplace_back(iconHandle);
+	}
+
+	// カードも最大枚数分を生成しておく
+	_cards.reserve(kMaxPresentationCardAmount);
+	_cardPool.reserve(kMaxPresentationCardAmount);
+	for (int i = 0; i < kMaxPresentationCardAmount; ++i) {
+		_cardPool.emplace_back(std::make_shared<ReinforcementCard>());
+	}
 }
 
 PopupPlayerReinforcement::~PopupPlayerReinforcement()
@@ -79,15 +120,32 @@ PopupPlayerReinforcement::~PopupPlayerReinforcement()
 	if (_playerSelectCursorHandle != -1) {
 		DeleteGraph(_playerSelectCursorHandle);
 	}
+	for (int handle : _cardGraphHandles) {
+		DeleteGraph(handle);
+	}
+	for (int handle : _iconGraphHandles) {
+		DeleteGraph(handle);
+	}
+	if (_headingFontHandle != -1) {
+		FontManager::GetInstance().Release(_headingFontHandle);
+	}
+	if (_enterFontHandle != -1) {
+		FontManager::GetInstance().Release(_enterFontHandle);
+	}
 }
 
 void PopupPlayerReinforcement::Init()
 {
-	// カードの生成
+	// 前回開いたときの状態を戻す
+	_isProcessingCompleted = false;
+	_cards.clear();
+
+	// カードの設定
 	
 	// カード枚数の決定
 	const int generateCardAmount = 
-		kMinPresentationCardAmount + GetRand(kPresentationCardAmountDifference);
+		kMinPresentationCardAmount +
+		RandomService::GetInstance().GetStream(RandomStreamType::Reinforcement).GetInt(kPresentationCardAmountDifference);
 
 	for (int i = 0; i < generateCardAmount; i++) {
 		// カード情報の決定
@@ -96,8 +154,8 @@ void PopupPlayerReinforcement::Init()
 			assert(false && "不正なカードタイプ");
 			cardSerialNum = 0;
 		}
-		int cardHandle = LoadGraph(kCardPaths[cardSerialNum].c_str());
-		int iconHandle = LoadGraph(kCardIconPaths[cardSerialNum].c_str());
+		int cardHandle = _cardGraphHandles[cardSerialNum];
+		int iconHandle = _iconGraphHandles[cardSerialNum];
 		
 		// 画面の幅と端からの余白と描画枚数に考慮して位置決定を行う
 		Position3 centerPos;
@@ -107,9 +165,8 @@ void PopupPlayerReinforcement::Init()
 		centerPos.y = Statistics::kScreenCenterHeight;
 		centerPos.z = 0.0f;
 
-		// カード生成
-		std::shared_ptr<ReinforcementCard> card = 
-			std::make_shared<ReinforcementCard>();
+		// 生成済みのカードに設定する
+		std::shared_ptr<ReinforcementCard> card = _cardPool[i];
 		card->Init(cardHandle, iconHandle, centerPos, kCardScaleMulOffset, kIconScaleMulOffset);
 
 		ReinforcementType type = static_cast<ReinforcementType>(cardSerialNum);
@@ -208,35 +265,25 @@ void PopupPlayerReinforcement::Draw()
 
 	// 見出し、案内文字の描画
 
-	// 文字の中央までの長さをはかり
+	// 文字の中央までの長さから
 	// 描画開始位置を求め描画する
-	int headingTextWidth = GetDrawStringWidthToHandle(
-		kHeadingText.c_str(),
-		(int)kHeadingText.length(),
-		_headingFontHandle);
-	int headingDrawX = (int)((Statistics::kScreenWidth - headingTextWidth) * 0.5f);
-	DrawStringToHandle(
-		headingDrawX, kHeadingTextY,
-		kHeadingText.c_str(), kTextColor,
-		_headingFontHandle);
+	int headingDrawX = (int)((Statistics::kScreenWidth - _headingLayout.width) * 0.5f);
+	_headingAtlas->DrawLayout(_batcher, _headingLayout,
+		(float)headingDrawX, (float)kHeadingTextY, kTextColor);
 
 	// 最後の入力に応じて文字を変える
-	std::wstring drawString = kPadEnterText;
+	const TextLayout* drawLayout = &_padEnterLayout;
 	if (Input::GetInstance().GetLastInputType() == Input::PeripheralType::keybd) {
-		drawString = kKeybdEnterText;
+		drawLayout = &_keybdEnterLayout;
 	}
 
-	// 文字の中央までの長さをはかり
-	// 描画開始位置を求め描画する
-	int enterTextWidth = GetDrawStringWidthToHandle(
-		drawString.c_str(),
-		(int)drawString.length(),
-		_enterFontHandle);
-	int enterDrawX = (int)((Statistics::kScreenWidth - enterTextWidth) * 0.5f);
-	DrawStringToHandle(
-		enterDrawX, kEnterYOffset,
-		drawString.c_str(), kTextColor,
-		_enterFontHandle);
+	// 同様に描画する
+	int enterDrawX = (int)((Statistics::kScreenWidth - drawLayout->width) * 0.5f);
+	_enterAtlas->DrawLayout(_batcher, *drawLayout,
+		(float)enterDrawX, (float)kEnterYOffset, kTextColor);
+
+	// 文字をまとめて描画する
+	_batcher.Flush();
 }
 
 void PopupPlayerReinforcement::Final()
@@ -1,5 +1,7 @@
 ﻿#pragma once
 #include "PopupBase.h"
+#include "GlyphAtlas.h"
+#include "UIBatcher.h"
 #include <memory>
 #include <vector>
 #include <map>
@@ -10,11 +12,16 @@ enum class ReinforcementType;
 class PopupPlayerReinforcement : public PopupBase
 {
 public:
+	/// <summary>
+	/// 表示に使う画像とフォントをまとめて読み込む
+	/// (試合ごとに1度だけ生成し、ウェーブごとに使い回す)
+	/// </summary>
 	PopupPlayerReinforcement();
 	~PopupPlayerReinforcement();
 
 	/// <summary>
 	/// 初期化
+	/// 状態を戻して提示するカードを選び直す(読み込みは行わない)
 	/// </summary>
 	void Init() override;
 
@@ -48,9 +55,23 @@ private:
 
 	// タイプとカードのポインタを管理
 	std::vector<std::pair<ReinforcementType, std::shared_ptr<ReinforcementCard>>> _cards;		// 表示を行うカード
+	// 提示できる最大枚数分のカード(開くたびに設定し直して使い回す)
+	std::vector<std::shared_ptr<ReinforcementCard>> _cardPool;
+
+	// カード種別ごとの画像(生成時に読み込み、破棄まで保持する)
+	std::vector<int> _cardGraphHandles;
+	std::vector<int> _iconGraphHandles;
 
 	int _headingFontHandle;	// 見出し文字ハンドル
 	int _enterFontHandle;
 
+	// 文字をまとめた画像と、内容が変わらない文字列の配置
+	const GlyphAtlas* _headingAtlas;
+	const GlyphAtlas* _enterAtlas;
+	TextLayout _headingLayout;
+	TextLayout _padEnterLayout;
+	TextLayout _keybdEnterLayout;
+	UIBatcher _batcher;
+
 };
 
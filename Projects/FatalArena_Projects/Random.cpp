@@ -0,0 +1,160 @@
+﻿#include "Random.h"
+#include "SnapshotArchive.h"
+#include <cassert>
+
+namespace {
+	// 系列ごとのシード値を作る際に混ぜる値(黄金比)
+	constexpr uint64_t kStreamSeedStep = 0x9e3779b97f4a7c15ull;
+
+	/// <summary>
+	/// 64bitの値をかき混ぜて次の値を返す(SplitMix64)
+	/// 近いシード値からでも偏りのない初期状態を作るために使う
+	/// </summary>
+	uint64_t SplitMix64(uint64_t& x)
+	{
+		x += kStreamSeedStep;
+		uint64_t z = x;
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		return z ^ (z >> 31);
+	}
+
+	uint32_t RotateLeft(uint32_t x, int k)
+	{
+		return (x << k) | (x >> (32 - k));
+	}
+}
+
+RandomStream::RandomStream() :
+	_state()
+{
+	SetSeed(0);
+}
+
+void RandomStream::SetSeed(uint64_t seed)
+{
+	uint64_t x = seed;
+	const uint64_t a = SplitMix64(x);
+	const uint64_t b = SplitMix64(x);
+	_state[0] = static_cast<uint32_t>(a);
+	_state[1] = static_cast<uint32_t>(a >> 32);
+	_state[2] = static_cast<uint32_t>(b);
+	_state[3] = static_cast<uint32_t>(b >> 32);
+}
+
+uint32_t RandomStream::Next()
+{
+	const uint32_t result = RotateLeft(_state[1] * 5, 7) * 9;
+	const uint32_t t = _state[1] << 9;
+
+	_state[2] ^= _state[0];
+	_state[3] ^= _state[1];
+	_state[1] ^= _state[2];
+	_state[0] ^= _state[3];
+	_state[2] ^= t;
+	_state[3] = RotateLeft(_state[3], 11);
+
+	return result;
+}
+
+int RandomStream::GetInt(int max)
+{
+	if (max <= 0) return 0;
+	// 乗算で範囲に収める(剰余より偏りが小さく速い)
+	const uint64_t range = static_cast<uint64_t>(max) + 1;
+	return static_cast<int>((static_cast<uint64_t>(Next()) * range) >> 32);
+}
+
+int RandomStream::GetRange(int min, int max)
+{
+	assert(min <= max && "範囲が正しくない");
+	return min + GetInt(max - min);
+}
+
+float RandomStream::GetFloat()
+{
+	// 上位24bitを仮数部として使う
+	return static_cast<float>(Next() >> 8) * (1.0f / 16777216.0f);
+}
+
+float RandomStream::GetFloat(float min, float max)
+{
+	return min + (max - min) * GetFloat();
+}
+
+void RandomStream::FillFloat(std::vector<float>& out, int count, float min, float max)
+{
+	out.resize(count);
+	const float range = max - min;
+	for (int i = 0; i < count; ++i) {
+		out[i] = min + range * GetFloat();
+	}
+}
+
+void RandomStream::FillInt(std::vector<int>& out, int count, int max)
+{
+	out.resize(count);
+	for (int i = 0; i < count; ++i) {
+		out[i] = GetInt(max);
+	}
+}
+
+void RandomStream::SaveSnapshot(SnapshotWriter& writer) const
+{
+	writer.Write(_state);
+}
+
+void RandomStream::LoadSnapshot(SnapshotReader& reader)
+{
+	reader.Read(_state);
+}
+
+RandomService& RandomService::GetInstance()
+{
+	static RandomService instance;
+	return instance;
+}
+
+RandomService::RandomService() :
+	_seed(0),
+	_streams()
+{
+	ResetStreams();
+}
+
+void RandomService::SetSeed(uint64_t seed)
+{
+	_seed = seed;
+	ResetStreams();
+}
+
+void RandomService::ResetStreams()
+{
+	// 系列ごとに異なるシード値を試合のシード値から作る
+	uint64_t x = _seed;
+	for (auto& stream : _streams) {
+		stream.SetSeed(SplitMix64(x));
+	}
+}
+
+void RandomService::SaveSnapshot(SnapshotWriter& writer) const
+{
+	writer.Write(_seed);
+	for (const auto& stream : _streams) {
+		stream.SaveSnapshot(writer);
+	}
+}
+
+void RandomService::LoadSnapshot(SnapshotReader& reader)
+{
+	reader.Read(_seed);
+	for (auto& stream : _streams) {
+		stream.LoadSnapshot(reader);
+	}
+}
+
+RandomStream& RandomService::GetStream(RandomStreamType type)
+{
+	assert(type != RandomStreamType::TypeNum && "系列の種類が正しくない");
+	return _streams[static_cast<int>(type)];
+}
@@ -0,0 +1,130 @@
+﻿#pragma once
+#include <cstdint>
+#include <vector>
+
+class SnapshotWriter;
+class SnapshotReader;
+
+/// <summary>
+/// 乱数の系列の種類
+/// 系列ごとに独立した乱数を使うことで、
+/// ある処理の乱数の使用回数が変わっても他の処理の結果が変化しない
+/// </summary>
+enum class RandomStreamType
+{
+	EnemySpawn,		// 敵の生成位置
+	ItemSpawn,		// アイテムの種類と生成位置
+	Billboard,		// 観客の配置
+	Reinforcement,	// 強化カード
+	UI,				// 演出(ゲームの結果に影響しないもの)
+	TypeNum
+};
+
+/// <summary>
+/// 1つの乱数の系列(xoshiro128**)
+/// スレッドセーフではないため、1つの系列は1つのスレッドから使うこと
+/// </summary>
+class RandomStream final
+{
+public:
+	RandomStream();
+
+	/// <summary>
+	/// シード値から内部状態を初期化する
+	/// </summary>
+	void SetSeed(uint64_t seed);
+
+	/// <summary>
+	/// 32bitの乱数を返す
+	/// </summary>
+	uint32_t Next();
+
+	/// <summary>
+	/// 0からmaxまで(maxを含む)の整数を返す
+	/// (DxLibのGetRandと同じ範囲)
+	/// </summary>
+	int GetInt(int max);
+
+	/// <summary>
+	/// minからmaxまで(maxを含む)の整数を返す
+	/// </summary>
+	int GetRange(int min, int max);
+
+	/// <summary>
+	/// 0.0以上1.0未満の実数を返す
+	/// </summary>
+	float GetFloat();
+
+	/// <summary>
+	/// min以上max未満の実数を返す
+	/// </summary>
+	float GetFloat(float min, float max);
+
+	/// <summary>
+	/// min以上max未満の実数をまとめて生成する
+	/// </summary>
+	/// <param name="out">結果(中身は置き換える)</param>
+	/// <param name="count">生成する数</param>
+	void FillFloat(std::vector<float>& out, int count, float min, float max);
+
+	/// <summary>
+	/// 0からmaxまで(maxを含む)の整数をまとめて生成する
+	/// </summary>
+	/// <param name="out">結果(中身は置き換える)</param>
+	/// <param name="count">生成する数</param>
+	void FillInt(std::vector<int>& out, int count, int max);
+
+	/// <summary>
+	/// 内部状態を書き込む・読み込む
+	/// </summary>
+	void SaveSnapshot(SnapshotWriter& writer) const;
+	void LoadSnapshot(SnapshotReader& reader);
+
+private:
+	uint32_t _state[4];
+};
+
+/// <summary>
+/// 1つの試合用のシード値から、処理ごとに独立した乱数の系列を作って管理する
+/// 同じシード値であれば同じ試合を再現できる
+/// </summary>
+class RandomService final
+{
+public:
+	/// <summary>
+	/// シングルトンオブジェクトを返す
+	/// </summary>
+	static RandomService& GetInstance();
+
+	/// <summary>
+	/// シード値を設定し、全ての系列を初期化する
+	/// </summary>
+	void SetSeed(uint64_t seed);
+
+	/// <summary>
+	/// 現在のシード値で全ての系列を初期化し直す
+	/// 試合の開始時に呼ぶ
+	/// </summary>
+	void ResetStreams();
+
+	uint64_t GetSeed() const { return _seed; }
+
+	/// <summary>
+	/// 指定の種類の系列を返す
+	/// </summary>
+	RandomStream& GetStream(RandomStreamType type);
+
+	/// <summary>
+	/// シード値と全ての系列の内部状態を書き込む・読み込む
+	/// </summary>
+	void SaveSnapshot(SnapshotWriter& writer) const;
+	void LoadSnapshot(SnapshotReader& reader);
+
+private:
+	RandomService();
+	RandomService(const RandomService&) = delete;
+	void operator=(const RandomService&) = delete;
+
+	uint64_t _seed;
+	RandomStream _streams[static_cast<int>(RandomStreamType::TypeNum)];
+};
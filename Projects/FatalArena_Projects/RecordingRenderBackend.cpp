@@ -0,0 +1,45 @@
+﻿#include "RecordingRenderBackend.h"
+
+RecordingRenderBackend::RecordingRenderBackend() :
+	_records(),
+	_nowStateKey(0),
+	_stateChangeCount(0),
+	_isExecuteCustom(false)
+{
+}
+
+RecordingRenderBackend::~RecordingRenderBackend()
+{
+}
+
+void RecordingRenderBackend::Begin()
+{
+	_records.clear();
+	_nowStateKey = 0;
+	_stateChangeCount = 0;
+}
+
+void RecordingRenderBackend::ChangeState(uint64_t stateKey)
+{
+	_nowStateKey = stateKey;
+	++_stateChangeCount;
+}
+
+void RecordingRenderBackend::Execute(const RenderCommand& command)
+{
+	Record record;
+	record.stateKey = _nowStateKey;
+	record.shader = command.shader;
+	record.modelHandle = command.modelHandle;
+	record.sourceHandle = command.sourceHandle;
+	record.pos = command.pos;
+	_records.emplace_back(record);
+
+	if (_isExecuteCustom && command.shader == RenderShader::Custom && command.func) {
+		command.func();
+	}
+}
+
+void RecordingRenderBackend::End()
+{
+}
@@ -0,0 +1,49 @@
+﻿#pragma once
+#include "RenderQueue.h"
+#include <vector>
+#include <cstdint>
+
+/// <summary>
+/// 描画命令を実行せずに、渡された順と状態の切り替えを記録する
+/// 描画を行わずに描画キューの並び順を確認する際に使用する
+/// </summary>
+class RecordingRenderBackend final : public RenderBackendBase
+{
+public:
+	// 記録した描画命令1つ分の情報
+	struct Record
+	{
+		uint64_t stateKey = 0;	// 実行時の描画の状態
+		RenderShader shader = RenderShader::Custom;
+		int modelHandle = -1;
+		int sourceHandle = -1;
+		Position3 pos;			// 設定する位置(Impostorの場合は画像の下端の中心)
+	};
+
+	RecordingRenderBackend();
+	~RecordingRenderBackend();
+
+	void Begin() override;
+	void ChangeState(uint64_t stateKey) override;
+	void Execute(const RenderCommand& command) override;
+	void End() override;
+
+	/// <summary>
+	/// 実行された順の描画命令
+	/// </summary>
+	const std::vector<Record>& GetRecords() const { return _records; }
+	/// <summary>
+	/// 描画の状態が切り替わった回数
+	/// </summary>
+	int GetStateChangeCount() const { return _stateChangeCount; }
+	/// <summary>
+	/// Customの描画処理も実行するかを設定する
+	/// </summary>
+	void SetExecuteCustom(bool isExecute) { _isExecuteCustom = isExecute; }
+
+private:
+	std::vector<Record> _records;
+	uint64_t _nowStateKey;
+	int _stateChangeCount;
+	bool _isExecuteCustom;
+};
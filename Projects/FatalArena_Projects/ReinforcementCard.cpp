@@ -23,13 +23,7 @@ ReinforcementCard::ReinforcementCard() :
 
 ReinforcementCard::~ReinforcementCard()
 {
-	if (_cardHandle != -1) {
-		DeleteGraph(_cardHandle);
-	}
-	if (_iconHandle != -1) {
-		DeleteGraph(_iconHandle);
-	}
-	
+	// 画像はポップアップが保持しているため解放しない
 }
 
 void ReinforcementCard::Init(int cardHandle, int iconHandle, Position3 centerPos, 
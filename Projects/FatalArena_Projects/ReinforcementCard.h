@@ -17,6 +17,10 @@ public:
 	ReinforcementCard();
 	~ReinforcementCard();
 
+	/// <summary>
+	/// 表示内容を設定する(何度でも呼び直せる)
+	/// 画像は呼び出し側が保持し、解放すること
+	/// </summary>
 	void Init(int cardHandle, int iconHandle, Position3 centerPos, 
 		float cardScaleOffset, float iconScaleOffset);
 	void Update();
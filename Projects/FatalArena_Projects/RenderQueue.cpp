@@ -0,0 +1,244 @@
+﻿#include "RenderQueue.h"
+#include "RenderSnapshot.h"
+#include <cassert>
+#include <cstring>
+#include <array>
+
+namespace {
+	// 並べ替えキーの各要素のビット位置と幅
+	// 不透明:上位から 層 / 半透明(0) / 種類 / テクスチャやモデル / 奥行き
+	// 半透明:上位から 層 / 半透明(1) / 奥行き(反転) / 種類 / テクスチャやモデル
+	// (半透明は重なりを正しく描くため、状態よりも奥からの順を優先する)
+	constexpr int kDepthBits = 32;
+	constexpr int kMaterialBits = 20;
+	constexpr int kShaderBits = 7;
+	constexpr int kMaterialShift = kDepthBits;
+	constexpr int kShaderShift = kMaterialShift + kMaterialBits;
+	constexpr int kTransparentShift = kShaderShift + kShaderBits;
+	constexpr int kLayerShift = kTransparentShift + 1;
+	constexpr int kTransparentMaterialShift = 0;
+	constexpr int kTransparentShaderShift = kTransparentMaterialShift + kMaterialBits;
+	constexpr int kTransparentDepthShift = kTransparentShaderShift + kShaderBits;
+	static_assert(kTransparentDepthShift + kDepthBits == kTransparentShift,
+		"半透明の並べ替えキーが半透明のビットと重なっている");
+
+	constexpr uint64_t kDepthMask = (1ull << kDepthBits) - 1;
+	constexpr uint32_t kMaxMaterialId = (1u << kMaterialBits) - 1;
+
+	// 半透明なCustomの奥行き(下位に追加した順を入れる)
+	// 反転した奥行きの最大値付近を使い、半透明なモデルを全て描画した後に追加した順で実行する
+	constexpr uint32_t kTransparentCustomDepth = 0xFFFF0000u;
+	constexpr uint32_t kMaxTransparentCustomNum = 0x10000u;
+
+	// 基数ソートで一度に扱うビット数
+	constexpr int kRadixBits = 8;
+	constexpr int kRadixSize = 1 << kRadixBits;
+	constexpr int kRadixPassNum = 64 / kRadixBits;
+
+	/// <summary>
+	/// 並べ替えキーを作成する
+	/// </summary>
+	uint64_t MakeKey(RenderLayer layer, bool isTransparent, RenderShader shader,
+		uint32_t materialId, uint32_t depth)
+	{
+		const uint64_t layerBits = static_cast<uint64_t>(layer) << kLayerShift;
+		if (isTransparent) {
+			return layerBits | (1ull << kTransparentShift) |
+				(static_cast<uint64_t>(depth) << kTransparentDepthShift) |
+				(static_cast<uint64_t>(shader) << kTransparentShaderShift) |
+				(static_cast<uint64_t>(materialId) << kTransparentMaterialShift);
+		}
+		return layerBits |
+			(static_cast<uint64_t>(shader) << kShaderShift) |
+			(static_cast<uint64_t>(materialId) << kMaterialShift) |
+			static_cast<uint64_t>(depth);
+	}
+
+	/// <summary>
+	/// 0以上の距離をキーの奥行きに変換する
+	/// (0以上のfloatはビット列を整数として比べても大小が変わらない)
+	/// </summary>
+	uint32_t ToDepth(float distSq, bool isTransparent)
+	{
+		uint32_t bits = 0;
+		std::memcpy(&bits, &distSq, sizeof(bits));
+		// 半透明は奥から描画する
+		return isTransparent ? ~bits : bits;
+	}
+}
+
+RenderQueue::RenderQueue() :
+	_commands(),
+	_keys(),
+	_order(),
+	_orderTemp(),
+	_keysTemp(),
+	_materialIds(),
+	_sequence(0),
+	_stateChangeCount(0)
+{
+}
+
+RenderQueue::~RenderQueue()
+{
+}
+
+void RenderQueue::Clear()
+{
+	_commands.clear();
+	_keys.clear();
+	_order.clear();
+	_sequence = 0;
+}
+
+void RenderQueue::SubmitModels(const RenderSnapshot& snapshot, const Position3& eyePos)
+{
+	const bool isCulled = (snapshot.isVisible.size() == snapshot.models.size());
+	for (size_t i = 0; i < snapshot.models.size(); ++i) {
+		// 視界外であれば描画しない
+		if (isCulled && !snapshot.isVisible[i]) continue;
+
+		const auto& instance = snapshot.models[i];
+		const float dx = snapshot.boundsX[i] - eyePos.x;
+		const float dy = snapshot.boundsY[i] - eyePos.y;
+		const float dz = snapshot.boundsZ[i] - eyePos.z;
+		const float distSq = dx * dx + dy * dy + dz * dz;
+
+		// 画像の場合は縁が半透明になるため奥から描画する
+		if (instance.impostorGraph >= 0) {
+			const uint64_t key = MakeKey(RenderLayer::World, true, RenderShader::Impostor,
+				ToMaterialId(instance.impostorGraph), ToDepth(distSq, true));
+
+			RenderCommand command;
+			command.shader = RenderShader::Impostor;
+			command.pos = instance.pos;
+			command.graphHandle = instance.impostorGraph;
+			command.width = instance.impostorWidth;
+			command.height = instance.impostorHeight;
+			Push(key, std::move(command));
+			continue;
+		}
+
+		// 複製元が同じものは同じ状態として扱う
+		const int materialHandle = (instance.sourceHandle >= 0) ?
+			instance.sourceHandle : instance.modelHandle;
+		const uint64_t key = MakeKey(RenderLayer::World, false, RenderShader::Model,
+			ToMaterialId(materialHandle), ToDepth(distSq, false));
+
+		RenderCommand command;
+		command.shader = RenderShader::Model;
+		command.modelHandle = instance.modelHandle;
+		command.sourceHandle = instance.sourceHandle;
+		command.isSetPosition = instance.isSetPosition;
+		command.pos = instance.pos;
+		Push(key, std::move(command));
+	}
+}
+
+void RenderQueue::SubmitCustom(RenderLayer layer, bool isTransparent, const std::function<void()>& func)
+{
+	// 奥行きの代わりに追加した順を使う
+	// (半透明の場合は奥行きが上位に来るため、全てのモデルより後になる値に順を入れる)
+	uint32_t depth = _sequence++;
+	if (isTransparent) {
+		assert(depth < kMaxTransparentCustomNum && "半透明な描画処理が多すぎる");
+		depth |= kTransparentCustomDepth;
+	}
+	const uint64_t key = MakeKey(layer, isTransparent, RenderShader::Custom, 0, depth);
+
+	RenderCommand command;
+	command.shader = RenderShader::Custom;
+	command.func = func;
+	Push(key, std::move(command));
+}
+
+void RenderQueue::Sort()
+{
+	const uint32_t num = static_cast<uint32_t>(_keys.size());
+	_order.resize(num);
+	for (uint32_t i = 0; i < num; ++i) {
+		_order[i] = i;
+	}
+	if (num <= 1) return;
+
+	// 8ビットずつの基数ソート(下位から並べるため同じキーは追加した順を保つ)
+	// 全ての桁の度数を先にまとめて数え、全要素が同じ値の桁は飛ばす
+	std::array<std::array<uint32_t, kRadixSize>, kRadixPassNum> counts = {};
+	for (uint64_t key : _keys) {
+		for (int pass = 0; pass < kRadixPassNum; ++pass) {
+			++counts[pass][(key >> (pass * kRadixBits)) & (kRadixSize - 1)];
+		}
+	}
+
+	_keysTemp.resize(num);
+	_orderTemp.resize(num);
+	for (int pass = 0; pass < kRadixPassNum; ++pass) {
+		auto& count = counts[pass];
+		const int shift = pass * kRadixBits;
+		if (count[(_keys[0] >> shift) & (kRadixSize - 1)] == num) continue;
+
+		// 度数を書き込み位置に変換する
+		uint32_t offset = 0;
+		for (auto& c : count) {
+			const uint32_t n = c;
+			c = offset;
+			offset += n;
+		}
+		for (uint32_t i = 0; i < num; ++i) {
+			const uint32_t dst = count[(_keys[i] >> shift) & (kRadixSize - 1)]++;
+			_keysTemp[dst] = _keys[i];
+			_orderTemp[dst] = _order[i];
+		}
+		_keys.swap(_keysTemp);
+		_order.swap(_orderTemp);
+	}
+}
+
+void RenderQueue::Execute(RenderBackendBase& backend)
+{
+	assert(_order.size() == _commands.size() && "並べ替えが行われていない");
+
+	_stateChangeCount = 0;
+	backend.Begin();
+	bool isFirst = true;
+	uint64_t prevState = 0;
+	for (size_t i = 0; i < _order.size(); ++i) {
+		// _keysは並べ替え済みの順になっている
+		const uint64_t state = ToStateKey(_keys[i]);
+		if (isFirst || state != prevState) {
+			backend.ChangeState(state);
+			++_stateChangeCount;
+			prevState = state;
+			isFirst = false;
+		}
+		backend.Execute(_commands[_order[i]]);
+	}
+	backend.End();
+}
+
+uint64_t RenderQueue::ToStateKey(uint64_t key)
+{
+	// 半透明かどうかで奥行きの位置が異なる
+	if ((key >> kTransparentShift) & 1) {
+		return key & ~(kDepthMask << kTransparentDepthShift);
+	}
+	return key & ~kDepthMask;
+}
+
+void RenderQueue::Push(uint64_t key, RenderCommand&& command)
+{
+	_commands.emplace_back(std::move(command));
+	_keys.emplace_back(key);
+}
+
+uint32_t RenderQueue::ToMaterialId(int handle)
+{
+	auto it = _materialIds.find(handle);
+	if (it != _materialIds.end()) return it->second;
+
+	// 0はオブジェクト自身の描画処理に使う
+	const uint32_t id = static_cast<uint32_t>(_materialIds.size()) + 1;
+	assert(id <= kMaxMaterialId && "テクスチャやモデルの種類が多すぎる");
+	_materialIds.emplace(handle, id);
+	return id;
+}
@@ -0,0 +1,155 @@
+﻿#pragma once
+#include "Vector3.h"
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+
+struct RenderSnapshot;
+
+/// <summary>
+/// 描画の層(小さいものから描画する)
+/// </summary>
+enum class RenderLayer : uint8_t {
+	Background,	// 天球、アリーナ
+	World,		// キャラクター、アイテム、観客
+	UI,			// 画面上の表示
+};
+
+/// <summary>
+/// 描画の種類
+/// </summary>
+enum class RenderShader : uint8_t {
+	Model,		// MV1のモデル
+	Impostor,	// モデルの代わりのビルボード
+	Custom,		// オブジェクト自身の描画処理
+};
+
+/// <summary>
+/// 描画命令1つ分の情報
+/// </summary>
+struct RenderCommand
+{
+	RenderShader shader = RenderShader::Custom;
+	// Modelの場合
+	int modelHandle = -1;
+	int sourceHandle = -1;		// 複製元のモデル(同じものを続けて描画する。-1なら自身)
+	bool isSetPosition = false;	// 描画前に位置を設定するか
+	Position3 pos;				// 設定する位置(Impostorの場合は画像の下端の中心)
+	// Impostorの場合
+	int graphHandle = -1;
+	float width = 0.0f;
+	float height = 0.0f;
+	// Customの場合
+	std::function<void()> func;
+};
+
+/// <summary>
+/// 並べ替えた描画命令を実際に実行する側の基底クラス
+/// </summary>
+class RenderBackendBase
+{
+public:
+	virtual ~RenderBackendBase() = default;
+
+	/// <summary>
+	/// 描画命令の実行を始める前に呼ばれる
+	/// </summary>
+	virtual void Begin() = 0;
+	/// <summary>
+	/// 描画の状態(層、半透明、種類、テクスチャやモデル)が変わる際に呼ばれる
+	/// </summary>
+	/// <param name="stateKey">並べ替えキーから奥行きを除いたもの</param>
+	virtual void ChangeState(uint64_t stateKey) = 0;
+	/// <summary>
+	/// 描画命令を実行する
+	/// </summary>
+	virtual void Execute(const RenderCommand& command) = 0;
+	/// <summary>
+	/// 全ての描画命令を実行した後に呼ばれる
+	/// </summary>
+	virtual void End() = 0;
+};
+
+/// <summary>
+/// 1フレーム分の描画命令をためておき、状態の切り替えが少なくなる順に並べ替えて実行する
+/// 並べ替えキーは上位から 層 / 半透明 / 種類 / テクスチャやモデル / 奥行き
+/// 不透明なものは手前から、半透明なものは奥から描画する
+/// (半透明なものは状態より奥行きを優先し、種類とテクスチャやモデルを奥行きの下に置く)
+/// </summary>
+class RenderQueue final
+{
+public:
+	RenderQueue();
+	~RenderQueue();
+
+	/// <summary>
+	/// 描画命令を空にする(確保済みの領域は使い回す)
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// スナップショットのうち視界内のモデルを追加する
+	/// </summary>
+	/// <param name="eyePos">奥行きの基準となるカメラの位置</param>
+	void SubmitModels(const RenderSnapshot& snapshot, const Position3& eyePos);
+
+	/// <summary>
+	/// オブジェクト自身の描画処理を追加する
+	/// 同じ層・半透明の中では追加した順に実行する
+	/// (半透明の場合は、同じ層の半透明なモデルを全て描画した後になる)
+	/// </summary>
+	void SubmitCustom(RenderLayer layer, bool isTransparent, const std::function<void()>& func);
+
+	/// <summary>
+	/// 描画命令を並べ替える
+	/// </summary>
+	void Sort();
+
+	/// <summary>
+	/// 並べ替えた順に描画命令を実行する
+	/// </summary>
+	void Execute(RenderBackendBase& backend);
+
+	/// <summary>
+	/// ためている描画命令の数
+	/// </summary>
+	int GetCommandCount() const { return static_cast<int>(_commands.size()); }
+	/// <summary>
+	/// 直近のExecuteで描画の状態が切り替わった回数
+	/// </summary>
+	int GetStateChangeCount() const { return _stateChangeCount; }
+
+	/// <summary>
+	/// 並べ替えキーから奥行きを除いたもの(描画の状態)を返す
+	/// </summary>
+	static uint64_t ToStateKey(uint64_t key);
+
+private:
+	/// <summary>
+	/// 描画命令を追加する
+	/// </summary>
+	void Push(uint64_t key, RenderCommand&& command);
+
+	/// <summary>
+	/// テクスチャやモデルのハンドルを、キーに収まる小さな番号に変換する
+	/// </summary>
+	uint32_t ToMaterialId(int handle);
+
+	std::vector<RenderCommand> _commands;
+	// _commandsと同じ並びの並べ替えキー
+	std::vector<uint64_t> _keys;
+
+	// 並べ替えた結果(_commandsの番号)と、並べ替えの作業領域
+	std::vector<uint32_t> _order;
+	std::vector<uint32_t> _orderTemp;
+	std::vector<uint64_t> _keysTemp;
+
+	// キー:ハンドル, 値:キーに使う番号
+	std::unordered_map<int, uint32_t> _materialIds;
+
+	// 追加した順を保つための番号
+	uint32_t _sequence;
+
+	int _stateChangeCount;
+};
@@ -0,0 +1,138 @@
+﻿#include "SelfTest.h"
+#include "RenderQueue.h"
+#include "RenderSnapshot.h"
+#include "RecordingRenderBackend.h"
+#include <vector>
+
+namespace {
+	// 複製元のモデル(同じものは同じ状態で描画される)
+	constexpr int kSourceA = 1;
+	constexpr int kSourceB = 2;
+	// モデルの代わりに描画する画像
+	constexpr int kImpostorGraph = 3;
+	// 奥行きが交互になるよう置く2種類の画像
+	constexpr int kImpostorGraphA = 4;
+	constexpr int kImpostorGraphB = 5;
+
+	// Customの描画処理の識別番号
+	enum CustomId {
+		kCameraId,
+		kSkydomeId,
+		kArenaId,
+		kPlayerId,
+		kBillboardId,
+		kUIId,
+	};
+
+	// 期待する状態の切り替え回数
+	// Background(Custom) / World:A / World:B / World(Custom) / World半透明:画像 / World半透明(Custom) / UI
+	constexpr int kExpectedStateChangeNum = 7;
+
+	/// <summary>
+	/// カメラからZ方向に指定の距離だけ離れた境界球
+	/// </summary>
+	BoundingSphere MakeBounds(float dist)
+	{
+		return { Position3(0.0f, 0.0f, dist), 1.0f };
+	}
+}
+
+void SelfTest::RunRenderQueueTests()
+{
+	PrintHeader("RenderQueue");
+
+	// 距離の順をばらばらにして追加する(ハンドルは距離と同じ値にしておく)
+	RenderSnapshot snapshot;
+	snapshot.AddModel(300, MakeBounds(300.0f), kSourceA);
+	snapshot.AddImpostor(kImpostorGraph, Position3(0.0f, 0.0f, 50.0f), 1.0f, 1.0f, MakeBounds(50.0f));
+	snapshot.AddModel(100, MakeBounds(100.0f), kSourceA);
+	snapshot.AddModel(250, MakeBounds(250.0f), kSourceB);
+	snapshot.AddImpostor(kImpostorGraph, Position3(0.0f, 0.0f, 400.0f), 1.0f, 1.0f, MakeBounds(400.0f));
+	snapshot.AddModel(200, MakeBounds(200.0f), kSourceA);
+	snapshot.AddModel(150, MakeBounds(150.0f), kSourceB);
+
+	// Customは層と半透明をばらばらにして追加する
+	std::vector<int> customOrder;
+	auto makeFunc = [&customOrder](int id) { return [&customOrder, id]() { customOrder.emplace_back(id); }; };
+	RenderQueue queue;
+	queue.SubmitCustom(RenderLayer::UI, false, makeFunc(kUIId));
+	queue.SubmitCustom(RenderLayer::World, true, makeFunc(kBillboardId));
+	queue.SubmitCustom(RenderLayer::Background, false, makeFunc(kCameraId));
+	queue.SubmitCustom(RenderLayer::Background, false, makeFunc(kSkydomeId));
+	queue.SubmitCustom(RenderLayer::Background, false, makeFunc(kArenaId));
+	queue.SubmitCustom(RenderLayer::World, false, makeFunc(kPlayerId));
+	queue.SubmitModels(snapshot, Position3(0.0f, 0.0f, 0.0f));
+
+	RecordingRenderBackend backend;
+	backend.SetExecuteCustom(true);
+	queue.Sort();
+	queue.Execute(backend);
+	const auto& records = backend.GetRecords();
+
+	// Customは層の順、同じ層の中では追加した順に実行される
+	const std::vector<int> expectedCustomOrder = {
+		kCameraId, kSkydomeId, kArenaId, kPlayerId, kBillboardId, kUIId };
+	Check(customOrder == expectedCustomOrder, "custom draws run by layer, then in submission order");
+	Check(!customOrder.empty() && customOrder.front() == kCameraId,
+		"the camera (lighting) submitted first in Background runs before every model");
+
+	// 不透明なモデルは複製元ごとにまとまり、その中で手前から描画される
+	std::vector<int> modelOrder;
+	for (const auto& record : records) {
+		if (record.shader == RenderShader::Model) {
+			modelOrder.emplace_back(record.modelHandle);
+		}
+	}
+	const std::vector<int> expectedModelOrder = { 100, 200, 300, 150, 250 };
+	Check(modelOrder == expectedModelOrder, "opaque models are grouped by source and drawn front to back");
+
+	// 半透明の画像は不透明なものより後に、奥から描画される
+	int lastOpaque = -1;
+	std::vector<int> impostorIndices;
+	for (int i = 0; i < static_cast<int>(records.size()); ++i) {
+		if (records[i].shader == RenderShader::Model) {
+			lastOpaque = i;
+		}
+		else if (records[i].shader == RenderShader::Impostor) {
+			impostorIndices.emplace_back(i);
+		}
+	}
+	Check(impostorIndices.size() == 2 && impostorIndices.front() > lastOpaque,
+		"transparent impostors are drawn after every opaque model");
+	Check(impostorIndices.size() == 2 &&
+		records[impostorIndices[0]].pos.z > records[impostorIndices[1]].pos.z,
+		"transparent impostors are drawn back to front");
+
+	// 同じ状態が続く間は切り替えない
+	Check(backend.GetStateChangeCount() == kExpectedStateChangeNum,
+		"the backend sees one state change per layer/shader/source group");
+	Check(queue.GetStateChangeCount() == kExpectedStateChangeNum,
+		"RenderQueue reports the same state change count");
+
+	// 半透明は画像が交互になっても奥からの順を崩さない
+	// (Aを100と300、Bを200と400に置き、400 / 300 / 200 / 100の順になる)
+	{
+		RenderSnapshot transparentSnapshot;
+		transparentSnapshot.AddImpostor(kImpostorGraphA, Position3(0.0f, 0.0f, 100.0f), 1.0f, 1.0f, MakeBounds(100.0f));
+		transparentSnapshot.AddImpostor(kImpostorGraphB, Position3(0.0f, 0.0f, 200.0f), 1.0f, 1.0f, MakeBounds(200.0f));
+		transparentSnapshot.AddImpostor(kImpostorGraphA, Position3(0.0f, 0.0f, 300.0f), 1.0f, 1.0f, MakeBounds(300.0f));
+		transparentSnapshot.AddImpostor(kImpostorGraphB, Position3(0.0f, 0.0f, 400.0f), 1.0f, 1.0f, MakeBounds(400.0f));
+
+		RenderQueue transparentQueue;
+		transparentQueue.SubmitModels(transparentSnapshot, Position3(0.0f, 0.0f, 0.0f));
+		RecordingRenderBackend transparentBackend;
+		transparentQueue.Sort();
+		transparentQueue.Execute(transparentBackend);
+
+		std::vector<float> depthOrder;
+		for (const auto& record : transparentBackend.GetRecords()) {
+			depthOrder.emplace_back(record.pos.z);
+		}
+		const std::vector<float> expectedDepthOrder = { 400.0f, 300.0f, 200.0f, 100.0f };
+		Check(depthOrder == expectedDepthOrder,
+			"interleaved transparent materials are drawn strictly back to front");
+		// 画像が変わるたびに状態が切り替わる(奥行きは状態に含めない)
+		Check(transparentBackend.GetStateChangeCount() == 4,
+			"the transparent state key ignores depth but keeps the material");
+	}
+}
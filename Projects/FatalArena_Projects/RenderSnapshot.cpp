@@ -0,0 +1,119 @@
+﻿#include "RenderSnapshot.h"
+
+namespace {
+	/// <summary>
+	/// 境界球を追加する
+	/// </summary>
+	void AddBounds(RenderSnapshot& snapshot, const BoundingSphere& bounds)
+	{
+		snapshot.boundsX.emplace_back(bounds.center.x);
+		snapshot.boundsY.emplace_back(bounds.center.y);
+		snapshot.boundsZ.emplace_back(bounds.center.z);
+		snapshot.boundsRadius.emplace_back(bounds.radius);
+	}
+}
+
+void RenderSnapshot::Clear()
+{
+	models.clear();
+	boundsX.clear();
+	boundsY.clear();
+	boundsZ.clear();
+	boundsRadius.clear();
+	isVisible.clear();
+	culledCount = 0;
+}
+
+void RenderSnapshot::AddModel(int modelHandle, const BoundingSphere& bounds, int sourceHandle)
+{
+	ModelInstance instance;
+	instance.modelHandle = modelHandle;
+	instance.isSetPosition = false;
+	instance.sourceHandle = sourceHandle;
+	models.emplace_back(instance);
+	AddBounds(*this, bounds);
+}
+
+void RenderSnapshot::AddModel(int modelHandle, const Position3& pos, const BoundingSphere& bounds,
+	int sourceHandle)
+{
+	ModelInstance instance;
+	instance.modelHandle = modelHandle;
+	instance.isSetPosition = true;
+	instance.pos = pos;
+	instance.sourceHandle = sourceHandle;
+	models.emplace_back(instance);
+	AddBounds(*this, bounds);
+}
+
+void RenderSnapshot::AddImpostor(int graphHandle, const Position3& pos, float width, float height,
+	const BoundingSphere& bounds)
+{
+	ModelInstance instance;
+	instance.isSetPosition = false;
+	instance.pos = pos;
+	instance.impostorGraph = graphHandle;
+	instance.impostorWidth = width;
+	instance.impostorHeight = height;
+	models.emplace_back(instance);
+	AddBounds(*this, bounds);
+}
+
+void RenderSnapshot::Cull(const ViewFrustum& frustum)
+{
+	const int modelNum = static_cast<int>(models.size());
+	isVisible.resize(modelNum);
+	const int visibleNum = frustum.CullSpheres(
+		boundsX.data(), boundsY.data(), boundsZ.data(), boundsRadius.data(),
+		modelNum, isVisible.data());
+	culledCount = modelNum - visibleNum;
+}
+
+RenderSnapshotBuffer::RenderSnapshotBuffer() :
+	_buffers(),
+	_writeIndex(0),
+	_readIndex(1),
+	_middleIndex(2)
+{
+}
+
+RenderSnapshotBuffer::~RenderSnapshotBuffer()
+{
+}
+
+RenderSnapshot& RenderSnapshotBuffer::BeginWrite()
+{
+	// 書き込み側専用のバッファは読み込み側から参照されない
+	RenderSnapshot& snapshot = _buffers[_writeIndex];
+	snapshot.Clear();
+	return snapshot;
+}
+
+void RenderSnapshotBuffer::Publish()
+{
+	// 書き終えたものを受け渡し用と交換し、受け取ったものに次を書き込む
+	// (読み込み側が取得していなかった古い公開は上書きされる)
+	const uint8_t prev = _middleIndex.exchange(
+		static_cast<uint8_t>(_writeIndex) | kFreshBit, std::memory_order_acq_rel);
+	_writeIndex = prev & kIndexMask;
+}
+
+void RenderSnapshotBuffer::AcquireRead()
+{
+	// 新しい公開がなければ今のものを使い続ける
+	if ((_middleIndex.load(std::memory_order_acquire) & kFreshBit) == 0) return;
+
+	const uint8_t prev = _middleIndex.exchange(
+		static_cast<uint8_t>(_readIndex), std::memory_order_acq_rel);
+	_readIndex = prev & kIndexMask;
+}
+
+const RenderSnapshot& RenderSnapshotBuffer::GetRead() const
+{
+	return _buffers[_readIndex];
+}
+
+void RenderSnapshotBuffer::CullRead(const ViewFrustum& frustum)
+{
+	_buffers[_readIndex].Cull(frustum);
+}
@@ -0,0 +1,125 @@
+﻿#pragma once
+#include "Vector3.h"
+#include "ViewFrustum.h"
+#include <vector>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/// <summary>
+/// 1フレーム分の、敵とアイテムの描画対象の一覧
+/// 更新処理の最後に作成され、描画処理はどのモデルをどこに描くかをこれから決める
+/// 持つのはモデルのハンドル、位置、境界球のみで、姿勢やアニメーション、UIの値は含まない
+/// (それらは描画時にモデルやオブジェクトから直接読むため、更新と描画は同じスレッドで順に行う)
+/// </summary>
+struct RenderSnapshot
+{
+	// 描画するモデル1つ分の情報
+	struct ModelInstance
+	{
+		int modelHandle = -1;
+		bool isSetPosition = false;	// 描画前に位置を設定するか
+		Position3 pos;				// 設定する位置
+		int sourceHandle = -1;		// 複製元のモデル(同じものを続けて描画する。-1なら自身)
+		// ビルボードで描画する場合(モデルの代わりに画像を使う)
+		int impostorGraph = -1;		// 画像(-1ならモデルを描画する)
+		float impostorWidth = 0.0f;
+		float impostorHeight = 0.0f;
+	};
+
+	std::vector<ModelInstance> models;
+
+	// modelsと同じ並びの境界球
+	// (まとめて判定できるよう要素ごとに分けて持つ)
+	std::vector<float> boundsX;
+	std::vector<float> boundsY;
+	std::vector<float> boundsZ;
+	std::vector<float> boundsRadius;
+
+	// modelsと同じ並びの視界内かどうか(Cullを呼ぶまでは空で、全て描画する)
+	std::vector<uint8_t> isVisible;
+	// 直近のCullで視界外とされた数
+	int culledCount = 0;
+
+	/// <summary>
+	/// 内容を空にする(確保済みの領域は使い回す)
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// モデルを追加する(位置はモデルに設定済み)
+	/// </summary>
+	void AddModel(int modelHandle, const BoundingSphere& bounds, int sourceHandle = -1);
+	/// <summary>
+	/// モデルを追加する(描画前に位置を設定する)
+	/// </summary>
+	void AddModel(int modelHandle, const Position3& pos, const BoundingSphere& bounds,
+		int sourceHandle = -1);
+	/// <summary>
+	/// モデルの代わりにカメラへ向けた画像を追加する
+	/// </summary>
+	/// <param name="pos">画像の下端の中心</param>
+	void AddImpostor(int graphHandle, const Position3& pos, float width, float height,
+		const BoundingSphere& bounds);
+
+	/// <summary>
+	/// 各モデルが視界内にあるかを判定する
+	/// </summary>
+	void Cull(const ViewFrustum& frustum);
+};
+
+/// <summary>
+/// RenderSnapshotの三重バッファ
+/// 書き込み側と読み込み側がそれぞれ専用のバッファを持ち、残りの1つを受け渡しに使う
+/// 受け渡しは番号の交換だけで行うため、書き込み側が別スレッドでも
+/// 読み込み中のバッファが書き換えられることはない
+/// (ただし今は更新と描画を同じスレッドで行っており、別スレッドからの書き込みは確認でのみ行う)
+/// (BeginWrite/Publishは書き込み側、AcquireRead/GetRead/CullReadは読み込み側の1スレッドずつから呼ぶ)
+/// </summary>
+class RenderSnapshotBuffer final
+{
+public:
+	RenderSnapshotBuffer();
+	~RenderSnapshotBuffer();
+
+	/// <summary>
+	/// 書き込み用のバッファを空にして返す
+	/// </summary>
+	RenderSnapshot& BeginWrite();
+
+	/// <summary>
+	/// 書き込みを完了し、読み込み側に公開する
+	/// </summary>
+	void Publish();
+
+	/// <summary>
+	/// 前回から新しく公開されたものがあれば、それを読み込み用に取得する
+	/// (描画の最初に1回呼び、そのフレームの間は同じものを参照する)
+	/// </summary>
+	void AcquireRead();
+
+	/// <summary>
+	/// 読み込み用に取得したものを返す
+	/// </summary>
+	const RenderSnapshot& GetRead() const;
+
+	/// <summary>
+	/// 読み込み用に取得したものの視界内判定を行う
+	/// (カメラは公開後も動くため、描画の直前に呼ぶ)
+	/// </summary>
+	void CullRead(const ViewFrustum& frustum);
+
+private:
+	static constexpr int kBufferNum = 3;
+	// 受け渡し用の番号に付ける、未取得の公開があることを示すビット
+	static constexpr uint8_t kFreshBit = 0x80;
+	static constexpr uint8_t kIndexMask = 0x7f;
+
+	std::array<RenderSnapshot, kBufferNum> _buffers;
+	// 書き込み側だけが触る番号
+	int _writeIndex;
+	// 読み込み側だけが触る番号
+	int _readIndex;
+	// 受け渡し用のバッファの番号(両側から交換する)
+	std::atomic<uint8_t> _middleIndex;
+};
@@ -0,0 +1,105 @@
+﻿#include "SelfTest.h"
+#include "RenderSnapshot.h"
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+namespace {
+	// 別スレッドから公開するフレーム数
+	constexpr int kPublishFrameNum = 20000;
+	// 1フレームに追加するモデルの最大数
+	constexpr int kMaxModelNum = 64;
+
+	/// <summary>
+	/// フレーム番号から、そのフレームに追加するモデルの数を決める
+	/// </summary>
+	int ToModelNum(int frame)
+	{
+		return frame % kMaxModelNum + 1;
+	}
+
+	/// <summary>
+	/// 全てのモデルにフレーム番号を書き込んで公開する
+	/// </summary>
+	void PublishFrame(RenderSnapshotBuffer& buffer, int frame)
+	{
+		RenderSnapshot& snapshot = buffer.BeginWrite();
+		const int modelNum = ToModelNum(frame);
+		for (int i = 0; i < modelNum; ++i) {
+			snapshot.AddModel(frame, BoundingSphere());
+		}
+		buffer.Publish();
+	}
+
+	/// <summary>
+	/// 1フレーム分の内容がそろっているか
+	/// (書き込み途中のものを読むと、数や番号が混ざる)
+	/// </summary>
+	/// <returns>フレーム番号(そろっていなければ-1、空なら-2)</returns>
+	int ReadFrame(const RenderSnapshot& snapshot)
+	{
+		if (snapshot.models.empty()) return -2;
+		const int frame = snapshot.models.front().modelHandle;
+		if (static_cast<int>(snapshot.models.size()) != ToModelNum(frame)) return -1;
+		if (snapshot.boundsX.size() != snapshot.models.size()) return -1;
+		for (const auto& model : snapshot.models) {
+			if (model.modelHandle != frame) return -1;
+		}
+		return frame;
+	}
+}
+
+void SelfTest::RunRenderSnapshotTests()
+{
+	PrintHeader("RenderSnapshotBuffer");
+
+	// 取得するまでは前のものを読み、取得すると最後に公開されたものを読む
+	{
+		RenderSnapshotBuffer buffer;
+		PublishFrame(buffer, 1);
+		buffer.AcquireRead();
+		PublishFrame(buffer, 2);
+		PublishFrame(buffer, 3);
+		Check(ReadFrame(buffer.GetRead()) == 1, "GetRead keeps the acquired frame until the next AcquireRead");
+		buffer.AcquireRead();
+		Check(ReadFrame(buffer.GetRead()) == 3, "AcquireRead takes the latest published frame");
+		buffer.AcquireRead();
+		Check(ReadFrame(buffer.GetRead()) == 3, "AcquireRead without a new publish keeps the current frame");
+	}
+
+	// 別スレッドで書き込んでいる間も、読み込み中の内容は書き換わらない
+	{
+		RenderSnapshotBuffer buffer;
+		std::atomic<bool> isFinished = false;
+		std::thread producer([&buffer, &isFinished]() {
+			for (int frame = 0; frame < kPublishFrameNum; ++frame) {
+				PublishFrame(buffer, frame);
+			}
+			isFinished.store(true);
+			});
+
+		int tornCount = 0;
+		int backwardCount = 0;
+		int readCount = 0;
+		int lastFrame = -1;
+		while (!isFinished.load()) {
+			buffer.AcquireRead();
+			const int frame = ReadFrame(buffer.GetRead());
+			if (frame == -2) continue;
+			++readCount;
+			if (frame == -1) {
+				++tornCount;
+				continue;
+			}
+			if (frame < lastFrame) ++backwardCount;
+			lastFrame = frame;
+		}
+		producer.join();
+		buffer.AcquireRead();
+
+		Check(tornCount == 0, "a snapshot being read is never overwritten by the producer thread");
+		Check(backwardCount == 0, "acquired frames never go backwards");
+		Check(ReadFrame(buffer.GetRead()) == kPublishFrameNum - 1, "the last published frame is acquired after the producer ends");
+		printf("  %d reads during %d publishes\n", readCount, kPublishFrameNum);
+	}
+}
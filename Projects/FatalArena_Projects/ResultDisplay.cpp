@@ -3,6 +3,7 @@
 #include "GameManager.h"
 #include "ResultItemDrawer.h"
 #include "Input.h"
+#include "FontManager.h"
 #include <DxLib.h>
 #include <cassert>
 #include <string>
@@ -53,6 +54,13 @@ namespace {
 
 ResultDisplay::ResultDisplay() :
     _resultFontHandle(-1),
+    _nextSceneFontHandle(-1),
+    _resultAtlas(nullptr),
+    _nextSceneAtlas(nullptr),
+    _resultLayout(),
+    _padNextSceneLayout(),
+    _keybdNextSceneLayout(),
+    _batcher(),
     _animationState(SlideAnimationState::SlidingIn),
     _animationTimer(0),
     _labelDrawX(kLabelStartDrawX),
@@ -62,22 +70,29 @@ ResultDisplay::ResultDisplay() :
     _isNextSceneTextActive(false),
     _backgroundHandle(-1)
 {
-    _resultFontHandle = CreateFontToHandle(kFontName.c_str(), kResultFontSize, kFontThickness,
+    _resultFontHandle = FontManager::GetInstance().Acquire(kFontName, kResultFontSize, kFontThickness,
         DX_FONTTYPE_ANTIALIASING_EDGE);
     assert(_resultFontHandle >= 0 && "フォントの作成に失敗");
 
-    _nextSceneFontHandle = CreateFontToHandle(kFontName.c_str(), kNextSceneFontSize, kFontThickness,
+    _nextSceneFontHandle = FontManager::GetInstance().Acquire(kFontName, kNextSceneFontSize, kFontThickness,
         DX_FONTTYPE_ANTIALIASING_EDGE);
     assert(_nextSceneFontHandle >= 0 && "フォントの作成に失敗");
+
+    // 文字をまとめたアトラスを取得し、変わらない文字列は先に配置を計算しておく
+    _resultAtlas = &FontManager::GetInstance().GetAtlas(_resultFontHandle);
+    _nextSceneAtlas = &FontManager::GetInstance().GetAtlas(_nextSceneFontHandle);
+    _resultLayout = _resultAtlas->BuildLayout(kResultText);
+    _padNextSceneLayout = _nextSceneAtlas->BuildLayout(kPadNextSceneText);
+    _keybdNextSceneLayout = _nextSceneAtlas->BuildLayout(kKeybdNextSceneText);
 }
 
 ResultDisplay::~ResultDisplay()
 {
     if (_resultFontHandle != -1) {
-        DeleteFontToHandle(_resultFontHandle);
+        FontManager::GetInstance().Release(_resultFontHandle);
     }
     if (_nextSceneFontHandle != -1) {
-        DeleteFontToHandle(_nextSceneFontHandle);
+        FontManager::GetInstance().Release(_nextSceneFontHandle);
     }
 }
 
@@ -177,42 +192,33 @@ void ResultDisplay::Draw()
     // BlendModeを使った後はNOBLENDにしておくことを忘れず
     SetDrawBlendMode(DX_BLENDMODE_NOBLEND, 0);
 
+    // 文字はためておき、最後にまとめて描画する
     // "RESULT" の描画
-    int resultTextWidth = GetDrawStringWidthToHandle(
-        kResultText.c_str(), 
-        static_cast<int>(kResultText.length()),
-        _resultFontHandle);
-    int resultDrawX = static_cast<int>((Statistics::kScreenWidth - resultTextWidth) * 0.5f);
-    DrawStringToHandle(
-        resultDrawX, kResultTextY, 
-        kResultText.c_str(), kTextColor,
-        _resultFontHandle);
+    int resultDrawX = static_cast<int>((Statistics::kScreenWidth - _resultLayout.width) * 0.5f);
+    _resultAtlas->DrawLayout(_batcher, _resultLayout,
+        static_cast<float>(resultDrawX), static_cast<float>(kResultTextY), kTextColor);
 
     // 各項目の描画
     for (int i = 0; i < _resultItems.size(); ++i) {
         float drawY = static_cast<float>(kItemStartY + (kItemOffsetY * i));
-        _resultItems[i]->Draw(_labelDrawX, _valueDrawX, drawY);
+        _resultItems[i]->Draw(_batcher, _labelDrawX, _valueDrawX, drawY);
     }
 
-    // 消滅中は描画を行わない
-    if (!_isNextSceneTextActive) return;
+    // 消滅中は案内を描画しない
+    if (_isNextSceneTextActive) {
+        // 最後の入力に応じて文字を変える
+        const TextLayout* drawLayout = &_padNextSceneLayout;
+        if (Input::GetInstance().GetLastInputType() == Input::PeripheralType::keybd) {
+            drawLayout = &_keybdNextSceneLayout;
+        }
 
-    // 最後の入力に応じて文字を変える
-    std::wstring drawString = kPadNextSceneText;
-    if (Input::GetInstance().GetLastInputType() == Input::PeripheralType::keybd) {
-        drawString = kKeybdNextSceneText;
+        // 同様に描画する
+        int NextSceneDrawX = static_cast<int>((Statistics::kScreenWidth - drawLayout->width) * 0.5f);
+        _nextSceneAtlas->DrawLayout(_batcher, *drawLayout,
+            static_cast<float>(NextSceneDrawX), static_cast<float>(kNextSceneTextY), kTextColor);
     }
 
-    // 同様に描画する
-    int nextSceneTextWidth = GetDrawStringWidthToHandle(
-        drawString.c_str(),
-        static_cast<int>(drawString.length()),
-        _nextSceneFontHandle);
-    int NextSceneDrawX = static_cast<int>((Statistics::kScreenWidth - nextSceneTextWidth) * 0.5f);
-    DrawStringToHandle(
-        NextSceneDrawX, kNextSceneTextY,
-        drawString.c_str(), kTextColor,
-        _nextSceneFontHandle);
+    _batcher.Flush();
 }
 
 void ResultDisplay::UpdateSlidingIn()
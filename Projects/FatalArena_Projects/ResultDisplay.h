@@ -1,4 +1,6 @@
 ﻿#pragma once
+#include "GlyphAtlas.h"
+#include "UIBatcher.h"
 #include <vector>
 #include <memory>
 
@@ -54,6 +56,14 @@ private:
 
 	int _resultFontHandle;
 	int _nextSceneFontHandle;
+	// 文字をまとめた画像と、内容が変わらない文字列の配置
+	const GlyphAtlas* _resultAtlas;
+	const GlyphAtlas* _nextSceneAtlas;
+	TextLayout _resultLayout;
+	TextLayout _padNextSceneLayout;
+	TextLayout _keybdNextSceneLayout;
+	// 文字をまとめて描画する
+	UIBatcher _batcher;
 
 	SlideAnimationState _animationState;	// 現在のアニメーション状態
 	int _animationTimer;            // アニメーション進行度タイマー
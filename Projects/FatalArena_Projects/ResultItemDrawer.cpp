@@ -1,5 +1,8 @@
 ﻿#include "ResultItemDrawer.h"
 #include "Statistics.h"
+#include "Random.h"
+#include "UIBatcher.h"
+#include "FontManager.h"
 #include <DxLib.h>
 #include <cassert>
 
@@ -11,7 +14,9 @@ namespace {
     constexpr int kFontThickness = 3;
     constexpr int kScoreDigitCount = 7;      // 表示桁数
     constexpr int kTimeDigitCount = 6;       // 表示桁数
-    const std::wstring kScoreFormat = L"%07d";      // 0埋め部分
+    constexpr int kTimePartDigitCount = 2;   // 分、秒、ミリ秒それぞれの表示桁数
+    const std::wstring kMinuteSeparator = L":";
+    const std::wstring kSecondSeparator = L".";
     constexpr int kDigitFinalizeDuration = 20;
 }
 
@@ -21,17 +26,28 @@ ResultItemDrawer::ResultItemDrawer(ValueType type, const std::wstring& label, fl
     _finalValue(value),
     _displayValue(0.0f),
     _fontHandle(-1),
+    _atlas(nullptr),
+    _labelLayout(),
+    _minuteSeparatorLayout(),
+    _secondSeparatorLayout(),
     _isAnimationFinished(false)
 {
-    _fontHandle = CreateFontToHandle(kFontName.c_str(), kFontSize, kFontThickness,
+    // 全ての項目で同じフォントとアトラスを共有する
+    _fontHandle = FontManager::GetInstance().Acquire(kFontName, kFontSize, kFontThickness,
         DX_FONTTYPE_ANTIALIASING_EDGE);
     assert(_fontHandle >= 0 && "フォントの作成に失敗");
+
+    // 文字をまとめたアトラスを取得し、変わらない部分は先に計算しておく
+    _atlas = &FontManager::GetInstance().GetAtlas(_fontHandle);
+    _labelLayout = _atlas->BuildLayout(_label);
+    _minuteSeparatorLayout = _atlas->BuildLayout(kMinuteSeparator);
+    _secondSeparatorLayout = _atlas->BuildLayout(kSecondSeparator);
 }
 
 ResultItemDrawer::~ResultItemDrawer()
 {
     if (_fontHandle != -1) {
-        DeleteFontToHandle(_fontHandle);
+        FontManager::GetInstance().Release(_fontHandle);
     }
 }
 
@@ -51,19 +67,18 @@ void ResultItemDrawer::Update(int animationTimer)
     }
 }
 
-void ResultItemDrawer::Draw(float labelX, float valueX, float baseY) const
+void ResultItemDrawer::Draw(UIBatcher& batcher, float labelX, float valueX, float baseY) const
 {
     // ラベルを描画
-    DrawStringToHandle(static_cast<int>(labelX), static_cast<int>(baseY), _label.c_str(),
-        kTextColor, _fontHandle);
+    _atlas->DrawLayout(batcher, _labelLayout, labelX, baseY, kTextColor);
 
     // 型に応じて描画処理を分岐
     switch (_type) {
     case ValueType::Number:
-        DrawNumber(valueX, baseY);
+        DrawNumber(batcher, valueX, baseY);
         break;
     case ValueType::Time:
-        DrawTime(valueX, baseY);
+        DrawTime(batcher, valueX, baseY);
         break;
     }
 }
@@ -94,7 +109,7 @@ void ResultItemDrawer::UpdateNumberAnimation(int animationTimer)
         }
         // 確定していない桁（上位の桁）はランダムな数字
         else {
-            digit = GetRand(9); // 0-9
+            digit = RandomService::GetInstance().GetStream(RandomStreamType::UI).GetInt(9); // 0-9
         }
         // 計算結果を加算
         tempValue += digit * powerOf10;
@@ -139,7 +154,7 @@ void ResultItemDrawer::UpdateTimeAnimation(int animationTimer)
             }
             // 確定していない桁（上位の桁）はランダムな数字
             else {
-                digit = GetRand(9); // 0-9
+                digit = RandomService::GetInstance().GetStream(RandomStreamType::UI).GetInt(9); // 0-9
             }
 
             // 計算した桁の値を tempTimeInt に加算
@@ -153,24 +168,23 @@ void ResultItemDrawer::UpdateTimeAnimation(int animationTimer)
     }
 }
 
-void ResultItemDrawer::DrawNumber(float valueX, float baseY) const
+void ResultItemDrawer::DrawNumber(UIBatcher& batcher, float valueX, float baseY) const
 {
-    // 表示用の数値を、5桁・ゼロ埋めのワイド文字列に変換する
-    wchar_t buffer[16]; // "00000" と終端文字が入るのに十分なサイズを確保
-    swprintf_s(buffer, kScoreFormat.c_str(), static_cast<int>(_displayValue));
-
-    // 生成した文字列の描画幅（ピクセル数）を取得する
-    int numWidth = GetDrawStringWidthToHandle(buffer, (int)wcslen(buffer), _fontHandle);
+    // 表示用の数値を、0埋めした桁の描画幅（ピクセル数）を取得する
+    // (文字列には変換せず、数字の切り抜きを並べる)
+    const int value = static_cast<int>(_displayValue);
+    int numWidth = _atlas->MeasureNumber(value, kScoreDigitCount);
 
     // 右揃えで描画するためのX座標を計算する
     // (基準のX座標 - 文字列の幅)
     int drawX = static_cast<int>(valueX) - numWidth;
 
-    // 計算した座標に文字列を描画する
-    DrawStringToHandle(drawX, static_cast<int>(baseY), buffer, kTextColor, _fontHandle);
+    // 計算した座標に数字を描画する
+    _atlas->DrawNumber(batcher, value, kScoreDigitCount,
+        static_cast<float>(drawX), baseY, kTextColor);
 }
 
-void ResultItemDrawer::DrawTime(float valueX, float baseY) const
+void ResultItemDrawer::DrawTime(UIBatcher& batcher, float valueX, float baseY) const
 {
     // 表示用の秒数を、分・秒・ミリ秒に分解する
     const int displayTimeInt = static_cast<int>(_displayValue);
@@ -178,33 +192,24 @@ void ResultItemDrawer::DrawTime(float valueX, float baseY) const
     int seconds = (displayTimeInt / 100) % 100;
     int milliseconds = displayTimeInt % 100;
 
-    // 各パーツ（分、秒、ミリ秒）を個別の文字列に変換する
-    wchar_t buffer[4]; // "00:" など最大4文字が入るサイズ
-    swprintf_s(buffer, L"%02d:", minutes);
-    std::wstring minStr = buffer;
-    swprintf_s(buffer, L"%02d.", seconds);
-    std::wstring secStr = buffer;
-    swprintf_s(buffer, L"%02d", milliseconds);
-    std::wstring msStr = buffer;
-
-    // 各パーツの描画幅を取得する
-    int minWidth = GetDrawStringWidthToHandle(minStr.c_str(), (int)minStr.length(), _fontHandle);
-    int secWidth = GetDrawStringWidthToHandle(secStr.c_str(), (int)secStr.length(), _fontHandle);
-    int msWidth = GetDrawStringWidthToHandle(msStr.c_str(), (int)msStr.length(), _fontHandle);
+    // 各パーツ（分、秒、ミリ秒）の描画幅を取得する
+    // (区切り文字の幅は初期化時に計算済み)
+    int minWidth = _atlas->MeasureNumber(minutes, kTimePartDigitCount) + _minuteSeparatorLayout.width;
+    int secWidth = _atlas->MeasureNumber(seconds, kTimePartDigitCount) + _secondSeparatorLayout.width;
+    int msWidth = _atlas->MeasureNumber(milliseconds, kTimePartDigitCount);
 
     // 全体の幅を計算し、右揃えにするための描画開始X座標を求める
     int totalWidth = minWidth + secWidth + msWidth;
-    int currentX = static_cast<int>(valueX) - totalWidth;
+    float currentX = valueX - totalWidth;
 
     // 各パーツを左から順番に描画していく
-    DrawStringToHandle(currentX, static_cast<int>(baseY), minStr.c_str(), kTextColor,
-        _fontHandle);
-    currentX += minWidth; // 次の描画位置を更新
-    DrawStringToHandle(currentX, static_cast<int>(baseY), secStr.c_str(), kTextColor,
-        _fontHandle);
-    currentX += secWidth; // 次の描画位置を更新
-    DrawStringToHandle(currentX, static_cast<int>(baseY), msStr.c_str(), kTextColor,
-        _fontHandle);
+    currentX += _atlas->DrawNumber(batcher, minutes, kTimePartDigitCount, currentX, baseY, kTextColor);
+    _atlas->DrawLayout(batcher, _minuteSeparatorLayout, currentX, baseY, kTextColor);
+    currentX += _minuteSeparatorLayout.width; // 次の描画位置を更新
+    currentX += _atlas->DrawNumber(batcher, seconds, kTimePartDigitCount, currentX, baseY, kTextColor);
+    _atlas->DrawLayout(batcher, _secondSeparatorLayout, currentX, baseY, kTextColor);
+    currentX += _secondSeparatorLayout.width; // 次の描画位置を更新
+    _atlas->DrawNumber(batcher, milliseconds, kTimePartDigitCount, currentX, baseY, kTextColor);
 }
 
 int ResultItemDrawer::ConvertTimeToDisplayInt(float timeInSeconds) const
@@ -1,6 +1,9 @@
 ﻿#pragma once
+#include "GlyphAtlas.h"
 #include <string>
 
+class UIBatcher;
+
 class ResultItemDrawer
 {
 public:
@@ -14,7 +17,10 @@ public:
 	~ResultItemDrawer();
 
 	void Update(int animationTimer);
-	void Draw(float labelX, float valueX, float baseY) const;
+	/// <summary>
+	/// 描画する文字をまとめて描画用に追加する
+	/// </summary>
+	void Draw(UIBatcher& batcher, float labelX, float valueX, float baseY) const;
 
 	bool IsAnimationFinished() const { return _isAnimationFinished; }
 
@@ -24,8 +30,8 @@ private:
 	void UpdateTimeAnimation(int animationTimer);
 
 	// 描画処理
-	void DrawNumber(float valueX, float baseY) const;
-	void DrawTime(float valueX, float baseY) const;
+	void DrawNumber(UIBatcher& batcher, float valueX, float baseY) const;
+	void DrawTime(UIBatcher& batcher, float valueX, float baseY) const;
 
 	/// <summary>
 	/// float型の秒数を MMSSss 形式の整数に変換する
@@ -43,5 +49,9 @@ private:
 	float _displayValue;    // アニメーション中の表示用値
 
 	int _fontHandle;
+	const GlyphAtlas* _atlas;       // フォントの文字をまとめた画像
+	TextLayout _labelLayout;        // 表示文字の配置
+	TextLayout _minuteSeparatorLayout;  // 分と秒の間の":"の配置
+	TextLayout _secondSeparatorLayout;  // 秒とミリ秒の間の"."の配置
 	bool _isAnimationFinished;
 };
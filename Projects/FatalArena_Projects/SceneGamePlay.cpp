@@ -17,9 +17,13 @@
 #include "EnemyFactory.h"
 #include "ItemFactory.h"
 #include "BillboardManager.h"
+#include "ModelRenderer.h"
 #include "StatusUI.h"
 #include "GameManager.h"
 #include "SoundManager.h"
+#include "AllocationCounter.h"
+#include "Random.h"
+#include "PlayerReinforcementManager.h"
 
 #include "Statistics.h"
 #include "Input.h"
@@ -45,8 +49,16 @@ SceneGamePlay::SceneGamePlay() :
 	_playerBuffManager(std::make_shared<PlayerBuffManager>()),
 	_waveAnnouncer(std::make_shared<WaveAnnouncer>()),
 	_popupManager(std::make_shared<PopupManager>()),
+	_reinforcementPopup(),
 	_billboardManager(std::make_shared<BillboardManager>()),
 	_statusUI(std::make_unique<StatusUI>()),
+	_renderSnapshot(),
+	_modelRenderer(std::make_unique<ModelRenderer>()),
+	_renderQueue(),
+	_viewFrustum(),
+	_waveStartSnapshot(),
+	_snapshotWaveIndex(-1),
+	_steadyAllocationCount(0),
 	_nowUpdateState(&SceneGamePlay::FadeinUpdate),
 	_nowDrawState(&SceneGamePlay::FadeinDraw),
 	_nowGameDrawState(&SceneGamePlay::StartingGameDraw)
@@ -63,6 +75,9 @@ SceneGamePlay::~SceneGamePlay()
 
 void SceneGamePlay::Init()
 {
+	// 同じシード値であれば同じ試合になるよう乱数の系列を初期化する
+	RandomService::GetInstance().ResetStreams();
+
 	// 敵のモデルを読み込む
 	EnemyFactory::LoadResources();
 	// アイテムのモデルを読み込む
@@ -74,12 +89,14 @@ void SceneGamePlay::Init()
 	_skydome->Init(_camera);
 	_arena->Init(_physics);
 
-	_enemyManager->Init(_player, _physics);
+	_enemyManager->Init(_player, _physics, _camera);
 	_playerBuffManager->Init(_player);
 	_itemManager->Init(_physics, _playerBuffManager);
 	_waveManager->Init(_enemyManager, _itemManager, _waveAnnouncer);
 	_billboardManager->Init();
 	_statusUI->Init(_player, _waveManager, _enemyManager);
+	// 強化選択を開いたフレームで読み込みが発生しないよう、先に生成しておく
+	_reinforcementPopup = std::make_shared<PopupPlayerReinforcement>();
 
 	GameManager::GetInstance().Init(_player, _waveManager);
 
@@ -97,9 +114,8 @@ void SceneGamePlay::Update()
 			// ゲームの進行を一時的に止める
 			_isProgress = false;
 			// ポップアップを開始する
-			std::shared_ptr<PopupPlayerReinforcement> popup =
-				std::make_shared<PopupPlayerReinforcement>();
-			_popupManager->StartPopup(popup);
+			// (生成済みのものを使い回し、状態の初期化のみ行う)
+			_popupManager->StartPopup(_reinforcementPopup);
 		}
 		// ゲームが進行中でないなら
 		else {
@@ -143,6 +159,16 @@ void SceneGamePlay::Draw()
 	}
 }
 
+void SceneGamePlay::RetryCurrentWave()
+{
+	// まだ保存していなければ戻せない
+	if (_snapshotWaveIndex < 0) return;
+
+	SnapshotReader reader(_waveStartSnapshot.GetData());
+	LoadMatchSnapshot(reader);
+	assert(reader.IsValid() && "試合の状態を読み込めなかった");
+}
+
 void SceneGamePlay::FadeinUpdate()
 {
 	_frame--;
@@ -289,6 +315,20 @@ void SceneGamePlay::NormalDraw()
 
 #ifdef _DEBUG
 	//DrawFormatString(0, 0, 0xffffff, L"Scene GamePlay");
+	// ウェーブ進行中に確保が発生していたら知らせる
+	if (_steadyAllocationCount > 0) {
+		DrawFormatString(0, 0, 0xff0000, L"Alloc/Frame : %llu", _steadyAllocationCount);
+	}
+	// 視界外として描画しなかった数
+	DrawFormatString(0, 16, 0xffffff, L"Culled : %d (Billboard : %d)",
+		_renderSnapshot.GetRead().culledCount, _billboardManager->GetCulledCount());
+	// 敵とアイテムの描画呼び出し回数
+	DrawFormatString(0, 32, 0xffffff, L"DrawCall : %d (Model : %d, Impostor : %d)",
+		_modelRenderer->GetDrawCallCount(), _modelRenderer->GetInstanceCount(),
+		_modelRenderer->GetImpostorCount());
+	// 描画キューの命令数と状態の切り替え回数
+	DrawFormatString(0, 48, 0xffffff, L"RenderQueue : %d (StateChange : %d)",
+		_renderQueue.GetCommandCount(), _renderQueue.GetStateChangeCount());
 #endif
 }
 
@@ -305,6 +345,24 @@ void SceneGamePlay::InProgressUpdate()
 {
 	// ゲーム中の更新を行う
 
+#ifdef _DEBUG
+	// 現在のウェーブをやり直す
+	if (Input::GetInstance().IsTrigger("Debug::RetryWave")) {
+		RetryCurrentWave();
+	}
+#endif // _DEBUG
+
+	// ウェーブが切り替わったら開始時点の状態を保存する
+	if (_waveManager->GetCurrentWaveIndex() != _snapshotWaveIndex) {
+		_waveStartSnapshot.Clear();
+		SaveMatchSnapshot(_waveStartSnapshot);
+		_snapshotWaveIndex = _waveManager->GetCurrentWaveIndex();
+	}
+
+	// ウェーブ進行中(生成や演出の切り替えがない状態)の確保回数を数える
+	const bool isSteadyState = _waveManager->IsWaveInProgress();
+	const uint64_t allocationCount = AllocationCounter::GetCount();
+
 	// クリアタイムの加算
 	GameManager::GetInstance().UpdateClearTime();
 
@@ -323,6 +381,55 @@ void SceneGamePlay::InProgressUpdate()
 
 	// 物理演算更新
 	_physics->Update();
+	// 物理演算中の被弾で記録された副作用を実行する
+	_enemyManager->FlushCommands();
+
+	// 確定した位置で描画用のスナップショットを作る
+	CaptureSnapshot();
+
+	// 更新の途中でウェーブが切り替わった場合は対象外
+	if (isSteadyState && _waveManager->IsWaveInProgress()) {
+		_steadyAllocationCount = AllocationCounter::GetCount() - allocationCount;
+		AllocationCounter::RecordSteadyFrame(_steadyAllocationCount);
+	}
+}
+
+void SceneGamePlay::CaptureSnapshot()
+{
+	RenderSnapshot& snapshot = _renderSnapshot.BeginWrite();
+	_enemyManager->WriteSnapshot(snapshot);
+	_itemManager->WriteSnapshot(snapshot);
+	_renderSnapshot.Publish();
+}
+
+void SceneGamePlay::SaveMatchSnapshot(SnapshotWriter& writer) const
+{
+	_player->SaveSnapshot(writer);
+	_playerBuffManager->SaveSnapshot(writer);
+	writer.Write(PlayerReinforcementManager::GetStatsData());
+	_waveManager->SaveSnapshot(writer);
+	_enemyManager->SaveSnapshot(writer);
+	_itemManager->SaveSnapshot(writer);
+	GameManager::GetInstance().SaveSnapshot(writer);
+	RandomService::GetInstance().SaveSnapshot(writer);
+}
+
+void SceneGamePlay::LoadMatchSnapshot(SnapshotReader& reader)
+{
+	StatsData stats;
+
+	_player->LoadSnapshot(reader);
+	_playerBuffManager->LoadSnapshot(reader);
+	reader.Read(stats);
+	PlayerReinforcementManager::SetStatsData(stats);
+	_waveManager->LoadSnapshot(reader);
+	_enemyManager->LoadSnapshot(reader);
+	_itemManager->LoadSnapshot(reader);
+	GameManager::GetInstance().LoadSnapshot(reader);
+	RandomService::GetInstance().LoadSnapshot(reader);
+
+	// 戻した位置で描画用のスナップショットを作り直す
+	CaptureSnapshot();
 }
 
 void SceneGamePlay::EndingUpdate()
@@ -336,42 +443,63 @@ void SceneGamePlay::EndingUpdate()
 
 void SceneGamePlay::StartingGameDraw()
 {
-	_skydome->Draw();
-	_arena->Draw();
-	_billboardManager->Draw();
-
-	_camera->Draw();
-	_player->Draw();
-
-	_enemyManager->Draw();
-	_itemManager->Draw();
+	// 最新のスナップショットを取得し、視界外のものは描画しない
+	_renderSnapshot.AcquireRead();
+	_camera->BuildViewFrustum(_viewFrustum);
+	_renderSnapshot.CullRead(_viewFrustum);
+
+	_renderQueue.Clear();
+	SubmitWorld();
+	_renderQueue.SubmitCustom(RenderLayer::World, true, [this]() { _billboardManager->Draw(_viewFrustum); });
+	ExecuteRenderQueue();
 }
 
 void SceneGamePlay::EndingGameDraw()
 {
-	_skydome->Draw();
-	_arena->Draw();
-	_billboardManager->Draw();
-
-	_camera->Draw();
-	_player->Draw();
-
-	_enemyManager->Draw();
-	_itemManager->Draw();
+	// 最新のスナップショットを取得し、視界外のものは描画しない
+	_renderSnapshot.AcquireRead();
+	_camera->BuildViewFrustum(_viewFrustum);
+	_renderSnapshot.CullRead(_viewFrustum);
+
+	_renderQueue.Clear();
+	SubmitWorld();
+	_renderQueue.SubmitCustom(RenderLayer::World, true, [this]() { _billboardManager->Draw(_viewFrustum); });
+	ExecuteRenderQueue();
 }
 
 void SceneGamePlay::NormalGameDraw()
 {
-	_skydome->Draw();
-	_arena->Draw();
+	// 最新のスナップショットを取得し、視界外のものは描画しない
+	_renderSnapshot.AcquireRead();
+	_camera->BuildViewFrustum(_viewFrustum);
+	_renderSnapshot.CullRead(_viewFrustum);
+
+	_renderQueue.Clear();
+	SubmitWorld();
+	_renderQueue.SubmitCustom(RenderLayer::UI, false, [this]() { _statusUI->Draw(); });
+	_renderQueue.SubmitCustom(RenderLayer::UI, false, [this]() { _playerBuffManager->Draw(); });
+	_renderQueue.SubmitCustom(RenderLayer::UI, false, [this]() { _waveAnnouncer->Draw(); });
+	ExecuteRenderQueue();
+}
+
+void SceneGamePlay::SubmitWorld()
+{
+	// ライトの更新は全ての描画より先に行う
+	// (同じ層・半透明のCustomは追加した順なので、最初の層の先頭に追加する)
+	_renderQueue.SubmitCustom(RenderLayer::Background, false, [this]() { _camera->Draw(); });
+	_renderQueue.SubmitCustom(RenderLayer::Background, false, [this]() { _skydome->Draw(); });
+	_renderQueue.SubmitCustom(RenderLayer::Background, false, [this]() { _arena->Draw(); });
+
+	_renderQueue.SubmitCustom(RenderLayer::World, false, [this]() { _player->Draw(); });
 
-	_camera->Draw();
-	_player->Draw();
+	// 敵とアイテムはスナップショットから描画する
+	_renderQueue.SubmitModels(_renderSnapshot.GetRead(), _camera->GetPos());
+}
 
-	_enemyManager->Draw();
-	_itemManager->Draw();
-	_statusUI->Draw();
-	_playerBuffManager->Draw();
-	_waveAnnouncer->Draw();
+void SceneGamePlay::ExecuteRenderQueue()
+{
+	// 状態の切り替えが少なくなる順に並べてから描画する
+	_renderQueue.Sort();
+	_renderQueue.Execute(*_modelRenderer);
 }
 
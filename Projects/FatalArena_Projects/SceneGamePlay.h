@@ -1,8 +1,13 @@
 ﻿#pragma once
 #include "SceneBase.h"
 #include "Geometry.h"
+#include "RenderSnapshot.h"
+#include "RenderQueue.h"
+#include "SnapshotArchive.h"
+#include "ViewFrustum.h"
 
 #include <memory>
+#include <cstdint>
 
 class Physics;
 class Camera;
@@ -15,8 +20,10 @@ class ItemManager;
 class PlayerBuffManager;
 class WaveAnnouncer;
 class PopupManager;
+class PopupPlayerReinforcement;
 class BillboardManager;
 class StatusUI;
+class ModelRenderer;
 
 class SceneGamePlay final : public SceneBase {
 public:
@@ -38,6 +45,12 @@ public:
 	/// </summary>
 	void Draw() override;
 
+	/// <summary>
+	/// 現在のウェーブの開始時点に戻す
+	/// (モデルの読み込みなどは行わず、1フレーム以内に終わる)
+	/// </summary>
+	void RetryCurrentWave();
+
 private:
 
 	int _frame;
@@ -112,6 +125,15 @@ private:
 	/// </summary>
 	void NormalGameDraw();
 
+	/// <summary>
+	/// 天球、アリーナ、プレイヤー、敵とアイテムの描画命令を追加する
+	/// </summary>
+	void SubmitWorld();
+	/// <summary>
+	/// 描画命令を並べ替えて実行する
+	/// </summary>
+	void ExecuteRenderQueue();
+
 	// ゲームが現在どのフェーズにあるか
 	Phase _nowPhase;
 	// クリアしたかどうか
@@ -129,8 +151,40 @@ private:
 	std::shared_ptr<PlayerBuffManager> _playerBuffManager;
 	std::shared_ptr<WaveAnnouncer> _waveAnnouncer;
 	std::shared_ptr<PopupManager> _popupManager;
+	// 強化選択のポップアップ(試合中は使い回す)
+	std::shared_ptr<PopupPlayerReinforcement> _reinforcementPopup;
 	std::shared_ptr<BillboardManager> _billboardManager;
 	std::unique_ptr<StatusUI> _statusUI;
 
+	// 描画に使用する、更新結果のスナップショット
+	RenderSnapshotBuffer _renderSnapshot;
+	// スナップショットのモデルを描画し、ビルボードはまとめて描画する
+	std::unique_ptr<ModelRenderer> _modelRenderer;
+	// 描画命令を状態ごとに並べ替えて実行する
+	RenderQueue _renderQueue;
+
+	// 描画するものを絞り込むためのカメラの視錐台(描画のたびに作り直す)
+	ViewFrustum _viewFrustum;
+
+	/// <summary>
+	/// 更新結果から描画用のスナップショットを作成して公開する
+	/// </summary>
+	void CaptureSnapshot();
+
+	/// <summary>
+	/// 試合の状態(プレイヤー、バフ、強化、ウェーブ、敵、アイテム、スコア、乱数)を
+	/// 書き込む・読み込む
+	/// </summary>
+	void SaveMatchSnapshot(SnapshotWriter& writer) const;
+	void LoadMatchSnapshot(SnapshotReader& reader);
+
+	// 現在のウェーブの開始時点の試合の状態
+	SnapshotWriter _waveStartSnapshot;
+	// _waveStartSnapshotを保存したウェーブ(-1なら未保存)
+	int _snapshotWaveIndex;
+
+	// ウェーブ進行中の直近の更新で発生したヒープ確保の回数
+	// (定常状態では0であることを期待している)
+	uint64_t _steadyAllocationCount;
 };
 
@@ -3,6 +3,7 @@
 #include "SceneTitle.h"  // 遷移先のシーン
 #include "SceneController.h"
 #include "SoundManager.h"
+#include "FontManager.h"
 
 #include "Input.h"
 #include "Statistics.h"
@@ -73,21 +74,34 @@ SceneOperationInstruction::SceneOperationInstruction() :
 	_headingFontHandle(-1),
 	_descriptionFontHandle(-1),
 	_nextSceneFontHandle(-1),
+	_subheadingString(),
+	_descriptionString(),
+	_headingAtlas(nullptr),
+	_subheadingAtlas(nullptr),
+	_descriptionAtlas(nullptr),
+	_nextSceneAtlas(nullptr),
+	_headingLayout(),
+	_subheadingLayouts(),
+	_descriptionLayouts(),
+	_padNextSceneLayout(),
+	_keybdNextSceneLayout(),
+	_batcher(),
 	_nextSceneTextTickFrame(0),
 	_isNextSceneTextActive(true),
 	_backgroundHandle(-1),
 	_controllerGraphHandle(-1)
 {
-	_headingFontHandle = CreateFontToHandle(kDefaultFontName.c_str(), kHeadingFontSize, kFontThickness,
+	FontManager& fontManager = FontManager::GetInstance();
+	_headingFontHandle = fontManager.Acquire(kDefaultFontName, kHeadingFontSize, kFontThickness,
 		DX_FONTTYPE_ANTIALIASING_EDGE);
 	assert(_headingFontHandle >= 0 && "フォントの作成に失敗");
-	_subheadingFontHandle = CreateFontToHandle(kDefaultFontName.c_str(), kSubheadingFontSize, kFontThickness,
+	_subheadingFontHandle = fontManager.Acquire(kDefaultFontName, kSubheadingFontSize, kFontThickness,
 		DX_FONTTYPE_ANTIALIASING_EDGE);
 	assert(_subheadingFontHandle >= 0 && "フォントの作成に失敗");
-	_descriptionFontHandle = CreateFontToHandle(kDefaultFontName.c_str(), kDescriptionFontSize, kFontThickness,
+	_descriptionFontHandle = fontManager.Acquire(kDefaultFontName, kDescriptionFontSize, kFontThickness,
 		DX_FONTTYPE_ANTIALIASING_EDGE);
 	assert(_descriptionFontHandle >= 0 && "フォントの作成に失敗");
-	_nextSceneFontHandle = CreateFontToHandle(kNextSceneTextFontName.c_str(), kNextSceneFontSize, kFontThickness,
+	_nextSceneFontHandle = fontManager.Acquire(kNextSceneTextFontName, kNextSceneFontSize, kFontThickness,
 		DX_FONTTYPE_ANTIALIASING_EDGE);
 	assert(_nextSceneFontHandle >= 0 && "フォントの作成に失敗");
 
@@ -128,16 +142,38 @@ SceneOperationInstruction::SceneOperationInstruction() :
 		//_subheadingString.emplace_back(L"Attack");
 		_descriptionString.emplace_back(L"LeftClick");
 	}
+
+	// 文字をまとめたアトラスを取得し、文字列の配置を先に計算しておく
+	_headingAtlas = &fontManager.GetAtlas(_headingFontHandle);
+	_subheadingAtlas = &fontManager.GetAtlas(_subheadingFontHandle);
+	_descriptionAtlas = &fontManager.GetAtlas(_descriptionFontHandle);
+	_nextSceneAtlas = &fontManager.GetAtlas(_nextSceneFontHandle);
+	_headingLayout = _headingAtlas->BuildLayout(kHeadingText);
+	for (const auto& str : _subheadingString) {
+		_subheadingLayouts.emplace_back(_subheadingAtlas->BuildLayout(str));
+	}
+	for (const auto& str : _descriptionString) {
+		_descriptionLayouts.emplace_back(_descriptionAtlas->BuildLayout(str));
+	}
+	_padNextSceneLayout = _nextSceneAtlas->BuildLayout(kPadNextSceneText);
+	_keybdNextSceneLayout = _nextSceneAtlas->BuildLayout(kKeybdNextSceneText);
 }
 
 SceneOperationInstruction::~SceneOperationInstruction()
 {
-	// フォント解放
+	// フォントを返す
+	FontManager& fontManager = FontManager::GetInstance();
 	if (_headingFontHandle != -1) {
-		DeleteFontToHandle(_headingFontHandle);
+		fontManager.Release(_headingFontHandle);
+	}
+	if (_subheadingFontHandle != -1) {
+		fontManager.Release(_subheadingFontHandle);
 	}
 	if (_descriptionFontHandle != -1) {
-		DeleteFontToHandle(_descriptionFontHandle);
+		fontManager.Release(_descriptionFontHandle);
+	}
+	if (_nextSceneFontHandle != -1) {
+		fontManager.Release(_nextSceneFontHandle);
 	}
 }
 
@@ -317,67 +353,51 @@ void SceneOperationInstruction::DrawOperationInstructionString()
 	// 見出しを描画
 	// 文字の中央までの長さをはかり
 	// 描画開始位置を求め描画する
-	int headingTextWidth = GetDrawStringWidthToHandle(
-		kHeadingText.c_str(),
-		static_cast<int>(kHeadingText.length()),
-		_headingFontHandle);
-	int headingDrawX = static_cast<int>((Statistics::kScreenWidth - headingTextWidth) * 0.5f);
-	DrawStringToHandle(
-		headingDrawX, y,
-		kHeadingText.c_str(), kTextColor,
-		_headingFontHandle);
+	int headingDrawX = static_cast<int>((Statistics::kScreenWidth - _headingLayout.width) * 0.5f);
+	_headingAtlas->DrawLayout(_batcher, _headingLayout,
+		static_cast<float>(headingDrawX), static_cast<float>(y), kTextColor);
 
 	// どちらか少ないほうの数だけ
 	// 小見出しと詳細を描画する
-	int drawNum = static_cast<int>(_subheadingString.size());
-	if (drawNum > _descriptionString.size()) {
-		drawNum = static_cast<int>(_descriptionString.size());
+	int drawNum = static_cast<int>(_subheadingLayouts.size());
+	if (drawNum > _descriptionLayouts.size()) {
+		drawNum = static_cast<int>(_descriptionLayouts.size());
 	}
 
 	y = kSubheadingTextStartY;
 
 	for (int i = 0; i < drawNum; ++i) {
 		// 小見出し描画
-		DrawStringToHandle(
-			kSubheadingTextStartX, y,
-			_subheadingString[i].c_str(), kTextColor,
-			_subheadingFontHandle);
+		_subheadingAtlas->DrawLayout(_batcher, _subheadingLayouts[i],
+			static_cast<float>(kSubheadingTextStartX), static_cast<float>(y), kTextColor);
 
 		// 描画位置を下げる
 		y += kSubheadingOffset;
 		
 		// 詳細描画
-		DrawStringToHandle(
-			kDescriptionTextStartX, y,
-			_descriptionString[i].c_str(), kTextColor,
-			_descriptionFontHandle);
+		_descriptionAtlas->DrawLayout(_batcher, _descriptionLayouts[i],
+			static_cast<float>(kDescriptionTextStartX), static_cast<float>(y), kTextColor);
 
 		// 最後の要素でないなら次の説明と距離を開けておく
 		if (i < drawNum + 1)	y += kDescriptionOffset;
 	}
 
-	// 案内が消滅状態なら描画しない
-	if (!_isNextSceneTextActive) return;
+	// 案内が消滅状態でなければ、最後にシーン遷移案内を描画
+	if (_isNextSceneTextActive) {
+		y += kNextSceneTextYOffset;
 
-	// 最後にシーン遷移案内を描画
-	y += kNextSceneTextYOffset;
+		// 最後の入力に応じて文字を変える
+		const TextLayout* drawLayout = &_padNextSceneLayout;
+		if (Input::GetInstance().GetLastInputType() == Input::PeripheralType::keybd) {
+			drawLayout = &_keybdNextSceneLayout;
+		}
 
-	// 最後の入力に応じて文字を変える
-	std::wstring drawString = kPadNextSceneText;
-	if (Input::GetInstance().GetLastInputType() == Input::PeripheralType::keybd) {
-		drawString = kKeybdNextSceneText;
+		// 文字の中央までの長さから描画開始位置を求め描画する
+		int nextSceneDrawX = static_cast<int>((Statistics::kScreenWidth - drawLayout->width) * 0.5f);
+		_nextSceneAtlas->DrawLayout(_batcher, *drawLayout,
+			static_cast<float>(nextSceneDrawX), static_cast<float>(y), kTextColor);
 	}
 
-	// 文字の中央までの長さをはかり
-	// 描画開始位置を求め描画する
-	int nextSceneTextWidth = GetDrawStringWidthToHandle(
-		drawString.c_str(),
-		static_cast<int>(drawString.length()),
-		_nextSceneFontHandle);
-	int nextSceneDrawX = static_cast<int>((Statistics::kScreenWidth - nextSceneTextWidth) * 0.5f);
-	DrawStringToHandle(
-		nextSceneDrawX, y,
-		drawString.c_str(), kTextColor,
-		_nextSceneFontHandle);
-
+	// 文字をまとめて描画する
+	_batcher.Flush();
 }
@@ -1,5 +1,7 @@
 ﻿#pragma once
 #include "SceneBase.h"
+#include "GlyphAtlas.h"
+#include "UIBatcher.h"
 #include <memory>
 #include <string>
 #include <vector>
@@ -86,6 +88,18 @@ private:
 	std::vector<std::wstring> _subheadingString;	// 小見出し文字
 	std::vector<std::wstring> _descriptionString;	// 詳細文字
 
+	// 文字をまとめた画像と、内容が変わらない文字列の配置
+	const GlyphAtlas* _headingAtlas;
+	const GlyphAtlas* _subheadingAtlas;
+	const GlyphAtlas* _descriptionAtlas;
+	const GlyphAtlas* _nextSceneAtlas;
+	TextLayout _headingLayout;
+	std::vector<TextLayout> _subheadingLayouts;
+	std::vector<TextLayout> _descriptionLayouts;
+	TextLayout _padNextSceneLayout;
+	TextLayout _keybdNextSceneLayout;
+	UIBatcher _batcher;
+
 	// 演出用変数
 	int _nextSceneTextTickFrame;	// 文字点滅時間を管理
 	bool _isNextSceneTextActive;	// 文字描画を行うか
@@ -7,6 +7,7 @@
 #include "Arena.h"
 #include "BillboardManager.h"
 #include "SoundManager.h"
+#include "FontManager.h"
 
 #include "Input.h"
 #include "Statistics.h"
@@ -54,6 +55,10 @@ SceneTitle::SceneTitle() :
 	_nextScene(nullptr),
 	_titleFontHandle(-1),
 	_nextSceneFontHandle(-1),
+	_nextSceneAtlas(nullptr),
+	_padNextSceneLayout(),
+	_keybdNextSceneLayout(),
+	_batcher(),
 	_nextSceneTextTickFrame(0),
 	_isNextSceneTextActive(true),
 	_titleImageHandle(-1),
@@ -62,15 +67,20 @@ SceneTitle::SceneTitle() :
 	_physics(std::make_shared<Physics>()),
 	_skydomeHandle(-1),
 	_arena(std::make_shared<Arena>()),
-	_billboardManager(std::make_shared<BillboardManager>())
+	_billboardManager(std::make_shared<BillboardManager>()),
+	_viewFrustum()
 {
 	//_titleFontHandle = CreateFontToHandle(kFontName.c_str(), kTitleFontSize, kFontThickness,
 	//	DX_FONTTYPE_ANTIALIASING_EDGE);
 	//assert(_titleFontHandle >= 0 && "フォントの作成に失敗");
-	_nextSceneFontHandle = CreateFontToHandle(kFontName.c_str(), kNextSceneFontSize, kFontThickness,
+	_nextSceneFontHandle = FontManager::GetInstance().Acquire(kFontName, kNextSceneFontSize, kFontThickness,
 		DX_FONTTYPE_ANTIALIASING_EDGE);
 	assert(_nextSceneFontHandle >= 0 && "フォントの作成に失敗");
 
+	// 文字をまとめたアトラスを取得し、文字列の配置を先に計算しておく
+	_nextSceneAtlas = &FontManager::GetInstance().GetAtlas(_nextSceneFontHandle);
+	_padNextSceneLayout = _nextSceneAtlas->BuildLayout(kPadNextSceneText);
+	_keybdNextSceneLayout = _nextSceneAtlas->BuildLayout(kKeybdNextSceneText);
 
 	//_titleGraphHandle = LoadGraph(L"data/img/background/Title.png");
 	//assert(_titleGraphHandle >= 0);
@@ -80,10 +90,10 @@ SceneTitle::~SceneTitle()
 {
 	// フォント解放
 	if (_titleFontHandle != -1) {
-		DeleteFontToHandle(_titleFontHandle);
+		FontManager::GetInstance().Release(_titleFontHandle);
 	}
 	if (_nextSceneFontHandle != -1) {
-		DeleteFontToHandle(_nextSceneFontHandle);
+		FontManager::GetInstance().Release(_nextSceneFontHandle);
 	}
 
 	if (_skydomeHandle != -1) {
@@ -244,7 +254,9 @@ void SceneTitle::FadeDraw()
 {
 	MV1DrawModel(_skydomeHandle);
 	_arena->Draw();
-	_billboardManager->Draw();
+	_viewFrustum.Setup(kCameraPos, _targetPos, kViewAngle,
+		static_cast<float>(Statistics::kScreenWidth) / Statistics::kScreenHeight, kNear, kFar);
+	_billboardManager->Draw(_viewFrustum);
 
 	// タイトル文字、背景描画
 	DrawTitleGraph();
@@ -271,7 +283,9 @@ void SceneTitle::NormalDraw()
 {
 	MV1DrawModel(_skydomeHandle);
 	_arena->Draw();
-	_billboardManager->Draw();
+	_viewFrustum.Setup(kCameraPos, _targetPos, kViewAngle,
+		static_cast<float>(Statistics::kScreenWidth) / Statistics::kScreenHeight, kNear, kFar);
+	_billboardManager->Draw(_viewFrustum);
 
 	// タイトル文字、背景描画
 	DrawTitleGraph();
@@ -320,19 +334,14 @@ void SceneTitle::DrawTitleString()
 	if (!_isNextSceneTextActive) return;
 
 	// 最後の入力に応じて文字を変える
-	std::wstring drawString = kPadNextSceneText;
+	const TextLayout* drawLayout = &_padNextSceneLayout;
 	if (Input::GetInstance().GetLastInputType() == Input::PeripheralType::keybd) {
-		drawString = kKeybdNextSceneText;
+		drawLayout = &_keybdNextSceneLayout;
 	}
 
 	// 同様に描画する
-	int nextSceneTextWidth = GetDrawStringWidthToHandle(
-		drawString.c_str(),
-		static_cast<int>(drawString.length()),
-		_nextSceneFontHandle);
-	int NextSceneDrawX = static_cast<int>((Statistics::kScreenWidth - nextSceneTextWidth) * 0.5f);
-	DrawStringToHandle(
-		NextSceneDrawX, kNextSceneTextY,
-		drawString.c_str(), kTextColor,
-		_nextSceneFontHandle);
+	int NextSceneDrawX = static_cast<int>((Statistics::kScreenWidth - drawLayout->width) * 0.5f);
+	_nextSceneAtlas->DrawLayout(_batcher, *drawLayout,
+		static_cast<float>(NextSceneDrawX), static_cast<float>(kNextSceneTextY), kTextColor);
+	_batcher.Flush();
 }
@@ -1,6 +1,9 @@
 ﻿#pragma once
 #include "SceneBase.h"
 #include "Vector3.h"
+#include "ViewFrustum.h"
+#include "GlyphAtlas.h"
+#include "UIBatcher.h"
 
 #include <memory>
 
@@ -87,6 +90,12 @@ private:
 	int _titleFontHandle;
 	int _nextSceneFontHandle;
 
+	// 文字をまとめた画像と、内容が変わらない文字列の配置
+	const GlyphAtlas* _nextSceneAtlas;
+	TextLayout _padNextSceneLayout;
+	TextLayout _keybdNextSceneLayout;
+	UIBatcher _batcher;
+
 	// 演出用変数
 	int _nextSceneTextTickFrame;	// 文字点滅時間を管理
 	bool _isNextSceneTextActive;	// 文字描画を行うか
@@ -101,4 +110,7 @@ private:
 	int _skydomeHandle;
 	std::shared_ptr<Arena> _arena;
 	std::shared_ptr<BillboardManager> _billboardManager;
+
+	// 観客の描画を絞り込むためのカメラの視錐台
+	ViewFrustum _viewFrustum;
 };
\ No newline at end of file
@@ -0,0 +1,87 @@
+﻿#include "ScreenProjector.h"
+#include <DxLib.h>
+#include <emmintrin.h>
+
+namespace {
+	// 同時に変換する数(SSEのレーン数)
+	constexpr int kLaneNum = 4;
+}
+
+ScreenProjector::ScreenProjector() :
+	_matrix()
+{
+}
+
+ScreenProjector::~ScreenProjector()
+{
+}
+
+void ScreenProjector::Setup()
+{
+	const MATRIX viewProj = MMult(GetCameraViewMatrix(), GetCameraProjectionMatrix());
+	const MATRIX mat = MMult(viewProj, GetCameraViewportMatrix());
+	for (int row = 0; row < 4; ++row) {
+		for (int col = 0; col < 4; ++col) {
+			_matrix[row][col] = mat.m[row][col];
+		}
+	}
+}
+
+int ScreenProjector::Project(const float* x, const float* y, const float* z, int count,
+	float* outX, float* outY, uint8_t* outVisible) const
+{
+	int visibleNum = 0;
+	const auto& m = _matrix;
+
+	// 4つずつまとめて変換する
+	int i = 0;
+	for (; i + kLaneNum <= count; i += kLaneNum) {
+		const __m128 px = _mm_loadu_ps(x + i);
+		const __m128 py = _mm_loadu_ps(y + i);
+		const __m128 pz = _mm_loadu_ps(z + i);
+
+		auto column = [&](int col) {
+			__m128 r = _mm_mul_ps(px, _mm_set1_ps(m[0][col]));
+			r = _mm_add_ps(r, _mm_mul_ps(py, _mm_set1_ps(m[1][col])));
+			r = _mm_add_ps(r, _mm_mul_ps(pz, _mm_set1_ps(m[2][col])));
+			return _mm_add_ps(r, _mm_set1_ps(m[3][col]));
+			};
+		const __m128 cx = column(0);
+		const __m128 cy = column(1);
+		const __m128 cz = column(2);
+		const __m128 cw = column(3);
+
+		// 後方(w<=0)は除算結果を使わない
+		const __m128 isFront = _mm_cmpgt_ps(cw, _mm_setzero_ps());
+		const __m128 invW = _mm_div_ps(_mm_set1_ps(1.0f), _mm_or_ps(
+			_mm_and_ps(isFront, cw), _mm_andnot_ps(isFront, _mm_set1_ps(1.0f))));
+		const __m128 sz = _mm_mul_ps(cz, invW);
+		const __m128 isVisible = _mm_and_ps(isFront, _mm_cmple_ps(sz, _mm_set1_ps(1.0f)));
+
+		_mm_storeu_ps(outX + i, _mm_mul_ps(cx, invW));
+		_mm_storeu_ps(outY + i, _mm_mul_ps(cy, invW));
+		const int mask = _mm_movemask_ps(isVisible);
+		for (int lane = 0; lane < kLaneNum; ++lane) {
+			const uint8_t visible = static_cast<uint8_t>((mask >> lane) & 1);
+			outVisible[i + lane] = visible;
+			visibleNum += visible;
+		}
+	}
+
+	// 端数は1つずつ変換する
+	for (; i < count; ++i) {
+		const float cx = x[i] * m[0][0] + y[i] * m[1][0] + z[i] * m[2][0] + m[3][0];
+		const float cy = x[i] * m[0][1] + y[i] * m[1][1] + z[i] * m[2][1] + m[3][1];
+		const float cz = x[i] * m[0][2] + y[i] * m[1][2] + z[i] * m[2][2] + m[3][2];
+		const float cw = x[i] * m[0][3] + y[i] * m[1][3] + z[i] * m[2][3] + m[3][3];
+		const bool isFront = (cw > 0.0f);
+		const float invW = isFront ? 1.0f / cw : 1.0f;
+		outX[i] = cx * invW;
+		outY[i] = cy * invW;
+		const bool isVisible = isFront && (cz * invW <= 1.0f);
+		outVisible[i] = static_cast<uint8_t>(isVisible);
+		visibleNum += isVisible;
+	}
+
+	return visibleNum;
+}
@@ -0,0 +1,34 @@
+﻿#pragma once
+#include <cstdint>
+
+/// <summary>
+/// ワールド座標をまとめてスクリーン座標に変換する
+/// ConvWorldPosToScreenPosを1点ずつ呼ぶ代わりに、
+/// カメラの行列を一度だけ取得して4点ずつ変換する
+/// </summary>
+class ScreenProjector final
+{
+public:
+	ScreenProjector();
+	~ScreenProjector();
+
+	/// <summary>
+	/// 現在のカメラの設定から変換行列を作る
+	/// (カメラの設定を変更した後に呼ぶ)
+	/// </summary>
+	void Setup();
+
+	/// <summary>
+	/// 座標をまとめてスクリーン座標に変換する
+	/// </summary>
+	/// <param name="outX">スクリーン座標X</param>
+	/// <param name="outY">スクリーン座標Y</param>
+	/// <param name="outVisible">カメラの前方にあり、描画距離内なら1</param>
+	/// <returns>前方にある数</returns>
+	int Project(const float* x, const float* y, const float* z, int count,
+		float* outX, float* outY, uint8_t* outVisible) const;
+
+private:
+	// ビュー、射影、ビューポート変換を合成した行列(行ベクトルに右から掛ける)
+	float _matrix[4][4];
+};
@@ -0,0 +1,34 @@
+﻿#include "SelfTest.h"
+#include <cstdio>
+
+namespace {
+	// 失敗した確認の数
+	int failureCount = 0;
+}
+
+int SelfTest::RunAll()
+{
+	failureCount = 0;
+
+	RunJobSystemTests();
+	RunRenderSnapshotTests();
+	RunEntityRegistryTests();
+	RunCullingTests();
+	RunRenderQueueTests();
+	RunSpatialGridTests();
+	RunAllocationTests();
+
+	printf("\nSelf test : %s (%d failed)\n", (failureCount == 0) ? "OK" : "NG", failureCount);
+	return failureCount;
+}
+
+void SelfTest::Check(bool isSucceeded, const char* name)
+{
+	printf("  [%s] %s\n", isSucceeded ? " OK " : " NG ", name);
+	if (!isSucceeded) ++failureCount;
+}
+
+void SelfTest::PrintHeader(const char* name)
+{
+	printf("\n== %s\n", name);
+}
@@ -0,0 +1,66 @@
+﻿#pragma once
+
+/// <summary>
+/// ウィンドウを作らずに行う確認と計測
+/// コマンドライン引数 -selftest で起動した場合にApplicationから呼ばれ、
+/// 結果はコンソールに出力する
+/// </summary>
+namespace SelfTest
+{
+	/// <summary>
+	/// 全ての確認と計測を行う
+	/// </summary>
+	/// <returns>失敗した確認の数</returns>
+	int RunAll();
+
+	/// <summary>
+	/// 確認の結果を出力し、失敗を数える
+	/// </summary>
+	/// <param name="isSucceeded">確認した条件</param>
+	/// <param name="name">確認の内容</param>
+	void Check(bool isSucceeded, const char* name);
+
+	/// <summary>
+	/// 区切りの見出しを出力する
+	/// </summary>
+	void PrintHeader(const char* name);
+
+	// 各機能の確認と計測(それぞれのファイルで定義する)
+
+	/// <summary>
+	/// JobSystem:子ジョブの待機、スレッド数によらない結果、コア数ごとの速度
+	/// </summary>
+	void RunJobSystemTests();
+
+	/// <summary>
+	/// RenderSnapshotBuffer:公開の順序、別スレッドからの書き込み中の読み込み
+	/// </summary>
+	void RunRenderSnapshotTests();
+
+	/// <summary>
+	/// EntityRegistry:作成と破棄、再利用された位置と古い識別番号、削除後の列の詰め直し
+	/// (敵の更新の速度はリプレイの終了時にApplicationが出力する)
+	/// </summary>
+	void RunEntityRegistryTests();
+
+	/// <summary>
+	/// 視錐台カリング:境界球の判定、まとめて判定した結果、視界外のものが描画されないこと
+	/// </summary>
+	void RunCullingTests();
+
+	/// <summary>
+	/// RenderQueue:層と種類ごとの並び、奥行きの順(半透明は画像が交互でも奥から)、状態の切り替え回数
+	/// </summary>
+	void RunRenderQueueTests();
+
+	/// <summary>
+	/// SpatialGrid:セルをまたぐ登録・移動・削除、総当たりと比べた半径・扇形・k近傍の探索
+	/// </summary>
+	void RunSpatialGridTests();
+
+	/// <summary>
+	/// AllocationCounter:全ての版のoperator newが数えられること、
+	/// 準備の後に定常状態のフレームを繰り返しても確保が起きないこと
+	/// </summary>
+	void RunAllocationTests();
+}
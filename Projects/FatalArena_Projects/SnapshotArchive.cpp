@@ -0,0 +1,44 @@
+﻿#include "SnapshotArchive.h"
+
+SnapshotWriter::SnapshotWriter() :
+	_data()
+{
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+}
+
+void SnapshotWriter::WriteString(const std::wstring& str)
+{
+	const uint32_t length = static_cast<uint32_t>(str.size());
+	Write(length);
+	const size_t pos = _data.size();
+	_data.resize(pos + length * sizeof(wchar_t));
+	std::memcpy(_data.data() + pos, str.data(), length * sizeof(wchar_t));
+}
+
+SnapshotReader::SnapshotReader(const std::vector<uint8_t>& data) :
+	_data(data),
+	_pos(0),
+	_isValid(true)
+{
+}
+
+SnapshotReader::~SnapshotReader()
+{
+}
+
+void SnapshotReader::ReadString(std::wstring& str)
+{
+	uint32_t length = 0;
+	Read(length);
+	const size_t size = length * sizeof(wchar_t);
+	if (!_isValid || _pos + size > _data.size()) {
+		_isValid = false;
+		return;
+	}
+	str.resize(length);
+	std::memcpy(str.data(), _data.data() + _pos, size);
+	_pos += size;
+}
@@ -0,0 +1,85 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// <summary>
+/// 試合の状態をメモリ上のバイナリに書き込む
+/// 値はそのままのバイト列で並べるため、同じ実行ファイルの中でのみ読み戻せる
+/// </summary>
+class SnapshotWriter final
+{
+public:
+	SnapshotWriter();
+	~SnapshotWriter();
+
+	/// <summary>
+	/// 書き込んだ内容を破棄する(確保済みの領域は残る)
+	/// </summary>
+	void Clear() { _data.clear(); }
+
+	/// <summary>
+	/// 値をそのまま書き込む
+	/// </summary>
+	template<typename T>
+	void Write(const T& value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "そのまま書き込めない型");
+		const size_t pos = _data.size();
+		_data.resize(pos + sizeof(T));
+		std::memcpy(_data.data() + pos, &value, sizeof(T));
+	}
+
+	/// <summary>
+	/// 文字列を長さ付きで書き込む
+	/// </summary>
+	void WriteString(const std::wstring& str);
+
+	const std::vector<uint8_t>& GetData() const { return _data; }
+
+private:
+	std::vector<uint8_t> _data;
+};
+
+/// <summary>
+/// SnapshotWriterで書き込んだバイナリを先頭から読み戻す
+/// </summary>
+class SnapshotReader final
+{
+public:
+	explicit SnapshotReader(const std::vector<uint8_t>& data);
+	~SnapshotReader();
+
+	/// <summary>
+	/// 値を読み込む
+	/// 末尾を越える場合は読み込まず、以降IsValidがfalseになる
+	/// </summary>
+	template<typename T>
+	void Read(T& value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "そのまま読み込めない型");
+		if (!_isValid || _pos + sizeof(T) > _data.size()) {
+			_isValid = false;
+			return;
+		}
+		std::memcpy(&value, _data.data() + _pos, sizeof(T));
+		_pos += sizeof(T);
+	}
+
+	/// <summary>
+	/// 長さ付きの文字列を読み込む
+	/// </summary>
+	void ReadString(std::wstring& str);
+
+	/// <summary>
+	/// ここまでの読み込みが全て成功したか
+	/// </summary>
+	bool IsValid() const { return _isValid; }
+
+private:
+	const std::vector<uint8_t>& _data;
+	size_t _pos;
+	bool _isValid;
+};
@@ -1,6 +1,8 @@
 ﻿#include "SoundManager.h"
 #include <string>
 #include <cassert>
+#include <algorithm>
+#include <cstdio>
 #include <DxLib.h>
 
 namespace {
@@ -30,6 +32,43 @@ namespace {
 		{ BGMType::Result,	L"data/sound/bgm/BGMResult.mp3" },
 	};
 
+	// 効果音ごとの再生枠の設定
+	struct SEVoiceSetting
+	{
+		int voiceNum;		// 同時に鳴らせる数
+		bool isStealable;	// 全て再生中のとき、最も古いものを止めて鳴らすか
+	};
+	const std::unordered_map<SEType, SEVoiceSetting> kSEVoiceSettings = {
+		// 操作に対する効果音は1つだけ鳴らし、押し直したら最初から鳴らす
+		{ SEType::Enter1,		{ 1, true } },
+		{ SEType::Enter2,		{ 1, true } },
+		{ SEType::Enter3,		{ 1, true } },
+		{ SEType::WaveStart,	{ 1, true } },
+		{ SEType::PlayerReinforcement,	{ 1, true } },
+		{ SEType::PlayerDeath,	{ 1, true } },
+		// プレイヤー自身の効果音は少しだけ重ねる
+		{ SEType::Swing1,		{ 2, true } },
+		{ SEType::Swing2,		{ 2, true } },
+		{ SEType::PlayerReact,	{ 2, true } },
+		{ SEType::ItemHeal,		{ 2, true } },
+		{ SEType::ItemStrength,	{ 2, true } },
+		{ SEType::ItemScoreBoost,	{ 2, true } },
+		// 敵の数だけ鳴り得る効果音は重ねる数を絞り、鳴っているものは途中で止めない
+		{ SEType::Attack1,		{ 4, true } },
+		{ SEType::Attack2,		{ 4, false } },
+		{ SEType::SpawnEnemy,	{ 3, false } },
+		{ SEType::EnemyAttack,	{ 4, false } },
+		{ SEType::EnemyDeath,	{ 4, false } },
+	};
+
+	// 同じフレームに重なった要求1回あたりの音量の増加率と、その上限
+	constexpr float kMergeVolumeRate = 0.25f;
+	constexpr float kMaxMergeVolumeRate = 1.5f;
+	constexpr int kMaxVolume = 255;
+
+	// BGMのクロスフェードにかかるフレーム数
+	constexpr int kBGMCrossfadeFrame = 60;
+
 	constexpr float kMasterVolumeRatio = 0.7f;
 	constexpr int kSEVolume = static_cast<int>(255 * 1.0f * kMasterVolumeRatio);
 	constexpr int kBGMVolume = static_cast<int>(255 * 0.6f * kMasterVolumeRatio);
@@ -44,7 +83,12 @@ SoundManager& SoundManager::GetInstance()
 
 void SoundManager::LoadResources()
 {
+#ifdef _DEBUG
+	const long long startTime = GetNowHiPerformanceCount();
+#endif // _DEBUG
+
 	// 全てのサウンドを読み込み、ハンドルを保存する
+	// 効果音は即座に鳴らせるよう、展開してメモリに置く
 	for (const auto& pair : kSEPaths) {
 		const SEType& type = pair.first;
 		const std::wstring& path = pair.second;
@@ -52,7 +96,27 @@ void SoundManager::LoadResources()
 		assert(handle != -1 && "サウンドの読み込みに失敗");
 		_seList[type] = handle;
 		ChangeVolumeSoundMem(kSEVolume, handle);
+
+		// 同時に鳴らす分だけ複製しておく(音声データは複製元と共有される)
+		auto settingIt = kSEVoiceSettings.find(type);
+		assert(settingIt != kSEVoiceSettings.end() && "再生枠の設定がない");
+		const SEVoiceSetting& setting = settingIt->second;
+		SEVoices& voices = _seVoices[static_cast<int>(type)];
+		voices.handles.clear();
+		voices.handles.emplace_back(handle);
+		for (int i = 1; i < setting.voiceNum; ++i) {
+			int voiceHandle = DuplicateSoundMem(handle);
+			assert(voiceHandle != -1 && "サウンドの複製に失敗");
+			ChangeVolumeSoundMem(kSEVolume, voiceHandle);
+			voices.handles.emplace_back(voiceHandle);
+		}
+		voices.startSerials.assign(voices.handles.size(), 0);
+		voices.isStealable = setting.isStealable;
 	}
+	// BGMは全体を展開せず、ファイルから少しずつ読み込みながら再生する
+	// (読み込みと展開はDxLibの再生処理で順に行われ、アーカイブ内のファイルも同様に扱える)
+	const int prevDataType = GetCreateSoundDataType();
+	SetCreateSoundDataType(DX_SOUNDDATATYPE_FILE);
 	for (const auto& pair : kBGMPaths) {
 		const BGMType& type = pair.first;
 		const std::wstring& path = pair.second;
@@ -60,12 +124,29 @@ void SoundManager::LoadResources()
 		assert(handle != -1 && "サウンドの読み込みに失敗");
 		_bgmList[type] = handle;
 		ChangeVolumeSoundMem(kBGMVolume, handle);
+		_bgmFades[static_cast<int>(type)] = BGMFade();
 	}
+	SetCreateSoundDataType(prevDataType);
+
+#ifdef _DEBUG
+	printf("Sound load : %.3f ms\n", (GetNowHiPerformanceCount() - startTime) / 1000.0);
+#endif // _DEBUG
 }
 
 void SoundManager::ReleaseResources()
 {
 	// 保存されている全てのサウンドを解放する
+	// (複製したものを先に解放する)
+	for (auto& voices : _seVoices) {
+		for (int i = 1; i < static_cast<int>(voices.handles.size()); ++i) {
+			DeleteSoundMem(voices.handles[i]);
+		}
+		voices.handles.clear();
+		voices.startSerials.clear();
+	}
+	for (auto& request : _seRequests) {
+		request.count = 0;
+	}
 	for (const auto& pair : _seList) {
 		DeleteSoundMem(pair.second);
 	}
@@ -79,11 +160,10 @@ void SoundManager::ReleaseResources()
 void SoundManager::PlaySoundType(SEType type)
 {
 	// 複製元のサウンドが存在するかチェック
-	auto it = _seList.find(type);
-	assert(it != _seList.end() && "要求されたタイプのサウンドが読み込まれていない");
+	assert(_seList.find(type) != _seList.end() && "要求されたタイプのサウンドが読み込まれていない");
 
-	// 効果音再生
-	PlaySoundMem(it->second, DX_PLAYTYPE_BACK, true);
+	// 再生はフレームの最後にまとめて行う
+	++_seRequests[static_cast<int>(type)].count;
 }
 
 void SoundManager::PlaySoundType(BGMType type, bool isLoop, bool isPlayFromStart)
@@ -92,22 +172,96 @@ void SoundManager::PlaySoundType(BGMType type, bool isLoop, bool isPlayFromStart
 	auto it = _bgmList.find(type);
 	assert(it != _bgmList.end() && "要求されたタイプのサウンドが読み込まれていない");
 
+	// 他のBGMが鳴っていればクロスフェードにする
+	bool isOtherPlaying = false;
 	for (auto& pair : _bgmList) {
-		// 同じBGMかつ途中からの再生を許可している場合はcontinue
-		if (!isPlayFromStart && type == pair.first) continue;
-		// 既存のBGMが鳴っていたら停止
+		if (type == pair.first) continue;
+		// 既存のBGMが鳴っていたらフェードアウトさせる
 		if (CheckSoundMem(pair.second) == 1) {
-			StopSoundMem(pair.second);
+			_bgmFades[static_cast<int>(pair.first)].targetVolume = 0.0f;
+			isOtherPlaying = true;
 		}
 	}
 
+	BGMFade& fade = _bgmFades[static_cast<int>(type)];
+	fade.targetVolume = 1.0f;
+
 	// 指定された曲がなっていたかつ
-	// 最初からの再生を希望されていないならreturn
-	if (CheckSoundMem(_bgmList[type]) == 1 &&
-		!isPlayFromStart) return;
+	// 最初からの再生を希望されていないなら、フェードアウト中でも音量を戻して続ける
+	if (CheckSoundMem(it->second) == 1) {
+		if (!isPlayFromStart) return;
+		StopSoundMem(it->second);
+	}
+
+	// 他のBGMが鳴っていなければフェードせずに鳴らす
+	fade.volume = isOtherPlaying ? 0.0f : 1.0f;
+	ChangeVolumeSoundMem(static_cast<int>(kBGMVolume * fade.volume), it->second);
 
 	// BGM再生
 	int playType = DX_PLAYTYPE_LOOP;
 	if (!isLoop) playType = DX_PLAYTYPE_BACK;
 	PlaySoundMem(it->second, playType, true);
 }
+
+void SoundManager::UpdateBGM()
+{
+	constexpr float step = 1.0f / kBGMCrossfadeFrame;
+	for (const auto& pair : _bgmList) {
+		BGMFade& fade = _bgmFades[static_cast<int>(pair.first)];
+		if (fade.volume == fade.targetVolume) continue;
+
+		// 目標の音量へ一定の速さで近づける
+		if (fade.volume < fade.targetVolume) {
+			fade.volume = std::min<float>(fade.volume + step, fade.targetVolume);
+		}
+		else {
+			fade.volume = std::max<float>(fade.volume - step, fade.targetVolume);
+		}
+		ChangeVolumeSoundMem(static_cast<int>(kBGMVolume * fade.volume), pair.second);
+
+		// フェードアウトしきったら止める
+		if (fade.volume <= 0.0f && CheckSoundMem(pair.second) == 1) {
+			StopSoundMem(pair.second);
+		}
+	}
+}
+
+void SoundManager::FlushSERequests()
+{
+	for (int i = 0; i < kSETypeNum; ++i) {
+		SERequest& request = _seRequests[i];
+		if (request.count == 0) continue;
+
+		SEVoices& voices = _seVoices[i];
+		const int voice = SelectVoice(voices);
+		if (voice >= 0) {
+			// 同じフレームの要求は1回の再生にまとめ、回数に応じて音量を上げる
+			const float rate = std::min<float>(1.0f + (request.count - 1) * kMergeVolumeRate, kMaxMergeVolumeRate);
+			const int volume = std::min<int>(static_cast<int>(kSEVolume * rate), kMaxVolume);
+			const int handle = voices.handles[voice];
+			ChangeVolumeSoundMem(volume, handle);
+			PlaySoundMem(handle, DX_PLAYTYPE_BACK, true);
+			voices.startSerials[voice] = ++_playSerial;
+		}
+		request.count = 0;
+	}
+}
+
+int SoundManager::SelectVoice(SEVoices& voices)
+{
+	int oldest = -1;
+	for (int i = 0; i < static_cast<int>(voices.handles.size()); ++i) {
+		// 鳴っていない枠があればそれを使う
+		if (CheckSoundMem(voices.handles[i]) != 1) return i;
+		if (oldest < 0 || voices.startSerials[i] < voices.startSerials[oldest]) {
+			oldest = i;
+		}
+	}
+
+	// 全て再生中で止められないなら鳴らさない
+	if (oldest < 0 || !voices.isStealable) return -1;
+
+	// 最も前に鳴らし始めたものを止めて使う
+	StopSoundMem(voices.handles[oldest]);
+	return oldest;
+}
@@ -1,5 +1,7 @@
 ﻿#pragma once
 #include <unordered_map>
+#include <array>
+#include <vector>
 
 enum class SEType {
 	Enter1,
@@ -31,13 +33,19 @@ enum class BGMType {
 
 /// <summary>
 /// BGMや効果音を管理するシングルトンクラス
+/// 効果音は種類ごとに複製した再生枠を持ち、再生要求は1フレーム分まとめてから鳴らす
+/// BGMはファイルから少しずつ読み込みながら再生し、切り替え時はクロスフェードする
 /// </summary>
 class SoundManager
 {
 private:
 	SoundManager() :
 		_seList(),
-		_bgmList()
+		_bgmList(),
+		_seVoices(),
+		_seRequests(),
+		_playSerial(0),
+		_bgmFades()
 	{
 	}
 	SoundManager(const SoundManager&) = delete;
@@ -56,15 +64,69 @@ public:
 	/// </summary>
 	void ReleaseResources();
 
+	/// <summary>
+	/// 効果音の再生を要求する
+	/// 実際の再生はFlushSERequestsで行い、同じフレームの同じ効果音は1回にまとめる
+	/// </summary>
 	void PlaySoundType(SEType type);
+	/// <summary>
+	/// BGMを再生する
+	/// 他のBGMが鳴っていれば、そちらをフェードアウトさせながらフェードインする
+	/// </summary>
+	/// <param name="isPlayFromStart">falseなら、同じBGMが鳴っている場合はそのまま続ける</param>
 	void PlaySoundType(BGMType type, bool isLoop = true, bool isPlayFromStart = true);
 
+	/// <summary>
+	/// BGMのクロスフェードを進める(1フレームに1回呼ぶ)
+	/// </summary>
+	void UpdateBGM();
+
+	/// <summary>
+	/// このフレームに要求された効果音をまとめて再生する(1フレームに1回呼ぶ)
+	/// </summary>
+	void FlushSERequests();
+
 private:
+	// 効果音の種類ごとの再生枠
+	struct SEVoices
+	{
+		std::vector<int> handles;		// 複製したサウンド(先頭は複製元)
+		std::vector<unsigned int> startSerials;	// 再生を始めた順番(古いものから止めるため)
+		bool isStealable = true;		// 全て再生中のとき、最も古いものを止めて鳴らすか
+	};
+	// 1フレーム分の再生要求
+	struct SERequest
+	{
+		int count = 0;	// 要求された回数
+	};
+	static constexpr int kSETypeNum = static_cast<int>(SEType::typeNum);
+
+	// BGMごとのフェードの状態(音量は0.0-1.0)
+	struct BGMFade
+	{
+		float volume = 0.0f;
+		float targetVolume = 0.0f;
+	};
+	static constexpr int kBGMTypeNum = static_cast<int>(BGMType::typeNum);
+
+	/// <summary>
+	/// 空いている再生枠を返す(なければ規則に従って止めた枠、止められなければ-1)
+	/// </summary>
+	int SelectVoice(SEVoices& voices);
 
 	// SE種別、ハンドルを管理
 	std::unordered_map<SEType, int> _seList;
 
 	// BGM種別、ハンドルを管理
 	std::unordered_map<BGMType, int> _bgmList;
+
+	// 効果音種別ごとの再生枠と、このフレームの再生要求
+	std::array<SEVoices, kSETypeNum> _seVoices;
+	std::array<SERequest, kSETypeNum> _seRequests;
+	// 再生を始めるたびに増やす番号
+	unsigned int _playSerial;
+
+	// BGM種別ごとのフェードの状態
+	std::array<BGMFade, kBGMTypeNum> _bgmFades;
 };
 
@@ -0,0 +1,212 @@
+﻿#include "SpatialGrid.h"
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+
+SpatialGrid::SpatialGrid(float halfExtent, float cellSize) :
+	_halfExtent(halfExtent),
+	_cellSize(cellSize),
+	_cellNum(0),
+	_entries(),
+	_cells()
+{
+	assert(halfExtent > 0.0f && cellSize > 0.0f && "グリッドの大きさが正しくない");
+	_cellNum = std::max<int>(1, static_cast<int>(std::ceil(halfExtent * 2.0f / cellSize)));
+	_cells.resize(static_cast<size_t>(_cellNum) * _cellNum);
+}
+
+SpatialGrid::~SpatialGrid()
+{
+}
+
+void SpatialGrid::Clear()
+{
+	for (auto& cell : _cells) {
+		cell.clear();
+	}
+	_entries.clear();
+}
+
+void SpatialGrid::Update(int id, const Position3& pos)
+{
+	assert(id >= 0 && "idが正しくない");
+	if (id >= static_cast<int>(_entries.size())) {
+		_entries.resize(id + 1);
+	}
+
+	Entry& entry = _entries[id];
+	entry.x = pos.x;
+	entry.z = pos.z;
+
+	// 所属するセルが変わった場合のみ移し替える
+	const int cell = ToCellIndex(ToCellCoord(pos.x), ToCellCoord(pos.z));
+	if (entry.cell == cell) return;
+	if (entry.cell >= 0) {
+		auto& ids = _cells[entry.cell];
+		auto it = std::find(ids.begin(), ids.end(), id);
+		if (it != ids.end()) {
+			// 順番は問わないので末尾と入れ替えて削除
+			*it = ids.back();
+			ids.pop_back();
+		}
+	}
+	_cells[cell].emplace_back(id);
+	entry.cell = cell;
+}
+
+void SpatialGrid::Remove(int id)
+{
+	if (id < 0 || id >= static_cast<int>(_entries.size())) return;
+	Entry& entry = _entries[id];
+	if (entry.cell < 0) return;
+
+	auto& ids = _cells[entry.cell];
+	auto it = std::find(ids.begin(), ids.end(), id);
+	if (it != ids.end()) {
+		*it = ids.back();
+		ids.pop_back();
+	}
+	entry.cell = -1;
+}
+
+int SpatialGrid::QueryNearest(const Position3& pos, float maxDist, const Filter_t& filter) const
+{
+	NearestList_t best;
+	FindNearestK(pos, 1, maxDist, best, filter);
+	if (best.empty()) return -1;
+	return best.front().second;
+}
+
+void SpatialGrid::QueryNearestK(const Position3& pos, int k, float maxDist, std::vector<int>& out,
+	const Filter_t& filter) const
+{
+	out.clear();
+	NearestList_t best;
+	FindNearestK(pos, k, maxDist, best, filter);
+	for (const auto& item : best) {
+		out.emplace_back(item.second);
+	}
+}
+
+void SpatialGrid::FindNearestK(const Position3& pos, int k, float maxDist, NearestList_t& best,
+	const Filter_t& filter) const
+{
+	best.clear();
+	if (k <= 0) return;
+
+	const float maxDistSq = maxDist * maxDist;
+	const int centerX = ToCellCoord(pos.x);
+	const int centerZ = ToCellCoord(pos.z);
+
+	// (距離の2乗, id) を近い順に最大k個保持する
+	best.reserve(k);
+
+	// 中心のセルから外側へ1周ずつ探索する
+	for (int ring = 0; ring <= _cellNum; ++ring) {
+		// この周のセルまでの最短距離
+		// (基準位置は中心のセル内にあるため、1周内側のセル分は必ず離れている)
+		const float ringDist = std::max<float>(0.0f, (ring - 1) * _cellSize);
+		const float ringDistSq = ringDist * ringDist;
+		// 最大距離より外側しか残っていない
+		if (ringDistSq > maxDistSq) break;
+		// 既にk個見つかっていて、この周より近いものしかない
+		if (static_cast<int>(best.size()) == k && best.back().first <= ringDistSq) break;
+
+		const int minX = centerX - ring;
+		const int maxX = centerX + ring;
+		const int minZ = centerZ - ring;
+		const int maxZ = centerZ + ring;
+		for (int cz = std::max<int>(minZ, 0); cz <= std::min<int>(maxZ, _cellNum - 1); ++cz) {
+			for (int cx = std::max<int>(minX, 0); cx <= std::min<int>(maxX, _cellNum - 1); ++cx) {
+				// 周上のセルのみ(内側は探索済み)
+				if (cz != minZ && cz != maxZ && cx != minX && cx != maxX) continue;
+
+				for (int id : _cells[ToCellIndex(cx, cz)]) {
+					const Entry& entry = _entries[id];
+					const float dx = entry.x - pos.x;
+					const float dz = entry.z - pos.z;
+					const float distSq = dx * dx + dz * dz;
+					if (distSq > maxDistSq) continue;
+					if (static_cast<int>(best.size()) == k && distSq >= best.back().first) continue;
+					if (filter && !filter(id)) continue;
+
+					// 近い順を保つ位置に挿入する
+					auto it = std::upper_bound(best.begin(), best.end(), distSq,
+						[](float d, const std::pair<float, int>& item) { return d < item.first; });
+					best.insert(it, { distSq, id });
+					if (static_cast<int>(best.size()) > k) best.pop_back();
+				}
+			}
+		}
+	}
+}
+
+void SpatialGrid::QueryRadius(const Position3& pos, float radius, std::vector<int>& out,
+	const Filter_t& filter) const
+{
+	out.clear();
+	const float radiusSq = radius * radius;
+
+	ForEachInRect(
+		ToCellCoord(pos.x - radius), ToCellCoord(pos.z - radius),
+		ToCellCoord(pos.x + radius), ToCellCoord(pos.z + radius),
+		[&](int id, const Entry& entry) {
+			const float dx = entry.x - pos.x;
+			const float dz = entry.z - pos.z;
+			if (dx * dx + dz * dz > radiusSq) return;
+			if (filter && !filter(id)) return;
+			out.emplace_back(id);
+		});
+}
+
+void SpatialGrid::QueryCone(const Position3& pos, const Vector3& dir, float halfAngle, float radius,
+	std::vector<int>& out, const Filter_t& filter) const
+{
+	out.clear();
+
+	// 方向をXZ平面で正規化しておく(要素ごとには平方根を使わない)
+	float dirX = dir.x;
+	float dirZ = dir.z;
+	const float dirLenSq = dirX * dirX + dirZ * dirZ;
+	if (dirLenSq <= 0.0f) return;
+	const float invLen = 1.0f / std::sqrt(dirLenSq);
+	dirX *= invLen;
+	dirZ *= invLen;
+
+	const float radiusSq = radius * radius;
+	const float cosHalf = std::cos(halfAngle);
+	const float cosHalfSq = cosHalf * cosHalf;
+
+	ForEachInRect(
+		ToCellCoord(pos.x - radius), ToCellCoord(pos.z - radius),
+		ToCellCoord(pos.x + radius), ToCellCoord(pos.z + radius),
+		[&](int id, const Entry& entry) {
+			const float dx = entry.x - pos.x;
+			const float dz = entry.z - pos.z;
+			const float distSq = dx * dx + dz * dz;
+			if (distSq > radiusSq) return;
+
+			// dot >= cos * |d| を2乗して比較する
+			const float dot = dx * dirX + dz * dirZ;
+			bool isInside = false;
+			if (distSq <= 0.0f) {
+				isInside = true;
+			}
+			else if (cosHalf >= 0.0f) {
+				isInside = (dot >= 0.0f && dot * dot >= cosHalfSq * distSq);
+			}
+			else {
+				isInside = (dot >= 0.0f || dot * dot <= cosHalfSq * distSq);
+			}
+			if (!isInside) return;
+			if (filter && !filter(id)) return;
+			out.emplace_back(id);
+		});
+}
+
+int SpatialGrid::ToCellCoord(float v) const
+{
+	const int c = static_cast<int>(std::floor((v + _halfExtent) / _cellSize));
+	return std::clamp<int>(c, 0, _cellNum - 1);
+}
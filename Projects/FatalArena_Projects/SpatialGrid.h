@@ -0,0 +1,122 @@
+﻿#pragma once
+#include "Vector3.h"
+#include "FrameAllocator.h"
+#include <vector>
+#include <functional>
+#include <utility>
+
+/// <summary>
+/// XZ平面を一定サイズのセルに分割して位置を管理する空間インデックス
+/// 近傍探索(最近傍、k近傍、半径、扇形)を平方根を使わずに行う
+/// 登録するidは0から始まる連番を想定している
+/// </summary>
+class SpatialGrid final
+{
+public:
+	// 候補を絞り込む関数(trueなら候補にする)
+	using Filter_t = std::function<bool(int id)>;
+
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="halfExtent">原点から管理する範囲の端までの距離</param>
+	/// <param name="cellSize">セル一辺の長さ</param>
+	SpatialGrid(float halfExtent, float cellSize);
+	~SpatialGrid();
+
+	/// <summary>
+	/// 登録されている全ての要素を削除する
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// 位置を登録・更新する
+	/// 未登録のidであれば新たに登録する
+	/// </summary>
+	void Update(int id, const Position3& pos);
+
+	/// <summary>
+	/// 登録を解除する
+	/// </summary>
+	void Remove(int id);
+
+	/// <summary>
+	/// 指定位置から最も近い要素を返す
+	/// </summary>
+	/// <param name="pos">基準位置</param>
+	/// <param name="maxDist">探索する最大距離</param>
+	/// <param name="filter">候補の絞り込み(nullptrなら全て)</param>
+	/// <returns>見つからなかった場合は-1</returns>
+	int QueryNearest(const Position3& pos, float maxDist, const Filter_t& filter = nullptr) const;
+
+	/// <summary>
+	/// 指定位置から近い順に最大k個の要素を返す
+	/// </summary>
+	/// <param name="out">結果(近い順)</param>
+	void QueryNearestK(const Position3& pos, int k, float maxDist, std::vector<int>& out,
+		const Filter_t& filter = nullptr) const;
+
+	/// <summary>
+	/// 指定位置から半径内にある要素を返す
+	/// </summary>
+	/// <param name="out">結果(順不同)</param>
+	void QueryRadius(const Position3& pos, float radius, std::vector<int>& out,
+		const Filter_t& filter = nullptr) const;
+
+	/// <summary>
+	/// 指定位置から指定方向の扇形内にある要素を返す
+	/// </summary>
+	/// <param name="dir">扇形の中心方向(XZのみ使用)</param>
+	/// <param name="halfAngle">扇形の半角(ラジアン)</param>
+	/// <param name="out">結果(順不同)</param>
+	void QueryCone(const Position3& pos, const Vector3& dir, float halfAngle, float radius,
+		std::vector<int>& out, const Filter_t& filter = nullptr) const;
+
+private:
+	// 登録情報
+	struct Entry
+	{
+		float x = 0.0f;
+		float z = 0.0f;
+		int cell = -1;	// 所属しているセル(-1なら未登録)
+	};
+
+	/// <summary>
+	/// 座標からセルの列・行番号を求める(範囲外は端のセルに丸める)
+	/// </summary>
+	int ToCellCoord(float v) const;
+	int ToCellIndex(int cx, int cz) const { return cz * _cellNum + cx; }
+
+	// 近傍探索の途中結果(距離の2乗, id)
+	// (探索のたびにヒープから確保しないようフレーム用の領域を使う)
+	using NearestList_t = std::vector<std::pair<float, int>, FrameStlAllocator<std::pair<float, int>>>;
+
+	/// <summary>
+	/// 指定位置から近い順に最大k個の要素を求める
+	/// </summary>
+	void FindNearestK(const Position3& pos, int k, float maxDist, NearestList_t& best,
+		const Filter_t& filter) const;
+
+	/// <summary>
+	/// 指定の範囲のセルに含まれる要素を順に渡す
+	/// (関数オブジェクトへの変換で確保が起きないようテンプレートで受け取る)
+	/// </summary>
+	template<typename Func>
+	void ForEachInRect(int minX, int minZ, int maxX, int maxZ, Func&& func) const
+	{
+		for (int cz = minZ; cz <= maxZ; ++cz) {
+			for (int cx = minX; cx <= maxX; ++cx) {
+				for (int id : _cells[ToCellIndex(cx, cz)]) {
+					func(id, _entries[id]);
+				}
+			}
+		}
+	}
+
+	float _halfExtent;
+	float _cellSize;
+	int _cellNum;	// 一辺のセル数
+
+	std::vector<Entry> _entries;			// idごとの登録情報
+	std::vector<std::vector<int>> _cells;	// セルごとのid
+};
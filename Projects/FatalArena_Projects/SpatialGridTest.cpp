@@ -0,0 +1,182 @@
+﻿#include "SelfTest.h"
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+	// 確認に使うグリッド(一辺20セル)
+	constexpr float kHalfExtent = 1000.0f;
+	constexpr float kCellSize = 100.0f;
+
+	// 総当たりと比べる要素の数と、探索の回数
+	constexpr int kRandomEntryNum = 500;
+	constexpr int kRandomQueryNum = 200;
+	constexpr int kNearestNum = 5;
+	constexpr float kQueryRadius = 250.0f;
+	constexpr float kConeHalfAngle = 3.14159265f / 6.0f;
+	constexpr unsigned int kRandomSeed = 2468;
+
+	/// <summary>
+	/// XZ平面での距離の2乗
+	/// </summary>
+	float DistSqXZ(const Position3& a, const Position3& b)
+	{
+		const float dx = a.x - b.x;
+		const float dz = a.z - b.z;
+		return dx * dx + dz * dz;
+	}
+
+	/// <summary>
+	/// 扇形に含まれるかを角度から直接求める(SpatialGridとは別の方法で確認する)
+	/// </summary>
+	bool IsInsideCone(const Position3& origin, const Vector3& dir, float halfAngle, float radius,
+		const Position3& pos)
+	{
+		const float dx = pos.x - origin.x;
+		const float dz = pos.z - origin.z;
+		const float dist = std::sqrt(dx * dx + dz * dz);
+		if (dist > radius) return false;
+		if (dist <= 0.0f) return true;
+		const float dirLen = std::sqrt(dir.x * dir.x + dir.z * dir.z);
+		const float cosAngle = (dx * dir.x + dz * dir.z) / (dist * dirLen);
+		return cosAngle >= std::cos(halfAngle);
+	}
+
+	/// <summary>
+	/// 順番を問わずに結果を比べる
+	/// </summary>
+	bool IsSameSet(std::vector<int> a, std::vector<int> b)
+	{
+		std::sort(a.begin(), a.end());
+		std::sort(b.begin(), b.end());
+		return a == b;
+	}
+}
+
+void SelfTest::RunSpatialGridTests()
+{
+	PrintHeader("SpatialGrid");
+
+	// セルの境界をまたぐ登録、移動、削除
+	{
+		SpatialGrid grid(kHalfExtent, kCellSize);
+		// 0と1はセルの境界(x = 0)を挟んで隣り合う
+		grid.Update(0, Position3(-1.0f, 0.0f, 50.0f));
+		grid.Update(1, Position3(1.0f, 0.0f, 50.0f));
+		grid.Update(2, Position3(450.0f, 0.0f, 450.0f));
+		std::vector<int> result;
+
+		grid.QueryRadius(Position3(0.0f, 0.0f, 50.0f), 5.0f, result);
+		Check(IsSameSet(result, { 0, 1 }), "a radius query finds entries on both sides of a cell border");
+
+		// 境界をまたいで移動する
+		grid.Update(0, Position3(-1.0f, 0.0f, 150.0f));
+		grid.QueryRadius(Position3(0.0f, 0.0f, 50.0f), 5.0f, result);
+		Check(IsSameSet(result, { 1 }), "a moved entry leaves its old cell");
+		grid.QueryRadius(Position3(0.0f, 0.0f, 150.0f), 5.0f, result);
+		Check(IsSameSet(result, { 0 }), "a moved entry is found in its new cell");
+
+		// 最近傍は隣のセルにあっても見つかる
+		Check(grid.QueryNearest(Position3(99.0f, 0.0f, 150.0f), 500.0f) == 0,
+			"the nearest entry is found across a cell border");
+		Check(grid.QueryNearest(Position3(99.0f, 0.0f, 150.0f), 50.0f) == -1,
+			"the nearest query respects the maximum distance");
+
+		grid.Remove(0);
+		grid.QueryRadius(Position3(0.0f, 0.0f, 150.0f), 5.0f, result);
+		Check(result.empty(), "a removed entry is no longer found");
+		Check(grid.QueryNearest(Position3(0.0f, 0.0f, 150.0f), 500.0f) == 1,
+			"the nearest query skips removed entries");
+
+		// 削除したidを再び登録できる
+		grid.Update(0, Position3(455.0f, 0.0f, 455.0f));
+		grid.QueryRadius(Position3(450.0f, 0.0f, 450.0f), 10.0f, result);
+		Check(IsSameSet(result, { 0, 2 }), "a removed id can be registered again");
+
+		// 扇形は境界をまたいでも向きで絞り込まれる
+		grid.QueryCone(Position3(400.0f, 0.0f, 400.0f), Vector3(1.0f, 0.0f, 1.0f), kConeHalfAngle,
+			200.0f, result);
+		Check(IsSameSet(result, { 0, 2 }), "a cone query finds entries in front across cell borders");
+		grid.QueryCone(Position3(400.0f, 0.0f, 400.0f), Vector3(-1.0f, 0.0f, -1.0f), kConeHalfAngle,
+			200.0f, result);
+		Check(result.empty(), "a cone query ignores entries behind it");
+
+		// 絞り込みの関数
+		grid.QueryRadius(Position3(450.0f, 0.0f, 450.0f), 10.0f, result,
+			[](int id) { return id != 2; });
+		Check(IsSameSet(result, { 0 }), "the filter excludes rejected entries");
+	}
+
+	// 総当たりで求めた結果と一致する
+	{
+		std::mt19937 random(kRandomSeed);
+		std::uniform_real_distribution<float> posDist(-kHalfExtent, kHalfExtent);
+		std::uniform_real_distribution<float> angleDist(-3.14159265f, 3.14159265f);
+
+		SpatialGrid grid(kHalfExtent, kCellSize);
+		std::vector<Position3> positions(kRandomEntryNum);
+		for (int i = 0; i < kRandomEntryNum; ++i) {
+			positions[i] = Position3(posDist(random), 0.0f, posDist(random));
+			grid.Update(i, positions[i]);
+		}
+		// 半分を移動させ、一部を削除しておく
+		std::vector<bool> isRemoved(kRandomEntryNum, false);
+		for (int i = 0; i < kRandomEntryNum; i += 2) {
+			positions[i] = Position3(posDist(random), 0.0f, posDist(random));
+			grid.Update(i, positions[i]);
+		}
+		for (int i = 0; i < kRandomEntryNum; i += 7) {
+			grid.Remove(i);
+			isRemoved[i] = true;
+		}
+
+		int radiusMismatch = 0;
+		int coneMismatch = 0;
+		int nearestMismatch = 0;
+		std::vector<int> result;
+		std::vector<int> expected;
+		for (int q = 0; q < kRandomQueryNum; ++q) {
+			const Position3 center(posDist(random), 0.0f, posDist(random));
+			const float angle = angleDist(random);
+			const Vector3 dir(std::cos(angle), 0.0f, std::sin(angle));
+
+			// 半径
+			expected.clear();
+			for (int i = 0; i < kRandomEntryNum; ++i) {
+				if (!isRemoved[i] && DistSqXZ(positions[i], center) <= kQueryRadius * kQueryRadius) {
+					expected.emplace_back(i);
+				}
+			}
+			grid.QueryRadius(center, kQueryRadius, result);
+			if (!IsSameSet(result, expected)) ++radiusMismatch;
+
+			// 扇形
+			expected.clear();
+			for (int i = 0; i < kRandomEntryNum; ++i) {
+				if (!isRemoved[i] && IsInsideCone(center, dir, kConeHalfAngle, kQueryRadius, positions[i])) {
+					expected.emplace_back(i);
+				}
+			}
+			grid.QueryCone(center, dir, kConeHalfAngle, kQueryRadius, result);
+			if (!IsSameSet(result, expected)) ++coneMismatch;
+
+			// k近傍(距離の順に比べる)
+			expected.clear();
+			for (int i = 0; i < kRandomEntryNum; ++i) {
+				if (!isRemoved[i]) expected.emplace_back(i);
+			}
+			std::sort(expected.begin(), expected.end(), [&](int a, int b) {
+				return DistSqXZ(positions[a], center) < DistSqXZ(positions[b], center);
+				});
+			expected.resize(kNearestNum);
+			grid.QueryNearestK(center, kNearestNum, FLT_MAX, result);
+			if (result != expected) ++nearestMismatch;
+		}
+		Check(radiusMismatch == 0, "radius queries match a brute-force search");
+		Check(coneMismatch == 0, "cone queries match a brute-force search");
+		Check(nearestMismatch == 0, "nearest-k queries match a brute-force search in distance order");
+	}
+}
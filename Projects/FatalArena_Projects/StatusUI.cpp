@@ -5,6 +5,7 @@
 #include "EnemyBase.h"
 #include "GameManager.h"
 #include "Statistics.h"
+#include "FontManager.h"
 #include <DxLib.h>
 #include <string>
 
@@ -45,18 +46,34 @@ namespace {
 	constexpr int kScorePosY = kScoreFontSize * 0.75f;
 	const unsigned int kScoreColor = GetColor(255, 255, 255);
 	const std::wstring kScoreFontName = L"Impact"; // フォント名
+	const std::wstring kScoreLabel = L"Score : ";	// 数字の前に表示する文字列
+	constexpr int kScoreDigitNum = 7;		// 0埋めする桁数
+	constexpr int kScoreAlignDigitNum = 5;	// 右揃えの基準にする桁数
 }
 
 StatusUI::StatusUI():
-	_scoreFontHandle(-1)
+	_scoreFontHandle(-1),
+	_scoreAtlas(nullptr),
+	_scoreLabelLayout(),
+	_scoreNumWidth(0),
+	_batcher(),
+	_projector(),
+	_enemyBarX(),
+	_enemyBarY(),
+	_enemyBarZ(),
+	_enemyHp(),
+	_enemyMaxHp(),
+	_enemyScreenX(),
+	_enemyScreenY(),
+	_enemyBarVisible()
 {
 }
 
 StatusUI::~StatusUI()
 {
-	// フォントハンドルが有効なら削除
+	// フォントハンドルが有効なら返す
 	if (_scoreFontHandle != -1) {
-		DeleteFontToHandle(_scoreFontHandle);
+		FontManager::GetInstance().Release(_scoreFontHandle);
 	}
 }
 
@@ -66,11 +83,16 @@ void StatusUI::Init(std::weak_ptr<Player> player, std::weak_ptr<WaveManager> wav
 	_waveManager = waveManager;
 	_enemyManager = enemyManager;
 
-	_scoreFontHandle = CreateFontToHandle(
-		kScoreFontName.c_str(),
+	_scoreFontHandle = FontManager::GetInstance().Acquire(
+		kScoreFontName,
 		kScoreFontSize,
 		-1,
 		DX_FONTTYPE_ANTIALIASING_EDGE);
+
+	// 文字をまとめたアトラスを取得し、変わらない部分は先に計算しておく
+	_scoreAtlas = &FontManager::GetInstance().GetAtlas(_scoreFontHandle);
+	_scoreLabelLayout = _scoreAtlas->BuildLayout(kScoreLabel);
+	_scoreNumWidth = _scoreAtlas->MeasureNumber(0, kScoreAlignDigitNum);
 }
 
 void StatusUI::Update()
@@ -80,20 +102,12 @@ void StatusUI::Update()
 
 void StatusUI::Draw()
 {
-	// 敵HP描画
-	if (auto enemyManager = _enemyManager.lock()) {
-		const auto& enemies = enemyManager->GetEnemies();
-		for (const auto& enemy : enemies) {
-			if (enemy) {
-				DrawEnemyHp(enemy);
-			}
-		}
-	}
-
-	DrawScore();
-
+	// バーと文字はためておき、最後にまとめて描画する
+	DrawEnemyHp();
 	DrawPlayerHp();
 	DrawPlayerStamina();
+	DrawScore();
+	_batcher.Flush();
 }
 
 void StatusUI::DrawPlayerHp()
@@ -107,29 +121,29 @@ void StatusUI::DrawPlayerHp()
 		float hpRatio = playerHitPoint / maxHp;
 
 		// 背景バー
-		DrawBox(kPlayerHpBarPosX, kPlayerHpBarPosY,
+		_batcher.AddBox(kPlayerHpBarPosX, kPlayerHpBarPosY,
 			kPlayerHpBarPosX + kPlayerHpBarWidth, kPlayerHpBarPosY + kPlayerHpBarHeight,
-			kPlayerHpBarBackColor, true);
+			kPlayerHpBarBackColor);
 
 		// 前景バー
 		if (playerHitPoint > 0.0f) {
-			DrawBox(kPlayerHpBarPosX, kPlayerHpBarPosY,
+			_batcher.AddBox(kPlayerHpBarPosX, kPlayerHpBarPosY,
 				kPlayerHpBarPosX + static_cast<int>(kPlayerHpBarWidth * hpRatio),
 				kPlayerHpBarPosY + kPlayerHpBarHeight,
-				kPlayerHpBarFrontColor, true);
+				kPlayerHpBarFrontColor);
 		}
 		
 		// 100刻みで縦線を描画
 		for (int i = 100; i < maxHp; i += 100) {
 			int lineX = kPlayerHpBarPosX + static_cast<int>(kPlayerHpBarWidth * (i / maxHp));
-			DrawLine(lineX, kPlayerHpBarPosY, lineX, kPlayerHpBarPosY + kPlayerHpBarHeight,
+			_batcher.AddLine(lineX, kPlayerHpBarPosY, lineX, kPlayerHpBarPosY + kPlayerHpBarHeight,
 				kPlayerHpBarFrameColor);
 		}
 
 		// 枠線
-		DrawBox(kPlayerHpBarPosX, kPlayerHpBarPosY,
+		_batcher.AddBoxFrame(kPlayerHpBarPosX, kPlayerHpBarPosY,
 			kPlayerHpBarPosX + kPlayerHpBarWidth, kPlayerHpBarPosY + kPlayerHpBarHeight,
-			kPlayerHpBarFrameColor, false);
+			kPlayerHpBarFrameColor);
 	}
 }
 
@@ -143,81 +157,104 @@ void StatusUI::DrawPlayerStamina()
 			float ratio = stamina / maxStamina;
 
 			// 背景バー
-			DrawBox(kPlayerStaminaBarPosX, kPlayerStaminaBarPosY,
+			_batcher.AddBox(kPlayerStaminaBarPosX, kPlayerStaminaBarPosY,
 				kPlayerStaminaBarPosX + kPlayerStaminaBarWidth, kPlayerStaminaBarPosY + kPlayerStaminaBarHeight,
-				kPlayerStaminaBarBackColor, true);
+				kPlayerStaminaBarBackColor);
 
 			// 前景バー
 			if (stamina > 0.0f) {
-				DrawBox(kPlayerStaminaBarPosX, kPlayerStaminaBarPosY,
+				_batcher.AddBox(kPlayerStaminaBarPosX, kPlayerStaminaBarPosY,
 					kPlayerStaminaBarPosX + static_cast<int>(kPlayerStaminaBarWidth * ratio),
 					kPlayerStaminaBarPosY + kPlayerStaminaBarHeight,
-					kPlayerStaminaBarFrontColor, true);
+					kPlayerStaminaBarFrontColor);
 			}
 			
 			// 10刻みで縦線を描画
 			for (int i = 10; i < maxStamina; i += 10) {
 				int lineX = kPlayerStaminaBarPosX + static_cast<int>(kPlayerStaminaBarWidth * (i / maxStamina));
-				DrawLine(lineX, kPlayerStaminaBarPosY, lineX, kPlayerStaminaBarPosY + kPlayerStaminaBarHeight,
+				_batcher.AddLine(lineX, kPlayerStaminaBarPosY, lineX, kPlayerStaminaBarPosY + kPlayerStaminaBarHeight,
 					kPlayerStaminaBarFrameColor);
 			}
 
 			// 枠線
-			DrawBox(kPlayerStaminaBarPosX, kPlayerStaminaBarPosY,
+			_batcher.AddBoxFrame(kPlayerStaminaBarPosX, kPlayerStaminaBarPosY,
 				kPlayerStaminaBarPosX + kPlayerStaminaBarWidth, kPlayerStaminaBarPosY + kPlayerStaminaBarHeight,
-				kPlayerStaminaBarFrameColor, false);
+				kPlayerStaminaBarFrameColor);
 		}
 	}
 }
 
-void StatusUI::DrawEnemyHp(std::shared_ptr<EnemyBase> enemy)
+void StatusUI::DrawEnemyHp()
 {
-	// 敵のHPと最大HPを取得
-	float currentHp = enemy->GetHitPoint();
-	float maxHp = enemy->GetMaxHitPoint();
-	// HPが0以下、または最大HPが0以下の敵は描画しない
-	if (currentHp <= 0.0f || maxHp <= 0.0f) return;
-
-	// 敵の頭上座標を計算
-	Vector3 enemyPos = enemy->GetPos();
-	Vector3 barWorldPos = enemyPos + kEnemyBarOffset;
-
-	// 3D座標を2Dスクリーン座標に変換
-	Position3 screenPos = ConvWorldPosToScreenPos(barWorldPos);
+	auto enemyManager = _enemyManager.lock();
+	if (!enemyManager) return;
+
+	// 描画する敵の頭上座標とHPを集める
+	_enemyBarX.clear();
+	_enemyBarY.clear();
+	_enemyBarZ.clear();
+	_enemyHp.clear();
+	_enemyMaxHp.clear();
+	for (const auto& enemy : enemyManager->GetEnemies()) {
+		if (!enemy) continue;
+		// 敵のHPと最大HPを取得
+		const float currentHp = enemy->GetHitPoint();
+		const float maxHp = enemy->GetMaxHitPoint();
+		// HPが0以下、または最大HPが0以下の敵は描画しない
+		if (currentHp <= 0.0f || maxHp <= 0.0f) continue;
+
+		const Vector3 barWorldPos = enemy->GetPos() + kEnemyBarOffset;
+		_enemyBarX.emplace_back(barWorldPos.x);
+		_enemyBarY.emplace_back(barWorldPos.y);
+		_enemyBarZ.emplace_back(barWorldPos.z);
+		_enemyHp.emplace_back(currentHp);
+		_enemyMaxHp.emplace_back(maxHp);
+	}
 
-	// 画面外の場合は描画しない (Z座標が1.0fより大きいと画面奥)
-	if (screenPos.z > 1.0f) return;
+	// 3D座標をまとめて2Dスクリーン座標に変換
+	const int barNum = static_cast<int>(_enemyBarX.size());
+	_enemyScreenX.resize(barNum);
+	_enemyScreenY.resize(barNum);
+	_enemyBarVisible.resize(barNum);
+	_projector.Setup();
+	_projector.Project(_enemyBarX.data(), _enemyBarY.data(), _enemyBarZ.data(), barNum,
+		_enemyScreenX.data(), _enemyScreenY.data(), _enemyBarVisible.data());
 
+	for (int i = 0; i < barNum; ++i) {
+		// 画面外(カメラの後方や描画距離外)の場合は描画しない
+		if (!_enemyBarVisible[i]) continue;
 
-	// HPバーの中心がscreenPosに来るように、描画開始位置を計算
-	int barStartX = static_cast<int>(screenPos.x) - static_cast<int>(kEnemyHpBarWidth * 0.5f);
-	int barStartY = static_cast<int>(screenPos.y) - static_cast<int>(kEnemyHpBarHeight * 0.5f);
+		// HPバーの中心がスクリーン座標に来るように、描画開始位置を計算
+		const int barStartX = static_cast<int>(_enemyScreenX[i]) - static_cast<int>(kEnemyHpBarWidth * 0.5f);
+		const int barStartY = static_cast<int>(_enemyScreenY[i]) - static_cast<int>(kEnemyHpBarHeight * 0.5f);
 
-	// HPの割合を計算
-	float hpRatio = currentHp / maxHp;
+		// HPの割合を計算
+		const float maxHp = _enemyMaxHp[i];
+		const float hpRatio = _enemyHp[i] / maxHp;
 
-	// 背景バー
-	DrawBox(barStartX, barStartY,
-		barStartX + kEnemyHpBarWidth, barStartY + kEnemyHpBarHeight,
-		kEnemyHpBarBackColor, true);
+		// 背景バー
+		_batcher.AddBox(barStartX, barStartY,
+			barStartX + kEnemyHpBarWidth, barStartY + kEnemyHpBarHeight,
+			kEnemyHpBarBackColor);
 
-	// 前景バー
-	DrawBox(barStartX, barStartY,
-		barStartX + static_cast<int>(kEnemyHpBarWidth * hpRatio), barStartY + kEnemyHpBarHeight,
-		kEnemyHpBarFrontColor, true);
+		// 前景バー
+		_batcher.AddBox(barStartX, barStartY,
+			barStartX + static_cast<int>(kEnemyHpBarWidth * hpRatio), barStartY + kEnemyHpBarHeight,
+			kEnemyHpBarFrontColor);
+
+		// 50刻みで縦線を描画
+		for (int hp = 50; hp < maxHp; hp += 50) {
+			const int lineX = barStartX + static_cast<int>(kEnemyHpBarWidth * (hp / maxHp));
+			_batcher.AddLine(lineX, barStartY,
+				lineX, barStartY + kEnemyHpBarHeight,
+				kEnemyHpBarFrameColor);
+		}
 
-	// 50刻みで縦線を描画
-	for (int i = 50; i < maxHp; i += 50) {
-		int lineX = barStartX + static_cast<int>(kEnemyHpBarWidth * (i / maxHp));
-		DrawLine(lineX, barStartY,
-			lineX, barStartY + kEnemyHpBarHeight,
+		// 枠線
+		_batcher.AddBoxFrame(barStartX, barStartY,
+			barStartX + kEnemyHpBarWidth, barStartY + kEnemyHpBarHeight,
 			kEnemyHpBarFrameColor);
 	}
-
-	// 枠線
-	DrawBox(barStartX, barStartY,
-		barStartX + kEnemyHpBarWidth, barStartY + kEnemyHpBarHeight,
-		kEnemyHpBarFrameColor, false);
 }
 
 void StatusUI::DrawScore()
@@ -225,24 +262,17 @@ void StatusUI::DrawScore()
 	// GameManagerから敵撃破スコアを取得
 	int score = GameManager::GetInstance().GetEnemyDefeatScore();
 
-	// スコアの文字列を作成
-	std::wstring scoreText = L"Score : ";
-
 	// 描画するX座標を計算 (右揃え)
-	// まず"SCORE: "部分の幅を計算
-	int textWidth = GetDrawStringWidthToHandle(scoreText.c_str(), static_cast<int>(scoreText.length()),
-		_scoreFontHandle);
-	// 次に数字部分の幅を計算
-	int numWidth = GetDrawStringWidthToHandle(L"0000000", 5, _scoreFontHandle);
-
-	int totalWidth = textWidth + numWidth;
+	// 幅は初期化時に計算済み
+	int textWidth = _scoreLabelLayout.width;
+	int totalWidth = textWidth + _scoreNumWidth;
 	int drawX = kScorePosX - totalWidth;
 
 	// 文字を描画
-	DrawStringToHandle(drawX, kScorePosY, scoreText.c_str(), kScoreColor, _scoreFontHandle);
+	_scoreAtlas->DrawLayout(_batcher, _scoreLabelLayout,
+		static_cast<float>(drawX), static_cast<float>(kScorePosY), kScoreColor);
 
-	// スコアを0埋めで描画
-	DrawFormatStringToHandle(drawX + textWidth, 
-		kScorePosY, kScoreColor, _scoreFontHandle, 
-		L"%07d",score);
+	// スコアを0埋めで描画(文字列には変換しない)
+	_scoreAtlas->DrawNumber(_batcher, score, kScoreDigitNum,
+		static_cast<float>(drawX + textWidth), static_cast<float>(kScorePosY), kScoreColor);
 }
@@ -1,7 +1,12 @@
 ﻿#pragma once
 #include "Vector3.h"
+#include "UIBatcher.h"
+#include "ScreenProjector.h"
+#include "GlyphAtlas.h"
 #include <memory>
 #include <map>
+#include <vector>
+#include <cstdint>
 
 class Player;
 class WaveManager;
@@ -22,7 +27,11 @@ private:
 
 	void DrawPlayerHp();
 	void DrawPlayerStamina();
-	void DrawEnemyHp(std::shared_ptr<EnemyBase> enemy);
+	/// <summary>
+	/// 全ての敵のHPバーを描画する
+	/// (頭上の位置はまとめてスクリーン座標に変換する)
+	/// </summary>
+	void DrawEnemyHp();
 	void DrawScore();
 
 	std::weak_ptr<Player> _player;
@@ -30,5 +39,24 @@ private:
 	std::weak_ptr<EnemyManager> _enemyManager;
 
 	int _scoreFontHandle;
+	// スコアの文字(ラベルは内容が変わらないため配置を保持する)
+	const GlyphAtlas* _scoreAtlas;
+	TextLayout _scoreLabelLayout;
+	int _scoreNumWidth;	// 右揃えの基準にする数字部分の幅
+
+	// バーと文字をまとめて描画する
+	UIBatcher _batcher;
+	ScreenProjector _projector;
+
+	// 敵のHPバーの頭上の位置とHP(毎フレームの確保を避けるため保持する)
+	std::vector<float> _enemyBarX;
+	std::vector<float> _enemyBarY;
+	std::vector<float> _enemyBarZ;
+	std::vector<float> _enemyHp;
+	std::vector<float> _enemyMaxHp;
+	// 変換後のスクリーン座標
+	std::vector<float> _enemyScreenX;
+	std::vector<float> _enemyScreenY;
+	std::vector<uint8_t> _enemyBarVisible;
 };
 
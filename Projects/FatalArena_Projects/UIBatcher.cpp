@@ -0,0 +1,130 @@
+﻿#include "UIBatcher.h"
+#include <cmath>
+
+namespace {
+	// 四角形1つ分の頂点数(三角形2つ)
+	constexpr int kQuadVertexNum = 6;
+}
+
+UIBatcher::UIBatcher() :
+	_batches(),
+	_batchNum(0),
+	_drawCallCount(0)
+{
+}
+
+UIBatcher::~UIBatcher()
+{
+}
+
+void UIBatcher::AddBox(float x0, float y0, float x1, float y1, unsigned int color)
+{
+	const VECTOR pos[4] = {
+		VGet(x0, y0, 0.0f), VGet(x1, y0, 0.0f),
+		VGet(x0, y1, 0.0f), VGet(x1, y1, 0.0f),
+	};
+	AddQuad(FindBatch(DX_NONE_GRAPH), pos, 0.0f, 0.0f, 1.0f, 1.0f, ToColorU8(color));
+}
+
+void UIBatcher::AddBoxFrame(float x0, float y0, float x1, float y1, unsigned int color)
+{
+	// 上下左右の1ピクセル幅の矩形
+	AddBox(x0, y0, x1, y0 + 1.0f, color);
+	AddBox(x0, y1 - 1.0f, x1, y1, color);
+	AddBox(x0, y0 + 1.0f, x0 + 1.0f, y1 - 1.0f, color);
+	AddBox(x1 - 1.0f, y0 + 1.0f, x1, y1 - 1.0f, color);
+}
+
+void UIBatcher::AddLine(float x0, float y0, float x1, float y1, unsigned int color, float thickness)
+{
+	// 縦横の線はDrawLineと同じく始点のピクセルから塗る
+	if (x0 == x1) {
+		AddBox(x0, std::fmin(y0, y1), x0 + thickness, std::fmax(y0, y1), color);
+		return;
+	}
+	if (y0 == y1) {
+		AddBox(std::fmin(x0, x1), y0, std::fmax(x0, x1), y0 + thickness, color);
+		return;
+	}
+
+	// 斜めの線は線に垂直な方向へ幅を持たせる
+	const float dx = x1 - x0;
+	const float dy = y1 - y0;
+	const float len = std::sqrt(dx * dx + dy * dy);
+	const float nx = -dy / len * thickness * 0.5f;
+	const float ny = dx / len * thickness * 0.5f;
+	const VECTOR pos[4] = {
+		VGet(x0 + nx, y0 + ny, 0.0f), VGet(x1 + nx, y1 + ny, 0.0f),
+		VGet(x0 - nx, y0 - ny, 0.0f), VGet(x1 - nx, y1 - ny, 0.0f),
+	};
+	AddQuad(FindBatch(DX_NONE_GRAPH), pos, 0.0f, 0.0f, 1.0f, 1.0f, ToColorU8(color));
+}
+
+void UIBatcher::AddSprite(int graphHandle, float x0, float y0, float x1, float y1,
+	float u0, float v0, float u1, float v1, unsigned int color)
+{
+	const VECTOR pos[4] = {
+		VGet(x0, y0, 0.0f), VGet(x1, y0, 0.0f),
+		VGet(x0, y1, 0.0f), VGet(x1, y1, 0.0f),
+	};
+	AddQuad(FindBatch(graphHandle), pos, u0, v0, u1, v1, ToColorU8(color));
+}
+
+void UIBatcher::Flush()
+{
+	_drawCallCount = 0;
+	for (int i = 0; i < _batchNum; ++i) {
+		Batch& batch = _batches[i];
+		if (batch.vertices.empty()) continue;
+
+		DrawPrimitive2D(batch.vertices.data(), static_cast<int>(batch.vertices.size()),
+			DX_PRIMTYPE_TRIANGLELIST, batch.graphHandle, true);
+		++_drawCallCount;
+		batch.vertices.clear();
+	}
+	_batchNum = 0;
+}
+
+UIBatcher::Batch& UIBatcher::FindBatch(int graphHandle)
+{
+	// 使用する画像は数種類のため順に探す
+	for (int i = 0; i < _batchNum; ++i) {
+		if (_batches[i].graphHandle == graphHandle) return _batches[i];
+	}
+	if (_batchNum == static_cast<int>(_batches.size())) {
+		_batches.emplace_back();
+	}
+	Batch& batch = _batches[_batchNum++];
+	batch.graphHandle = graphHandle;
+	batch.vertices.clear();
+	return batch;
+}
+
+void UIBatcher::AddQuad(Batch& batch, const VECTOR pos[4],
+	float u0, float v0, float u1, float v1, const COLOR_U8& color)
+{
+	VERTEX2D vertex[4];
+	const float u[4] = { u0, u1, u0, u1 };
+	const float v[4] = { v0, v0, v1, v1 };
+	for (int i = 0; i < 4; ++i) {
+		vertex[i].pos = pos[i];
+		vertex[i].rhw = 1.0f;
+		vertex[i].dif = color;
+		vertex[i].u = u[i];
+		vertex[i].v = v[i];
+	}
+	// 左上、右上、左下 / 左下、右上、右下
+	const int order[kQuadVertexNum] = { 0, 1, 2, 2, 1, 3 };
+	for (int index : order) {
+		batch.vertices.emplace_back(vertex[index]);
+	}
+}
+
+COLOR_U8 UIBatcher::ToColorU8(unsigned int color)
+{
+	int r = 0;
+	int g = 0;
+	int b = 0;
+	GetColor2(color, &r, &g, &b);
+	return GetColorU8(r, g, b, 255);
+}
@@ -0,0 +1,81 @@
+﻿#pragma once
+#include <DxLib.h>
+#include <vector>
+
+/// <summary>
+/// 2Dの矩形、線、画像をためておき、画像ごとに1回の描画でまとめて描画する
+/// 同じ画像(塗りつぶしを含む)の中では追加した順に重なり、
+/// 異なる画像同士は最初に追加された順に描画する
+/// </summary>
+class UIBatcher final
+{
+public:
+	UIBatcher();
+	~UIBatcher();
+
+	/// <summary>
+	/// 塗りつぶした矩形を追加する(DrawBoxと同じく右下の端は含まない)
+	/// </summary>
+	void AddBox(float x0, float y0, float x1, float y1, unsigned int color);
+
+	/// <summary>
+	/// 矩形の枠線を追加する(DrawBoxの塗りつぶしなしと同じ範囲)
+	/// </summary>
+	void AddBoxFrame(float x0, float y0, float x1, float y1, unsigned int color);
+
+	/// <summary>
+	/// 線を追加する
+	/// </summary>
+	void AddLine(float x0, float y0, float x1, float y1, unsigned int color, float thickness = 1.0f);
+
+	/// <summary>
+	/// 画像を追加する
+	/// </summary>
+	/// <param name="u0">画像内の左上(0.0-1.0)</param>
+	/// <param name="u1">画像内の右下(0.0-1.0)</param>
+	void AddSprite(int graphHandle, float x0, float y0, float x1, float y1,
+		float u0 = 0.0f, float v0 = 0.0f, float u1 = 1.0f, float v1 = 1.0f,
+		unsigned int color = 0xffffff);
+
+	/// <summary>
+	/// ためているものを描画して空にする
+	/// </summary>
+	void Flush();
+
+	/// <summary>
+	/// 直近のFlushでの描画呼び出し回数
+	/// </summary>
+	int GetDrawCallCount() const { return _drawCallCount; }
+
+private:
+	// 同じ画像でまとめる頂点
+	struct Batch
+	{
+		int graphHandle = DX_NONE_GRAPH;
+		std::vector<VERTEX2D> vertices;
+	};
+
+	/// <summary>
+	/// 画像に対応するまとまりを返す(なければ追加する)
+	/// </summary>
+	Batch& FindBatch(int graphHandle);
+
+	/// <summary>
+	/// 4頂点の四角形を三角形2つとして追加する
+	/// </summary>
+	/// <param name="pos">左上、右上、左下、右下の順</param>
+	void AddQuad(Batch& batch, const VECTOR pos[4],
+		float u0, float v0, float u1, float v1, const COLOR_U8& color);
+
+	/// <summary>
+	/// GetColorで作成した色を頂点の色に変換する
+	/// </summary>
+	static COLOR_U8 ToColorU8(unsigned int color);
+
+	// 使い回すため、Flush後も要素は残しておく
+	std::vector<Batch> _batches;
+	// 現在使用しているまとまりの数
+	int _batchNum;
+
+	int _drawCallCount;
+};
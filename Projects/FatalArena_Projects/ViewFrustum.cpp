@@ -0,0 +1,110 @@
+﻿#include "ViewFrustum.h"
+#include <cassert>
+#include <cmath>
+#include <emmintrin.h>
+
+namespace {
+	// 同時に判定する数(SSEのレーン数)
+	constexpr int kLaneNum = 4;
+}
+
+ViewFrustum::ViewFrustum() :
+	_normalX(),
+	_normalY(),
+	_normalZ(),
+	_dist()
+{
+}
+
+ViewFrustum::~ViewFrustum()
+{
+}
+
+void ViewFrustum::Setup(const Position3& eye, const Position3& target,
+	float fovY, float aspect, float nearZ, float farZ)
+{
+	assert(nearZ < farZ && "クリップ距離が正しくない");
+
+	// カメラの基底(DxLibに合わせて左手系)
+	Vector3 forward = target - eye;
+	if (forward.SqrMagnitude() <= 0.0f) forward = Vector3(0.0f, 0.0f, 1.0f);
+	forward.Normalized();
+	Vector3 up = Vector3(0.0f, 1.0f, 0.0f);
+	Vector3 right = Cross(up, forward);
+	// 真上や真下を向いている場合
+	if (right.SqrMagnitude() <= 0.0f) right = Vector3(1.0f, 0.0f, 0.0f);
+	right.Normalized();
+	up = Cross(forward, right);
+
+	const float tanY = std::tan(fovY * 0.5f);
+	const float tanX = tanY * aspect;
+
+	SetPlane(0, forward, eye + forward * nearZ);		// 手前
+	SetPlane(1, forward * -1.0f, eye + forward * farZ);	// 奥
+	SetPlane(2, forward * tanX + right, eye);			// 左
+	SetPlane(3, forward * tanX - right, eye);			// 右
+	SetPlane(4, forward * tanY + up, eye);				// 下
+	SetPlane(5, forward * tanY - up, eye);				// 上
+}
+
+void ViewFrustum::SetPlane(int index, const Vector3& normal, const Position3& point)
+{
+	const Vector3 n = normal.Normalize();
+	_normalX[index] = n.x;
+	_normalY[index] = n.y;
+	_normalZ[index] = n.z;
+	_dist[index] = -Dot(n, point);
+}
+
+bool ViewFrustum::IsVisible(const BoundingSphere& sphere) const
+{
+	for (int i = 0; i < kPlaneNum; ++i) {
+		const float d = _normalX[i] * sphere.center.x + _normalY[i] * sphere.center.y +
+			_normalZ[i] * sphere.center.z + _dist[i];
+		if (d < -sphere.radius) return false;
+	}
+	return true;
+}
+
+int ViewFrustum::CullSpheres(const float* x, const float* y, const float* z, const float* radius,
+	int count, uint8_t* outVisible) const
+{
+	int visibleNum = 0;
+
+	// 4つずつまとめて全ての平面と比較する
+	int i = 0;
+	for (; i + kLaneNum <= count; i += kLaneNum) {
+		const __m128 px = _mm_loadu_ps(x + i);
+		const __m128 py = _mm_loadu_ps(y + i);
+		const __m128 pz = _mm_loadu_ps(z + i);
+		const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (int p = 0; p < kPlaneNum; ++p) {
+			__m128 d = _mm_mul_ps(px, _mm_set1_ps(_normalX[p]));
+			d = _mm_add_ps(d, _mm_mul_ps(py, _mm_set1_ps(_normalY[p])));
+			d = _mm_add_ps(d, _mm_mul_ps(pz, _mm_set1_ps(_normalZ[p])));
+			d = _mm_add_ps(d, _mm_set1_ps(_dist[p]));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negRadius));
+		}
+
+		const int mask = _mm_movemask_ps(inside);
+		for (int lane = 0; lane < kLaneNum; ++lane) {
+			const uint8_t isVisible = static_cast<uint8_t>((mask >> lane) & 1);
+			outVisible[i + lane] = isVisible;
+			visibleNum += isVisible;
+		}
+	}
+
+	// 端数は1つずつ判定する
+	for (; i < count; ++i) {
+		BoundingSphere sphere;
+		sphere.center = Vector3(x[i], y[i], z[i]);
+		sphere.radius = radius[i];
+		const bool isVisible = IsVisible(sphere);
+		outVisible[i] = static_cast<uint8_t>(isVisible);
+		visibleNum += isVisible;
+	}
+
+	return visibleNum;
+}
@@ -0,0 +1,64 @@
+﻿#pragma once
+#include "Vector3.h"
+#include <array>
+#include <cstdint>
+
+/// <summary>
+/// 境界球
+/// </summary>
+struct BoundingSphere
+{
+	Position3 center;
+	float radius = 0.0f;
+};
+
+/// <summary>
+/// カメラの視錐台
+/// 境界球が視界内にあるかをSIMDで4つずつまとめて判定する
+/// </summary>
+class ViewFrustum final
+{
+public:
+	ViewFrustum();
+	~ViewFrustum();
+
+	/// <summary>
+	/// カメラの設定から視錐台を作る
+	/// </summary>
+	/// <param name="eye">カメラの位置</param>
+	/// <param name="target">注視点</param>
+	/// <param name="fovY">縦方向の視野角(ラジアン)</param>
+	/// <param name="aspect">画面の縦横比(幅/高さ)</param>
+	/// <param name="nearZ">手前のクリップ距離</param>
+	/// <param name="farZ">奥のクリップ距離</param>
+	void Setup(const Position3& eye, const Position3& target,
+		float fovY, float aspect, float nearZ, float farZ);
+
+	/// <summary>
+	/// 境界球が視錐台と重なっているか
+	/// </summary>
+	bool IsVisible(const BoundingSphere& sphere) const;
+
+	/// <summary>
+	/// 境界球をまとめて判定する
+	/// (各要素は別々の配列で渡す)
+	/// </summary>
+	/// <param name="outVisible">結果(視界内なら1)</param>
+	/// <returns>視界内にある数</returns>
+	int CullSpheres(const float* x, const float* y, const float* z, const float* radius,
+		int count, uint8_t* outVisible) const;
+
+private:
+	static constexpr int kPlaneNum = 6;
+
+	/// <summary>
+	/// 平面を設定する(法線は内側を向ける)
+	/// </summary>
+	void SetPlane(int index, const Vector3& normal, const Position3& point);
+
+	// 各平面の法線と距離(n・p + d >= 0 なら内側)
+	std::array<float, kPlaneNum> _normalX;
+	std::array<float, kPlaneNum> _normalY;
+	std::array<float, kPlaneNum> _normalZ;
+	std::array<float, kPlaneNum> _dist;
+};
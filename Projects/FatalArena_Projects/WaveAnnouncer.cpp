@@ -2,6 +2,7 @@
 #include "Statistics.h"
 #include "StringUtility.h"
 #include "SoundManager.h"
+#include "FontManager.h"
 #include <DxLib.h>
 #include <string>
 
@@ -15,6 +16,8 @@ namespace
     const unsigned int kFontColor = 0xffffff;   // 文字色
     //const std::wstring kFontName = L"Baskerville Old Face";   // フォント名
     const std::wstring kFontName = Statistics::kDefaultFontName;   // フォント名
+    const std::wstring kWaveLabel = L"Wave  ";      // 現在のウェーブ数の前に表示する文字列
+    const std::wstring kSeparator = L" / ";         // 現在と最大のウェーブ数の間に表示する文字列
 }
 
 WaveAnnouncer::WaveAnnouncer() :
@@ -22,19 +25,34 @@ WaveAnnouncer::WaveAnnouncer() :
     _displayTimer(0),
     _currentWave(0),
     _maxWave(0),
-    _fontHandle(-1)
+    _fontHandle(-1),
+    _atlas(nullptr),
+    _waveLabelLayout(),
+    _separatorLayout(),
+    _batcher(),
+    _handle()
 {
-    // フォントの作成
-    _fontHandle = CreateFontToHandle(
-        kFontName.c_str(), kFontSize, 3, DX_FONTTYPE_ANTIALIASING_EDGE);
+    // 他のオブジェクトから参照できるよう登録する
+    _handle = SlotMap<WaveAnnouncer>::GetInstance().Insert(this);
+
+    // フォントの取得
+    _fontHandle = FontManager::GetInstance().Acquire(
+        kFontName, kFontSize, 3, DX_FONTTYPE_ANTIALIASING_EDGE);
+
+    // 文字をまとめたアトラスを取得し、変わらない部分は先に計算しておく
+    _atlas = &FontManager::GetInstance().GetAtlas(_fontHandle);
+    _waveLabelLayout = _atlas->BuildLayout(kWaveLabel);
+    _separatorLayout = _atlas->BuildLayout(kSeparator);
 }
 
 WaveAnnouncer::~WaveAnnouncer()
 {
-    // フォントの削除
+    SlotMap<WaveAnnouncer>::GetInstance().Remove(_handle);
+
+    // フォントを返す
     if (_fontHandle != -1)
     {
-        DeleteFontToHandle(_fontHandle);
+        FontManager::GetInstance().Release(_fontHandle);
     }
 }
 
@@ -78,15 +96,21 @@ void WaveAnnouncer::Draw()
     SetDrawBlendMode(DX_BLENDMODE_ALPHA, alpha);
 
     // 描画処理
-    int textWidth = GetDrawFormatStringWidthToHandle(
-        _fontHandle, L"Wave  %d / %d", _currentWave, _maxWave);
-    int drawX = (Statistics::kScreenWidth - textWidth) / 2;
-    int drawY = Statistics::kScreenHeight / 3;
-
-    DrawFormatStringToHandle(
-        drawX, drawY, 
-        kFontColor, _fontHandle, 
-        L"Wave  %d / %d", _currentWave, _maxWave);
+    // "Wave  %d / %d"を書式化せずに組み立てる
+    int textWidth = _waveLabelLayout.width + _separatorLayout.width +
+        _atlas->MeasureNumber(_currentWave, 1) + _atlas->MeasureNumber(_maxWave, 1);
+    float drawX = static_cast<float>((Statistics::kScreenWidth - textWidth) / 2);
+    float drawY = static_cast<float>(Statistics::kScreenHeight / 3);
+
+    _atlas->DrawLayout(_batcher, _waveLabelLayout, drawX, drawY, kFontColor);
+    drawX += _waveLabelLayout.width;
+    drawX += _atlas->DrawNumber(_batcher, _currentWave, 1, drawX, drawY, kFontColor);
+    _atlas->DrawLayout(_batcher, _separatorLayout, drawX, drawY, kFontColor);
+    drawX += _separatorLayout.width;
+    _atlas->DrawNumber(_batcher, _maxWave, 1, drawX, drawY, kFontColor);
+
+    // 設定中のブレンドモードでまとめて描画する
+    _batcher.Flush();
 
     // 描画ブレンドモードを元に戻す
     SetDrawBlendMode(DX_BLENDMODE_NOBLEND, 0);
@@ -1,4 +1,8 @@
 ﻿#pragma once
+#include "Handle.h"
+#include "GlyphAtlas.h"
+#include "UIBatcher.h"
+
 class WaveManager;
 
 /// <summary>
@@ -19,6 +23,11 @@ public:
 	// 表示が完了したか
 	bool IsFinished() const;
 
+	/// <summary>
+	/// 自身を参照するためのHandleを返す
+	/// </summary>
+	Handle<WaveAnnouncer> GetHandle() const { return _handle; }
+
 private:
 	bool _isDisplaying; // 表示中かどうかのフラグ
 	int _displayTimer;  // 表示時間を管理するタイマー
@@ -26,4 +35,11 @@ private:
 	int _maxWave;		// 最大ウェーブ数
 
 	int _fontHandle;    // 表示に使用するフォントハンドル
+	const GlyphAtlas* _atlas;   // フォントの文字をまとめた画像
+	TextLayout _waveLabelLayout;    // "Wave  "の配置
+	TextLayout _separatorLayout;    // " / "の配置
+	UIBatcher _batcher;
+
+	// 自身を参照するためのHandle
+	Handle<WaveAnnouncer> _handle;
 };
@@ -7,6 +7,8 @@
 #include "WaveAnnouncer.h"
 #include "Calculation.h"
 #include "SoundManager.h"
+#include "Random.h"
+#include "SnapshotArchive.h"
 
 #include <DxLib.h>
 #include <cassert>
@@ -40,9 +42,11 @@ void WaveManager::Init(std::weak_ptr<EnemyManager> enemyManager,
 	std::weak_ptr<ItemManager> itemManager, 
 	std::weak_ptr<WaveAnnouncer> waveAnnouncer)
 {
-	_enemyManager = enemyManager;
-	_itemManager = itemManager;
-	_waveAnnouncer = waveAnnouncer;
+	assert(!enemyManager.expired() && !itemManager.expired() && !waveAnnouncer.expired() &&
+		"参照するオブジェクトが存在しない");
+	_enemyManager = enemyManager.lock()->GetHandle();
+	_itemManager = itemManager.lock()->GetHandle();
+	_waveAnnouncer = waveAnnouncer.lock()->GetHandle();
 
 	InitWaveSettings();
 }
@@ -51,7 +55,7 @@ void WaveManager::Update()
 {
 	switch (_state) {
 	case State::Announcing:
-		if (_waveAnnouncer.lock()->IsFinished()) {
+		if (_waveAnnouncer->IsFinished()) {
 			_state = State::Spawning;
 			SoundManager::GetInstance().PlaySoundType(SEType::SpawnEnemy);
 		}
@@ -59,10 +63,11 @@ void WaveManager::Update()
 	case State::Spawning:
 	{
 		const auto& spawnInfo = _waveSettings[_currentWaveIndex].spawnGroups;
-		_enemyManager.lock()->SpawnEnemies(spawnInfo);
+		_enemyManager->SpawnEnemies(spawnInfo);
+		RandomStream& random = RandomService::GetInstance().GetStream(RandomStreamType::ItemSpawn);
 		for (int i = 0; i < 2; ++i) {
-			BuffType spawnType = static_cast<BuffType>(GetRand(static_cast<int>(BuffType::TypeNum)-1));
-			_itemManager.lock()->SpawnItem(spawnType);
+			BuffType spawnType = static_cast<BuffType>(random.GetInt(static_cast<int>(BuffType::TypeNum)-1));
+			_itemManager->SpawnItem(spawnType);
 		}
 		_state = State::InProgress;
 	}
@@ -87,12 +92,12 @@ void WaveManager::Update()
 
 void WaveManager::StartAnnounce()
 {
-	_waveAnnouncer.lock()->Start(_currentWaveIndex + 1, kTotalWaves);
+	_waveAnnouncer->Start(_currentWaveIndex + 1, kTotalWaves);
 }
 
 void WaveManager::CheckWaveCompletion()
 {
-	if (_enemyManager.lock()->AreAllEnemiesDefeated()) {
+	if (_enemyManager->AreAllEnemiesDefeated()) {
 		//_state = State::WaitingForCleanup;
 		// 最後のウェーブかどうかで分岐
 		if (_currentWaveIndex < GetTotalWaveCount() - 1) {
@@ -109,7 +114,7 @@ void WaveManager::TransitionToNextWave()
 {
 	_currentWaveIndex++;
 	if (_currentWaveIndex < GetTotalWaveCount()) {
-		_waveAnnouncer.lock()->Start(_currentWaveIndex + 1, kTotalWaves);
+		_waveAnnouncer->Start(_currentWaveIndex + 1, kTotalWaves);
 		_state = State::Announcing;
 	}
 	else {
@@ -122,6 +127,25 @@ void WaveManager::StartCleanup()
 	_state = State::WaitingForCleanup;
 }
 
+void WaveManager::SaveSnapshot(SnapshotWriter& writer) const
+{
+	writer.Write(_state);
+	writer.Write(_currentWaveIndex);
+	writer.Write(_waveTransitionFrameCount);
+}
+
+void WaveManager::LoadSnapshot(SnapshotReader& reader)
+{
+	reader.Read(_state);
+	reader.Read(_currentWaveIndex);
+	reader.Read(_waveTransitionFrameCount);
+
+	// 告知中に戻した場合は告知をやり直す
+	if (_state == State::Announcing) {
+		StartAnnounce();
+	}
+}
+
 void WaveManager::InitWaveSettings()
 {
 	// 最初のウェーブで出現する敵の数
@@ -2,10 +2,13 @@
 #include "WaveData.h"
 #include <vector>
 #include <memory>
+#include "Handle.h"
 
 class EnemyManager;
 class ItemManager;
 class WaveAnnouncer;
+class SnapshotWriter;
+class SnapshotReader;
 
 class WaveManager {
 private:
@@ -33,12 +36,19 @@ public:
 	int GetCurrentWaveIndex() const { return _currentWaveIndex; }
 	int GetTotalWaveCount() const { return static_cast<int>(_waveSettings.size()); }
 	bool CanReinforcement() const { return (_state == State::ReinforcementSelect); }
+	bool IsWaveInProgress() const { return (_state == State::InProgress); }
 
 	/// <summary>
 	/// 強化が終わったら呼ばれる
 	/// </summary>
 	void StartCleanup();
 
+	/// <summary>
+	/// ウェーブの進行状態を書き込む・読み込む
+	/// </summary>
+	void SaveSnapshot(SnapshotWriter& writer) const;
+	void LoadSnapshot(SnapshotReader& reader);
+
 private:
 	void InitWaveSettings();
 	void CheckWaveCompletion();
@@ -51,7 +61,7 @@ private:
 	std::vector<WaveData> _waveSettings;
 
 	
-	std::weak_ptr<EnemyManager> _enemyManager;
-	std::weak_ptr<ItemManager> _itemManager;
-	std::weak_ptr<WaveAnnouncer> _waveAnnouncer;
+	Handle<EnemyManager> _enemyManager;
+	Handle<ItemManager> _itemManager;
+	Handle<WaveAnnouncer> _waveAnnouncer;
 };
\ No newline at end of file
@@ -38,6 +38,8 @@ public:
 	/// </summary>
 	void Draw();
 
+	int GetModelHandle() const { return _modelHandle; }
+
 	/// <summary>
 	/// 武器の所有者と攻撃力を設定する
 	/// </summary>
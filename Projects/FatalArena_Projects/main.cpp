@@ -8,6 +8,11 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 {
 	Application& app = Application::GetInstance();
 
+	// -selftestが指定された場合は、ウィンドウを作らずに確認と計測だけを行う
+	if (app.IsSelfTestMode()) {
+		return app.RunSelfTest();
+	}
+
 	// アプリケーションの初期化
 	if (!app.Init())
 	{
@@ -20,5 +25,5 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 	// 後処理
 	app.Terminate();
 
-	return 0;
+	return app.GetExitCode();
 }
\ No newline at end of file